@@ -0,0 +1,104 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Bench {
+
+// Hardware cache-miss counter for the calling thread. Not available outside Linux or when
+// perf_event_paranoid forbids it; IsAvailable() tells which one it is.
+class CacheMissCounter {
+public:
+    CacheMissCounter() {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMissCounter() {
+#ifdef __linux__
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+#endif
+    }
+
+    CacheMissCounter(const CacheMissCounter& other) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter& other) = delete;
+
+    bool IsAvailable() const noexcept {
+        return fd_ >= 0;
+    }
+
+    void Start() noexcept {
+#ifdef __linux__
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    std::uint64_t Stop() noexcept {
+        std::uint64_t value = 0;
+#ifdef __linux__
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd_, &value, sizeof(value)) != sizeof(value)) {
+                value = 0;
+            }
+        }
+#endif
+        return value;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+// Evicts the benchmark data from the CPU caches between rounds.
+inline void FlushCaches() {
+    static std::vector<char> buffer(64 * 1024 * 1024);
+    volatile char sink = 0;
+    for (std::size_t i = 0; i < buffer.size(); i += 64) {
+        buffer[i] = static_cast<char>(i);
+        sink = sink + buffer[i];
+    }
+}
+
+template <typename F>
+double MeasureNs(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto finish = std::chrono::steady_clock::now();
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count());
+}
+
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+}
@@ -0,0 +1,103 @@
+#include "BenchUtils.h"
+#include "MetricsManager/MetricsArena.h"
+#include "IMetrics/CodeTimeMetric.h"
+#include "IMetrics/HTTPIncomeMetric.h"
+#include "IMetrics/IncrementMetric.h"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Compares a full registry walk over heap-scattered metrics with the same walk over
+// metrics constructed in a MetricsArena (with and without huge pages).
+
+namespace {
+
+constexpr int kRounds = 10;
+
+template <typename Make>
+void Populate(std::size_t count, std::vector<Metrics::IMetric*>& metrics, Make&& make) {
+    metrics.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        switch (i % 3) {
+            case 0: metrics.push_back(make(static_cast<Metrics::IncrementMetric*>(nullptr))); break;
+            case 1: metrics.push_back(make(static_cast<Metrics::HTTPIncomeMetric*>(nullptr))); break;
+            case 2: metrics.push_back(make(static_cast<Metrics::CodeTimeMetric*>(nullptr))); break;
+        }
+    }
+}
+
+void Walk(const std::vector<Metrics::IMetric*>& metrics) {
+    for (Metrics::IMetric* metric : metrics) {
+        metric->Evaluate();
+        metric->Reset();
+    }
+}
+
+void Report(const std::string& label, const std::vector<Metrics::IMetric*>& metrics) {
+    Bench::CacheMissCounter misses;
+    double total_ns = 0;
+    std::uint64_t total_misses = 0;
+
+    for (int round = 0; round < kRounds; ++round) {
+        Bench::FlushCaches();
+        misses.Start();
+        total_ns += Bench::MeasureNs([&] { Walk(metrics); });
+        total_misses += misses.Stop();
+    }
+
+    double per_metric = total_ns / kRounds / metrics.size();
+    std::cout << std::left << std::setw(24) << label
+              << std::right << std::setw(10) << std::fixed << std::setprecision(2) << per_metric << " ns/metric";
+    if (misses.IsAvailable()) {
+        std::cout << std::setw(12) << static_cast<double>(total_misses) / kRounds / metrics.size() << " misses/metric";
+    } else {
+        std::cout << "    (cache-miss counter unavailable)";
+    }
+    std::cout << '\n';
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100'000;
+    std::cout << "Full scrape walk over " << count << " metrics, " << kRounds << " rounds\n";
+
+    // Heap: every metric is a separate allocation, interleaved with unrelated allocations the
+    // way a long-running process registers metrics between other work.
+    {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<std::size_t> noise_size(32, 512);
+        std::vector<std::unique_ptr<char[]>> noise;
+        std::vector<std::unique_ptr<Metrics::IMetric>> owners;
+        std::vector<Metrics::IMetric*> metrics;
+
+        Populate(count, metrics, [&](auto* tag) -> Metrics::IMetric* {
+            using T = std::remove_pointer_t<decltype(tag)>;
+            noise.push_back(std::make_unique<char[]>(noise_size(rng)));
+            owners.push_back(std::make_unique<T>());
+            return owners.back().get();
+        });
+        Report("heap (make_unique)", metrics);
+    }
+
+    for (bool huge_pages : {false, true}) {
+        MetricsMemory::MetricsArena arena({.use_huge_pages = huge_pages});
+        std::vector<MetricsMemory::MetricPtr> owners;
+        std::vector<Metrics::IMetric*> metrics;
+
+        Populate(count, metrics, [&](auto* tag) -> Metrics::IMetric* {
+            using T = std::remove_pointer_t<decltype(tag)>;
+            auto [metric, owner] = arena.Create<T>();
+            owners.push_back(std::move(owner));
+            return metric;
+        });
+        Report(huge_pages ? "arena (huge pages)" : "arena", metrics);
+    }
+
+    return 0;
+}
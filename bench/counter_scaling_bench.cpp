@@ -0,0 +1,62 @@
+#include "BenchUtils.h"
+#include "IMetrics/IncrementMetric.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Cost of one increment of a shared counter as the number of incrementing threads grows:
+// IncrementMetric (one atomic) against StripedIncrementMetric (one cache line per CPU) and
+// PerThreadIncrementMetric (per-thread counts summed by the scrape).
+// With enough cores the first grows with the thread count, the others stay nearly flat.
+
+namespace {
+
+template <typename Metric>
+double NsPerIncrement(std::size_t threads, std::size_t increments) {
+    Metric metric("Counter");
+    double ns = Bench::MeasureNs([&] {
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&metric, increments] {
+                for (std::size_t i = 0; i < increments; ++i) {
+                    ++metric;
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    });
+    Bench::DoNotOptimize(metric);
+    // Wall time per increment of one thread: flat means threads don't slow each other down.
+    return ns / increments;
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::size_t increments = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2'000'000;
+    std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << increments << " increments per thread, " << cores << " hardware threads\n";
+    std::cout << std::left << std::setw(10) << "threads" << std::right << std::setw(16) << "atomic ns"
+              << std::setw(16) << "striped ns" << std::setw(16) << "per-thread ns" << '\n';
+
+    std::vector<std::size_t> counts;
+    for (std::size_t threads = 1; threads < cores; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(cores);
+
+    for (std::size_t threads : counts) {
+        std::cout << std::left << std::setw(10) << threads << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(16) << NsPerIncrement<Metrics::IncrementMetric>(threads, increments)
+                  << std::setw(16) << NsPerIncrement<Metrics::StripedIncrementMetric>(threads, increments)
+                  << std::setw(16) << NsPerIncrement<Metrics::PerThreadIncrementMetric>(threads, increments) << '\n';
+    }
+    return 0;
+}
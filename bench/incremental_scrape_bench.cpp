@@ -0,0 +1,66 @@
+#include "BenchUtils.h"
+#include "MetricsManager/MetricsManager.h"
+#include "IMetrics/IncrementMetric.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Longest single call and total time per period: one Log() over the whole registry versus
+// LogChunk() spreading the same period over a number of ticks.
+
+namespace {
+
+void Report(const std::string& label, double max_ns, double total_ns) {
+    std::cout << std::left << std::setw(28) << label << std::right
+              << std::fixed << std::setprecision(2)
+              << std::setw(10) << max_ns / 1e6 << " ms max call"
+              << std::setw(10) << total_ns / 1e6 << " ms per period\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+    int periods = 5;
+    std::string log = (std::filesystem::temp_directory_path() / "incremental_scrape_bench.log").string();
+
+    std::cout << count << " metrics, " << periods << " periods\n";
+    {
+        MetricsManager<> manager(log);
+        for (std::size_t i = 0; i < count; ++i) {
+            manager.CreateMetric<Metrics::IncrementMetric>("Counter" + std::to_string(i), i);
+        }
+
+        double max_ns = 0;
+        double total_ns = 0;
+        for (int period = 0; period < periods; ++period) {
+            double ns = Bench::MeasureNs([&] { manager.Log(); });
+            max_ns = std::max(max_ns, ns);
+            total_ns += ns;
+        }
+        Report("Log()", max_ns, total_ns / periods);
+
+        for (int ticks : {10, 100, 1000}) {
+            std::size_t budget = manager.ChunkBudget(std::chrono::seconds(1), std::chrono::milliseconds(1000) / ticks);
+            max_ns = 0;
+            total_ns = 0;
+            for (int period = 0; period < periods; ++period) {
+                bool finished = false;
+                while (!finished) {
+                    double ns = Bench::MeasureNs([&] { finished = manager.LogChunk(budget); });
+                    max_ns = std::max(max_ns, ns);
+                    total_ns += ns;
+                }
+            }
+            Report("LogChunk(), " + std::to_string(ticks) + " ticks", max_ns, total_ns / periods);
+        }
+    }
+
+    std::filesystem::remove(log);
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include "BenchUtils.h"
+#include "IMetrics/LatencyMetric.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Cost of one LatencyMetric::Observe as the number of observing threads grows from 1 to 64:
+// one histogram behind a mutex (how LatencyMetric recorded before it got per-thread shards)
+// against LatencyMetric, where every thread records into its own shard. The first is expected to
+// grow with the thread count once threads run on different cores and the second to stay nearly
+// flat; so far it has only been run on a single-core machine, where both grow.
+
+namespace {
+
+// One hdr_histogram, every Observe under one lock.
+class LockedLatency {
+public:
+    void Observe(std::chrono::nanoseconds latency) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        metric_.Observe(latency);
+    }
+
+private:
+    Metrics::BasicLatencyMetric<Metrics::SingleThreadPolicy> metric_;
+    std::mutex mutex_;
+};
+
+template <typename Metric>
+double NsPerObserve(std::size_t threads, std::size_t observations) {
+    Metric metric;
+    double ns = Bench::MeasureNs([&] {
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&metric, observations] {
+                for (std::size_t i = 0; i < observations; ++i) {
+                    metric.Observe(std::chrono::nanoseconds(1000 + i % 4096));
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    });
+    // Wall time per observation of one thread: flat means threads don't slow each other down.
+    return ns / observations;
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::size_t observations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    std::cout << observations << " observations per thread, " << std::thread::hardware_concurrency()
+              << " hardware threads\n";
+    std::cout << std::left << std::setw(10) << "threads" << std::right << std::setw(16) << "mutex ns"
+              << std::setw(16) << "sharded ns" << '\n';
+
+    for (std::size_t threads = 1; threads <= 64; threads *= 2) {
+        std::cout << std::left << std::setw(10) << threads << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(16) << NsPerObserve<LockedLatency>(threads, observations)
+                  << std::setw(16) << NsPerObserve<Metrics::LatencyMetric>(threads, observations) << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include "BenchUtils.h"
+#include "MetricsManager/MetricsManager.h"
+#include "IMetrics/CPUUsageMetric.h"
+#include "IMetrics/IncrementMetric.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Time of one Log() over a large registry, serial and on WorkStealingPool with a growing number
+// of workers. Every 256th metric is a CPUUsageMetric, whose Evaluate() reads /proc/stat.
+
+int main(int argc, char** argv) {
+    std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+    int scrapes = 5;
+    std::string log = (std::filesystem::temp_directory_path() / "parallel_scrape_bench.log").string();
+
+    std::cout << count << " metrics, " << std::thread::hardware_concurrency() << " hardware threads\n";
+    {
+        MetricsManager<> manager(log);
+        for (std::size_t i = 0; i < count; ++i) {
+            if (i % 256 == 0) {
+                manager.CreateMetric<Metrics::CPUUsageMetric>();
+            } else {
+                manager.CreateMetric<Metrics::IncrementMetric>("Counter" + std::to_string(i), i);
+            }
+        }
+
+        auto report = [&](const std::string& label) {
+            manager.Log();
+            double ns = Bench::MeasureNs([&] {
+                for (int i = 0; i < scrapes; ++i) {
+                    manager.Log();
+                }
+            });
+            std::cout << std::left << std::setw(20) << label << std::right << std::setw(10)
+                      << std::fixed << std::setprecision(2) << ns / scrapes / 1e6 << " ms/scrape\n";
+        };
+
+        report("serial");
+        for (std::size_t threads = 1; threads <= std::thread::hardware_concurrency(); threads *= 2) {
+            MetricsExecution::WorkStealingPool pool(threads);
+            manager.SetExecutor(&pool);
+            report(std::to_string(threads) + " workers");
+            manager.SetExecutor(nullptr);
+        }
+    }
+
+    std::filesystem::remove(log);
+    return 0;
+}
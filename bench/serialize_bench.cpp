@@ -0,0 +1,114 @@
+#include "BenchUtils.h"
+#include "MetricsManager/MetricsManager.h"
+#include "IMetrics/CodeTimeMetric.h"
+#include "IMetrics/HTTPIncomeMetric.h"
+#include "IMetrics/IncrementMetric.h"
+#include "IMetrics/LatencyMetric.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// Cost of turning a registry into text: GetName() + GetValueAsString() temporaries against
+// AppendName() + AppendValue() into a reused buffer, and the allocations of a whole Log().
+
+namespace {
+
+std::atomic<std::uint64_t> allocations{0};
+
+constexpr int kRounds = 20;
+
+void Report(const std::string& label, std::size_t count, double ns, std::uint64_t allocated) {
+    std::cout << std::left << std::setw(28) << label << std::right << std::setw(10)
+              << std::fixed << std::setprecision(2) << ns / kRounds / count << " ns/metric"
+              << std::setw(12) << static_cast<double>(allocated) / kRounds << " allocations/scrape\n";
+}
+
+template <typename F>
+void Measure(const std::string& label, std::size_t count, F&& scrape) {
+    // The first round grows the reused buffers.
+    scrape();
+    std::uint64_t before = allocations.load(std::memory_order_relaxed);
+    double ns = Bench::MeasureNs([&] {
+        for (int round = 0; round < kRounds; ++round) {
+            scrape();
+        }
+    });
+    Report(label, count, ns, allocations.load(std::memory_order_relaxed) - before);
+}
+
+}
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+int main(int argc, char** argv) {
+    std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000;
+    std::string log = (std::filesystem::temp_directory_path() / "serialize_bench.log").string();
+    std::cout << "Serializing " << count << " metrics, " << kRounds << " rounds\n";
+
+    {
+        MetricsManager<> manager(log);
+        std::vector<Metrics::IMetric*> metrics;
+        for (std::size_t i = 0; i < count; ++i) {
+            switch (i % 4) {
+                case 0: metrics.push_back(manager.CreateMetric<Metrics::IncrementMetric>("Counter" + std::to_string(i), i)); break;
+                case 1: metrics.push_back(manager.CreateMetric<Metrics::HTTPIncomeMetric>()); break;
+                case 2: metrics.push_back(manager.CreateMetric<Metrics::CodeTimeMetric>()); break;
+                case 3: {
+                    auto* latency = manager.CreateMetric<Metrics::LatencyMetric>();
+                    latency->Observe(std::chrono::nanoseconds(i * 1000 + 1));
+                    metrics.push_back(latency);
+                    break;
+                }
+            }
+        }
+
+        std::string text;
+        Measure("GetValueAsString", count, [&] {
+            text.clear();
+            for (Metrics::IMetric* metric : metrics) {
+                text += metric->GetName();
+                text += ": ";
+                text += metric->GetValueAsString();
+                text += '\n';
+            }
+            Bench::DoNotOptimize(text);
+        });
+        Measure("AppendValue", count, [&] {
+            text.clear();
+            for (Metrics::IMetric* metric : metrics) {
+                metric->AppendName(text);
+                text += ": ";
+                metric->AppendValue(text);
+                text += '\n';
+            }
+            Bench::DoNotOptimize(text);
+        });
+        Measure("MetricsManager::Log", count, [&] {
+            manager.Log();
+        });
+    }
+    std::filesystem::remove(log);
+
+    return 0;
+}
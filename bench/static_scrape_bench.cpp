@@ -0,0 +1,72 @@
+#include "BenchUtils.h"
+#include "MetricsManager/MetricsManager.h"
+#include "MetricsManager/StaticMetricsManager.h"
+#include "IMetrics/CodeTimeMetric.h"
+#include "IMetrics/HTTPIncomeMetric.h"
+#include "IMetrics/IncrementMetric.h"
+#include "IMetrics/LatencyMetric.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Caller-side cost of one scrape of the same metric set through MetricsManager (virtual calls,
+// runtime tag filtering) and StaticMetricsManager (tuple storage, compile-time filtering).
+
+namespace {
+
+using StaticManager = StaticMetricsManager<
+    Metrics::IncrementMetric, Metrics::IncrementMetric, Metrics::IncrementMetric, Metrics::IncrementMetric,
+    Metrics::HTTPIncomeMetric, Metrics::HTTPIncomeMetric,
+    Metrics::CodeTimeMetric, Metrics::LatencyMetric
+>;
+
+std::string TempLog(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+template <typename F>
+void Report(const std::string& label, int scrapes, F&& scrape) {
+    double ns = Bench::MeasureNs([&] {
+        for (int i = 0; i < scrapes; ++i) {
+            scrape();
+        }
+    });
+    std::cout << std::left << std::setw(36) << label << std::right << std::setw(10)
+              << std::fixed << std::setprecision(1) << ns / scrapes << " ns/scrape\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+    int scrapes = argc > 1 ? std::atoi(argv[1]) : 20'000;
+    std::string dynamic_log = TempLog("static_scrape_bench_dynamic.log");
+    std::string static_log = TempLog("static_scrape_bench_static.log");
+
+    std::cout << scrapes << " scrapes of 8 metrics\n";
+    {
+        MetricsManager<> manager(dynamic_log);
+        for (int i = 0; i < 4; ++i) {
+            manager.CreateMetric<Metrics::IncrementMetric>();
+        }
+        manager.CreateMetric<Metrics::HTTPIncomeMetric>();
+        manager.CreateMetric<Metrics::HTTPIncomeMetric>();
+        manager.CreateMetric<Metrics::CodeTimeMetric>();
+        manager.CreateMetric<Metrics::LatencyMetric>();
+
+        Report("MetricsManager Log()", scrapes, [&] { manager.Log(); });
+        Report("MetricsManager Log<Server>()", scrapes, [&] { manager.Log<MetricTags::ServerMetricTag>(); });
+    }
+    {
+        StaticManager manager(static_log);
+
+        Report("StaticMetricsManager Log()", scrapes, [&] { manager.Log(); });
+        Report("StaticMetricsManager Log<Server>()", scrapes, [&] { manager.Log<MetricTags::ServerMetricTag>(); });
+    }
+
+    std::filesystem::remove(dynamic_log);
+    std::filesystem::remove(static_log);
+    return 0;
+}
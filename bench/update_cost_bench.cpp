@@ -0,0 +1,114 @@
+#include "BenchUtils.h"
+#include "IMetrics/CardinalityMetricValue.h"
+#include "IMetrics/CodeTimeMetric.h"
+#include "IMetrics/HTTPIncomeMetric.h"
+#include "IMetrics/HTTPRouteMetric.h"
+#include "IMetrics/IncrementMetric.h"
+#include "IMetrics/LatencyMetric.h"
+#include "IMetrics/RequestMetric.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+// Cost of one update of each metric type from a single thread. The update paths are defined in
+// the headers, so they inline into the loop; build once with -DMETRICS_ENABLE_LTO=ON and once
+// without to see what link-time optimization adds on top.
+
+namespace {
+
+static_assert(std::is_final_v<Metrics::IncrementMetric>);
+static_assert(std::is_final_v<Metrics::HTTPIncomeMetric>);
+static_assert(std::is_final_v<Metrics::HTTPRouteMetric>);
+static_assert(std::is_final_v<Metrics::RequestMetric>);
+static_assert(std::is_final_v<Metrics::LatencyMetric>);
+static_assert(std::is_final_v<Metrics::CodeTimeMetric>);
+static_assert(std::is_final_v<Metrics::CardinalityMetricValue<int>>);
+
+template <typename F>
+void Measure(const std::string& label, std::size_t updates, F&& update) {
+    update(0);
+    double ns = Bench::MeasureNs([&] {
+        for (std::size_t i = 0; i < updates; ++i) {
+            update(i);
+        }
+    });
+    std::cout << std::left << std::setw(36) << label << std::right << std::setw(10)
+              << std::fixed << std::setprecision(2) << ns / updates << " ns/update\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::size_t updates = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5'000'000;
+#ifdef METRICS_BENCH_LTO
+    std::cout << updates << " updates per metric, LTO on\n";
+#else
+    std::cout << updates << " updates per metric, LTO off\n";
+#endif
+
+    Metrics::IncrementMetric increment("Counter");
+    Measure("IncrementMetric ++", updates, [&](std::size_t) { ++increment; });
+
+    Metrics::StripedIncrementMetric striped("Striped");
+    Measure("StripedIncrementMetric ++", updates, [&](std::size_t) { ++striped; });
+
+    Metrics::PerThreadIncrementMetric per_thread("PerThread");
+    Measure("PerThreadIncrementMetric ++", updates, [&](std::size_t) { ++per_thread; });
+
+    Metrics::HTTPIncomeMetric rps;
+    Measure("HTTPIncomeMetric ++", updates, [&](std::size_t) { ++rps; });
+
+    Metrics::LatencyMetric latency;
+    Measure("LatencyMetric Observe", updates, [&](std::size_t i) {
+        latency.Observe(std::chrono::nanoseconds(1000 + i % 4096));
+    });
+
+    Metrics::BasicLatencyMetric<Metrics::SingleThreadPolicy> local_latency;
+    Measure("LatencyMetric<SingleThread> Observe", updates, [&](std::size_t i) {
+        local_latency.Observe(std::chrono::nanoseconds(1000 + i % 4096));
+    });
+
+    Metrics::CodeTimeMetric code_time("\"Task\"");
+    Measure("CodeTimeMetric Start+Stop", updates, [&](std::size_t) {
+        code_time.Start();
+        code_time.Stop();
+    });
+
+    Metrics::HTTPRouteMetric routes(Metrics::RouteTable{"/a", "/b", "/c", "/d"}, "\"Routes\"");
+    Measure("HTTPRouteMetric Increment", updates, [&](std::size_t i) {
+        routes.Increment(i % 4, i % 16 == 0 ? 500 : 200);
+    });
+
+    // A request measured with separate metrics, and with one tracker.
+    Metrics::IncrementMetric errors("Errors");
+    Measure("HTTPIncome+Latency+Increment", updates, [&](std::size_t i) {
+        auto start = std::chrono::steady_clock::now();
+        ++rps;
+        latency.Observe(std::chrono::steady_clock::now() - start);
+        if (i % 16 == 0) {
+            ++errors;
+        }
+    });
+
+    Metrics::RequestMetric requests("\"Requests\"");
+    Measure("RequestMetric Track", updates, [&](std::size_t i) {
+        auto tracker = requests.Track();
+        tracker.SetStatus(i % 16 == 0 ? 500 : 200);
+    });
+
+    Metrics::CardinalityMetricValue<int> cardinality;
+    Measure("CardinalityMetricValue Observe", updates, [&](std::size_t i) {
+        cardinality.Observe(static_cast<int>(i % 64));
+    });
+
+    Bench::DoNotOptimize(increment);
+    Bench::DoNotOptimize(striped);
+    Bench::DoNotOptimize(per_thread);
+    Bench::DoNotOptimize(rps);
+    Bench::DoNotOptimize(errors);
+    return 0;
+}
@@ -14,9 +14,11 @@ struct SomeStruct {
 };
 
 int main() {
-    MetricsManager manager_work_examples("../examples.log");
-    MetricsManager manager_log_work_examples("../diff_logs_examples.log");
-    MetricsManager manager_multithread_examples("../multithread_examples.log");
+    // All three managers share one writer thread.
+    auto& writer_service = NonBlockingWriter::WriterService::Default();
+    MetricsManager manager_work_examples(writer_service, "../examples.log");
+    MetricsManager manager_log_work_examples(writer_service, "../diff_logs_examples.log");
+    MetricsManager manager_multithread_examples(writer_service, "../multithread_examples.log");
     
     // How to use: CardinalityMetricType
     {
@@ -100,7 +102,7 @@ int main() {
     
     // How to use: HTTPIncomeMetric
     {
-        auto* http_metric = manager_work_examples.CreateMetric<Metrics::HTTPIncomeMetric>(0);
+        auto* http_metric = manager_work_examples.CreateMetric<Metrics::HTTPIncomeMetric>();
         
         for (int i = 0; i < 50; ++i) {
             ++(*http_metric);
@@ -159,7 +161,7 @@ int main() {
     {       
         auto* counter = manager_log_work_examples.CreateMetric<Metrics::IncrementMetric>("GeneralCounter", 0);
         auto* cpu_metric = manager_log_work_examples.CreateMetric<Metrics::CPUUsageMetric>();
-        auto* http_metric = manager_log_work_examples.CreateMetric<Metrics::HTTPIncomeMetric>(0);
+        auto* http_metric = manager_log_work_examples.CreateMetric<Metrics::HTTPIncomeMetric>();
         auto* algo_timer = manager_log_work_examples.CreateMetric<Metrics::CodeTimeMetric>("SortAlgorithm");
         auto* latency_metric = manager_log_work_examples.CreateMetric<Metrics::LatencyMetric>();
 
@@ -190,7 +192,7 @@ int main() {
     // MultiThreadWorking
     {
         auto* shared_counter = manager_multithread_examples.CreateMetric<Metrics::IncrementMetric>("SharedCounter", 0);
-        auto* request_counter = manager_multithread_examples.CreateMetric<Metrics::HTTPIncomeMetric>(0);
+        auto* request_counter = manager_multithread_examples.CreateMetric<Metrics::HTTPIncomeMetric>();
         auto* latency_tracker = manager_multithread_examples.CreateMetric<Metrics::LatencyMetric>();
         
         const int num_threads = 8;
@@ -0,0 +1,24 @@
+#include <fstream>
+#include <iostream>
+
+#include "MultiThreadWriter/LogDecoder.h"
+
+// Restores text lines from a log written with LogEncoding::Dictionary.
+//
+// Usage: metrics_log_decoder [log file]
+// Without a file the log is read from stdin; decoded lines go to stdout.
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        NonBlockingWriter::LogDecoder::Decode(std::cin, std::cout);
+        return 0;
+    }
+
+    std::ifstream file(argv[1]);
+    if (!file.is_open()) {
+        std::cerr << "Can't open " << argv[1] << std::endl;
+        return 1;
+    }
+    NonBlockingWriter::LogDecoder::Decode(file, std::cout);
+
+    return 0;
+}
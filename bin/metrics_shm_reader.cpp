@@ -0,0 +1,51 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MetricsManager/SharedMemoryTable.h"
+
+// Prints the metrics a MetricsManager exports with ExportToSharedMemory().
+//
+// Usage: metrics_shm_reader <segment name> [interval ms] [samples]
+// Without an interval the table is printed once. With an interval it is printed every time the
+// writer publishes a new generation; the polling itself is plain memory reads.
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <segment name> [interval ms] [samples]" << std::endl;
+        return 1;
+    }
+
+    std::string name = argv[1];
+    std::chrono::milliseconds interval{argc > 2 ? std::stol(argv[2]) : 0};
+    long samples = argc > 3 ? std::stol(argv[3]) : (interval.count() == 0 ? 1 : -1);
+
+    MetricsServer::SharedMemoryReader reader;
+    if (!reader.Open(name)) {
+        std::cerr << "Can't open shared memory segment " << name << std::endl;
+        return 1;
+    }
+
+    std::vector<MetricsServer::SharedMemoryReader::Entry> entries;
+    std::uint64_t last_generation = 0;
+    for (long printed = 0; samples < 0 || printed < samples;) {
+        std::uint64_t generation = reader.Generation();
+        if (generation != last_generation || printed == 0) {
+            reader.Read(entries);
+            std::cout << "# generation " << generation << ", updated at " << reader.UpdateTimeNs() << " ns" << std::endl;
+            for (const auto& entry : entries) {
+                std::cout << entry.name << ": " << entry.value << std::endl;
+            }
+            last_generation = generation;
+            ++printed;
+        }
+
+        if (interval.count() == 0) {
+            break;
+        }
+        std::this_thread::sleep_for(interval);
+    }
+
+    return 0;
+}
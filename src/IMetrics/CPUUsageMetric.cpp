@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <iomanip>
 #include <sstream>
 #include <string>
 
@@ -13,9 +14,12 @@
 
 using namespace Metrics;
 
-CPUUsageMetric::CPUUsageMetric() : cpu_usage_percent_(0.0)
+template <ThreadingPolicy Policy>
+BasicCPUUsageMetric<Policy>::BasicCPUUsageMetric(std::chrono::nanoseconds min_evaluate_interval)
+    : cpu_usage_percent_(0.0)
+    , min_evaluate_interval_(min_evaluate_interval)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard lock(mutex_);
     if (getCurrentCPUTimes(prev_cpu_times_)) {
         prev_time_point_ = std::chrono::steady_clock::now();
     } else {
@@ -25,19 +29,42 @@ CPUUsageMetric::CPUUsageMetric() : cpu_usage_percent_(0.0)
     }
 }
 
-std::string CPUUsageMetric::GetName() const noexcept {
+template <ThreadingPolicy Policy>
+std::string BasicCPUUsageMetric<Policy>::GetName() const noexcept {
     return "\"CPU Usage\"";
 }
 
-std::string CPUUsageMetric::GetValueAsString() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(2) << cpu_usage_percent_ << "%";
-    return oss.str();
+template <ThreadingPolicy Policy>
+std::chrono::nanoseconds BasicCPUUsageMetric<Policy>::MinEvaluateInterval() const noexcept {
+    return min_evaluate_interval_;
 }
 
-void CPUUsageMetric::Evaluate() {
-    std::lock_guard<std::mutex> lock(mutex_);
+template <ThreadingPolicy Policy>
+std::string BasicCPUUsageMetric<Policy>::GetValueAsString() const {
+    std::string value;
+    AppendValue(value);
+    return value;
+}
+
+template <ThreadingPolicy Policy>
+void BasicCPUUsageMetric<Policy>::AppendName(OutputBuffer& out) const {
+    out += "\"CPU Usage\"";
+}
+
+template <ThreadingPolicy Policy>
+void BasicCPUUsageMetric<Policy>::AppendValue(OutputBuffer& out) const {
+    Format::AppendFixed(out, cpu_usage_percent_.load(std::memory_order_relaxed), 2);
+    out += '%';
+}
+
+template <ThreadingPolicy Policy>
+MetricSnapshot BasicCPUUsageMetric<Policy>::GetSnapshot() const {
+    return Snapshot::Gauge{cpu_usage_percent_.load(std::memory_order_relaxed)};
+}
+
+template <ThreadingPolicy Policy>
+void BasicCPUUsageMetric<Policy>::Evaluate() {
+    std::lock_guard lock(mutex_);
 
     CPUTimes current_cpu_times;
     if (!getCurrentCPUTimes(current_cpu_times)) {
@@ -71,15 +98,17 @@ void CPUUsageMetric::Evaluate() {
     prev_time_point_ = std::chrono::steady_clock::now();
 }
 
-void CPUUsageMetric::Reset() {
-    std::lock_guard<std::mutex> lock(mutex_);
+template <ThreadingPolicy Policy>
+void BasicCPUUsageMetric<Policy>::Reset() {
+    std::lock_guard lock(mutex_);
     cpu_usage_percent_ = 0.0;
     prev_cpu_times_ = {};
     prev_time_point_ = std::chrono::steady_clock::time_point();
 }
 
 #ifdef __linux__
-bool CPUUsageMetric::getCurrentCPUTimes(CPUTimes& times) const {
+template <ThreadingPolicy Policy>
+bool BasicCPUUsageMetric<Policy>::getCurrentCPUTimes(CPUTimes& times) const {
     std::ifstream file("/proc/stat");
     if (!file.is_open()) {
         std::cerr << "Failed to open /proc/stat" << std::endl;
@@ -101,7 +130,8 @@ bool CPUUsageMetric::getCurrentCPUTimes(CPUTimes& times) const {
     return true;
 }
 #elif _WIN32
-bool CPUUsageMetric::getCurrentCPUTimes(CPUTimes& times) const {
+template <ThreadingPolicy Policy>
+bool BasicCPUUsageMetric<Policy>::getCurrentCPUTimes(CPUTimes& times) const {
     FILETIME idleTime, kernelTime, userTime;
 
     if (!GetSystemTimes(&idleTime, &kernelTime, &userTime)) {
@@ -130,4 +160,8 @@ bool CPUUsageMetric::getCurrentCPUTimes(CPUTimes& times) const {
     
     return true;
 }
-#endif
\ No newline at end of file
+#endif
+
+template class Metrics::BasicCPUUsageMetric<Metrics::SingleThreadPolicy>;
+template class Metrics::BasicCPUUsageMetric<Metrics::MutexPolicy>;
+template class Metrics::BasicCPUUsageMetric<Metrics::SpinLockPolicy>;
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "IMetrics.h"
+#include "ThreadingPolicy.h"
+#include "Demangle.h"
 
+#include <atomic>
 #include <string>
 #include <mutex>
 #include <chrono> 
@@ -25,22 +28,47 @@ struct CPUTimes {
 
 namespace Metrics {
 
-class CPUUsageMetric final : public IMetric, public MetricTags::ComputerMetricTag {
+// Policy - how Evaluate() and Reset() are synchronized, see ThreadingPolicy.h. The value is an
+// atomic, so scrapes read it without taking the lock under any policy.
+template <ThreadingPolicy Policy = MutexPolicy>
+class BasicCPUUsageMetric final : public IMetric, public MetricTags::ComputerMetricTag {
 public:
-    CPUUsageMetric();
+    static constexpr bool kThreadConfined = kThreadConfinedPolicy<Policy>;
+
+    // min_evaluate_interval - see IMetric::MinEvaluateInterval; every Evaluate() reads /proc/stat.
+    explicit BasicCPUUsageMetric(std::chrono::nanoseconds min_evaluate_interval = {});
 
     std::string GetName() const noexcept override;
     std::string GetValueAsString() const override;
+    void AppendName(OutputBuffer& out) const override;
+    void AppendValue(OutputBuffer& out) const override;
+    MetricSnapshot GetSnapshot() const override;
     void Evaluate() override;
     void Reset() override;
+    std::chrono::nanoseconds MinEvaluateInterval() const noexcept override;
+    std::string_view GetUnit() const noexcept override { return "%"; }
 
 private:
-    double cpu_usage_percent_;
+    std::atomic<double> cpu_usage_percent_;
+    // Evaluate() state, under mutex_.
     CPUTimes prev_cpu_times_;
     std::chrono::steady_clock::time_point prev_time_point_;
-    mutable std::mutex mutex_;
+    std::chrono::nanoseconds min_evaluate_interval_;
+    mutable typename Policy::Mutex mutex_;
 
     bool getCurrentCPUTimes(CPUTimes& times) const;
 };
 
-}
\ No newline at end of file
+// Safe to share between threads; the type existing code uses.
+using CPUUsageMetric = BasicCPUUsageMetric<MutexPolicy>;
+
+// Defined in CPUUsageMetric.cpp for the built-in policies.
+extern template class BasicCPUUsageMetric<SingleThreadPolicy>;
+extern template class BasicCPUUsageMetric<MutexPolicy>;
+extern template class BasicCPUUsageMetric<SpinLockPolicy>;
+
+}
+
+// Keeps the log metadata name of the default instantiation.
+template <>
+inline constexpr std::string_view kTypeName<Metrics::CPUUsageMetric> = "Metrics::CPUUsageMetric";
@@ -15,7 +15,8 @@
 
 using namespace Metrics;
 
-CPUMetric::CPUMetric() : current_utilization_(0.0), cpu_count_(0) {
+CPUMetric::CPUMetric(std::chrono::nanoseconds min_evaluate_interval)
+    : current_utilization_(0.0), cpu_count_(0), min_evaluate_interval_(min_evaluate_interval) {
     cpu_count_ = GetCPUCount();
     InitializeCPUData();
 }
@@ -24,11 +25,28 @@ std::string CPUMetric::GetName() const noexcept {
     return "\"CPU\"";
 }
 
+std::chrono::nanoseconds CPUMetric::MinEvaluateInterval() const noexcept {
+    return min_evaluate_interval_;
+}
+
 std::string CPUMetric::GetValueAsString() const {
+    std::string value;
+    AppendValue(value);
+    return value;
+}
+
+void CPUMetric::AppendName(OutputBuffer& out) const {
+    out += "\"CPU\"";
+}
+
+void CPUMetric::AppendValue(OutputBuffer& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Format::AppendFixed(out, current_utilization_, 2);
+}
+
+MetricSnapshot CPUMetric::GetSnapshot() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(2) << current_utilization_;
-    return oss.str();
+    return Snapshot::Gauge{current_utilization_};
 }
 
 void CPUMetric::Evaluate() {
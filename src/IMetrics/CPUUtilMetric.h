@@ -2,6 +2,7 @@
 
 #include "IMetrics.h"
 
+#include <chrono>
 #include <mutex>
 
 namespace Metrics {
@@ -9,6 +10,7 @@ namespace Metrics {
     private:
         double current_utilization_;
         int cpu_count_;
+        std::chrono::nanoseconds min_evaluate_interval_;
         mutable std::mutex mutex_;
         
     #ifdef _WIN32
@@ -21,11 +23,16 @@ namespace Metrics {
     #endif
         
     public:
-        CPUMetric();
+        // min_evaluate_interval - see IMetric::MinEvaluateInterval.
+        explicit CPUMetric(std::chrono::nanoseconds min_evaluate_interval = {});
         std::string GetName() const noexcept override;
         std::string GetValueAsString() const override;
+        void AppendName(OutputBuffer& out) const override;
+        void AppendValue(OutputBuffer& out) const override;
+        MetricSnapshot GetSnapshot() const override;
         void Evaluate() override;
         void Reset() override;
+        std::chrono::nanoseconds MinEvaluateInterval() const noexcept override;
         
     private:
         void InitializeCPUData();
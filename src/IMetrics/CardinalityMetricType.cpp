@@ -2,7 +2,6 @@
 #include "IMetrics/MyAny.h"
 #include "Demangle.h"
 
-#include <sstream>
 #include <string>
 #include <vector>
 #include <algorithm>
@@ -16,10 +15,37 @@ std::string CardinalityMetricType::GetName() const noexcept {
 }
 
 std::string CardinalityMetricType::GetValueAsString() const {
+    std::string value;
+    AppendValue(value);
+    return value;
+}
+
+void CardinalityMetricType::AppendName(OutputBuffer& out) const {
+    out += "\"CardinalityType\"";
+}
+
+// Still allocates to rank the items, but writes straight into out.
+void CardinalityMetricType::AppendValue(OutputBuffer& out) const {
+    Snapshot::TopN top = TopItems();
+    out += "General number of unique elements: ";
+    Format::AppendInteger(out, top.unique);
+    out += '\n';
+    Format::AppendInteger(out, n_top_);
+    out += " most frequent types: ";
+    for (const auto& item : top.items) {
+        out += item.label;
+        out += ' ';
+    }
+}
+
+MetricSnapshot CardinalityMetricType::GetSnapshot() const {
+    return TopItems();
+}
+
+Snapshot::TopN CardinalityMetricType::TopItems() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    std::ostringstream oss;
-    oss << "General number of unique elements: " << observed_items_.size() << '\n';
-    oss << std::to_string(n_top_) << " most frequent types: ";
+    Snapshot::TopN top;
+    top.unique = observed_items_.size();
     
     std::vector<std::pair<MyCustomAny::MyAny, long long>> sorted_items;
     for (const auto& item : observed_items_) {
@@ -32,11 +58,11 @@ std::string CardinalityMetricType::GetValueAsString() const {
               });
     
     int steps = std::min(n_top_, (int)sorted_items.size());
+    top.items.reserve(std::max(steps, 0));
     for (int i = 0; i < steps; ++i) {
-        oss << demangle(sorted_items[i].first.type().name()) << " ";
+        top.items.push_back({demangle(sorted_items[i].first.type().name()), sorted_items[i].second});
     }
-    
-    return oss.str();
+    return top;
 }
 
 void CardinalityMetricType::Evaluate() {}
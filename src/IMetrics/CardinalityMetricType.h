@@ -14,6 +14,9 @@ namespace Metrics {
         CardinalityMetricType(int n_top = 5);
         std::string GetName() const noexcept override;
         std::string GetValueAsString() const override;
+        void AppendName(OutputBuffer& out) const override;
+        void AppendValue(OutputBuffer& out) const override;
+        MetricSnapshot GetSnapshot() const override;
         void Evaluate() override;
         void Reset() override;
         
@@ -31,6 +34,8 @@ namespace Metrics {
         }
         
     private:
+        Snapshot::TopN TopItems() const;
+        
         struct MyAnyHash {
             std::size_t operator()(const MyCustomAny::MyAny& any) const {
                 if (!any.has_value()) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "IMetrics.h"
+#include "ThreadingPolicy.h"
 #include "Demangle.h"
 
 #include <string>
@@ -12,10 +13,13 @@
 #include <vector>
 #include <algorithm>
 
+template <typename T>
+concept CardinalityMetricValueSingleItem =
+    requires(T a, T b) { { a == b } -> std::convertible_to<bool>; } &&
+    requires(T a) { std::hash<std::decay_t<T>>{}(a); };
+
 template <typename... Args>
-concept CardinalityMetricValueItem =
-    (requires(Args a, Args b) { { a == b } -> std::convertible_to<bool>; } && ...) && 
-    (requires(Args a) { std::hash<std::decay_t<Args>>{}(a); } && ...);
+concept CardinalityMetricValueItem = (CardinalityMetricValueSingleItem<Args> && ...);
     
 template <typename T, typename Head, typename... Tail>
 struct TypeInPack {
@@ -45,57 +49,64 @@ std::string PrettyPrint(T&& item) {
 
 namespace Metrics {
     
-    template <CardinalityMetricValueItem... Args>    
-    class CardinalityMetricValue final : public IMetric {
+    // Policy - how Observe() and scrapes are synchronized, see ThreadingPolicy.h.
+    template <ThreadingPolicy Policy, CardinalityMetricValueItem... Args>
+    class BasicCardinalityMetricValue final : public IMetric {
         using Key = std::variant<Args...>;
         
     public:
-        CardinalityMetricValue(int n_top = 5) : n_top_(n_top) {}
+        static constexpr bool kThreadConfined = kThreadConfinedPolicy<Policy>;
+
+        BasicCardinalityMetricValue(int n_top = 5) : n_top_(n_top) {}
         
         std::string GetName() const noexcept override {
             return "\"CardinalityValue\"";
         }
         
         std::string GetValueAsString() const override {
-            std::lock_guard<std::mutex> lock(mutex_);
-            std::ostringstream oss;
-            oss << "General number of unique elements: " << observed_items_.size() << '\n';
-            oss << std::to_string(n_top_) << " most frequent types: ";
-            
-            std::vector<std::pair<Key, long long>> sorted_items;
-            for (const auto& item : observed_items_) {
-                sorted_items.emplace_back(item.first, item.second);
-            }
-            
-            std::sort(sorted_items.begin(), sorted_items.end(), 
-                      [](const auto& a, const auto& b) {
-                          return a.second > b.second;
-                      });
-            
-            int steps = std::min(n_top_, (int)sorted_items.size());
-            for (int i = 0; i < steps; ++i) {
-                std::visit([&oss](const auto& item) {
-                    oss << demangle(typeid(item).name()) << " " << PrettyPrint(item);
-                }, sorted_items[i].first);
-                oss << " (quantity: " << sorted_items[i].second << ")";
-                if (i < steps - 1) {
-                    oss << ", ";
+            std::string value;
+            AppendValue(value);
+            return value;
+        }
+        
+        void AppendName(OutputBuffer& out) const override {
+            out += "\"CardinalityValue\"";
+        }
+        
+        // Still allocates to rank the items and print them, but writes straight into out.
+        void AppendValue(OutputBuffer& out) const override {
+            Snapshot::TopN top = TopItems();
+            out += "General number of unique elements: ";
+            Format::AppendInteger(out, top.unique);
+            out += '\n';
+            Format::AppendInteger(out, n_top_);
+            out += " most frequent types: ";
+            for (size_t i = 0; i < top.items.size(); ++i) {
+                out += top.items[i].label;
+                out += " (quantity: ";
+                Format::AppendInteger(out, top.items[i].count);
+                out += ')';
+                if (i + 1 < top.items.size()) {
+                    out += ", ";
                 }
             }
-            
-            return oss.str();
+        }
+        
+        // Labels are "<type> <value>".
+        MetricSnapshot GetSnapshot() const override {
+            return TopItems();
         }
         
         void Evaluate() override {}
         
         void Reset() override {
-            std::lock_guard<std::mutex> lock(mutex_);
+            std::lock_guard lock(mutex_);
             observed_items_.clear();
         }
         
         template <typename T>
         void Observe(T&& item, long long count=1) requires (TypeInPack_v<T, Args...>) {
-            std::lock_guard<std::mutex> lock(mutex_);
+            std::lock_guard lock(mutex_);
             Key key(std::forward<T>(item));
             
             auto it = observed_items_.find(key);
@@ -107,6 +118,32 @@ namespace Metrics {
         }
     
     private:
+        Snapshot::TopN TopItems() const {
+            std::lock_guard lock(mutex_);
+            Snapshot::TopN top;
+            top.unique = observed_items_.size();
+            
+            std::vector<std::pair<Key, long long>> sorted_items;
+            for (const auto& item : observed_items_) {
+                sorted_items.emplace_back(item.first, item.second);
+            }
+            
+            std::sort(sorted_items.begin(), sorted_items.end(), 
+                      [](const auto& a, const auto& b) {
+                          return a.second > b.second;
+                      });
+            
+            int steps = std::min(n_top_, (int)sorted_items.size());
+            top.items.reserve(std::max(steps, 0));
+            for (int i = 0; i < steps; ++i) {
+                std::string label = std::visit([](const auto& item) {
+                    return demangle(typeid(item).name()) + " " + PrettyPrint(item);
+                }, sorted_items[i].first);
+                top.items.push_back({std::move(label), sorted_items[i].second});
+            }
+            return top;
+        }
+        
         struct KeyHash {
             std::size_t operator()(const Key& item) const {
                 return std::visit([](const auto& item){
@@ -117,6 +154,10 @@ namespace Metrics {
         
         int n_top_;
         std::unordered_map<Key, long long, KeyHash> observed_items_;
-        mutable std::mutex mutex_;
+        mutable typename Policy::Mutex mutex_;
     };
+
+    // Safe to share between threads; the type existing code uses.
+    template <CardinalityMetricValueItem... Args>
+    using CardinalityMetricValue = BasicCardinalityMetricValue<MutexPolicy, Args...>;
 }
\ No newline at end of file
@@ -1,65 +1,80 @@
 #include "CodeTimeMetric.h"
 
 #include <string>
-#include <sstream>
-#include <iomanip>
 
 using namespace Metrics;
 
-std::string CodeTimeMetric::CreateDefaultName() {
-    std::lock_guard<std::mutex> lock(counter_mutex_);
-    return "\"Algorithm " + std::to_string(++counter) + "\"";
+namespace {
+    // Shared by every policy, so default names stay unique.
+    std::atomic<unsigned long long> default_name_counter = 0;
 }
 
-CodeTimeMetric::CodeTimeMetric(const std::string& name)
+template <ThreadingPolicy Policy>
+std::string BasicCodeTimeMetric<Policy>::CreateDefaultName() {
+    return "\"Algorithm " + std::to_string(++default_name_counter) + "\"";
+}
+
+template <ThreadingPolicy Policy>
+BasicCodeTimeMetric<Policy>::BasicCodeTimeMetric(const std::string& name)
     : task_name_(name)
     , start_(std::chrono::high_resolution_clock::now())
     , finish_(std::chrono::high_resolution_clock::now())
     , is_running_(false)
 {}
 
-std::string CodeTimeMetric::GetName() const noexcept {
+template <ThreadingPolicy Policy>
+std::string BasicCodeTimeMetric<Policy>::GetName() const noexcept {
     return task_name_;
 }
 
-std::string CodeTimeMetric::GetValueAsString() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(2);
+template <ThreadingPolicy Policy>
+std::string BasicCodeTimeMetric<Policy>::GetValueAsString() const {
+    std::string value;
+    AppendValue(value);
+    return value;
+}
+
+template <ThreadingPolicy Policy>
+void BasicCodeTimeMetric<Policy>::AppendName(OutputBuffer& out) const {
+    out += task_name_;
+}
+
+template <ThreadingPolicy Policy>
+void BasicCodeTimeMetric<Policy>::AppendValue(OutputBuffer& out) const {
+    std::lock_guard lock(mutex_);
     auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(finish_ - start_).count();
     if (duration < 1'000) {
-        oss << duration << " ns";
+        Format::AppendInteger(out, duration);
+        out += " ns";
     } else if (duration < 1'000'000) {
-        oss << duration / 1'000.0 << " μs";
+        Format::AppendFixed(out, duration / 1'000.0, 2);
+        out += " μs";
     } else if (duration < 1'000'000'000) {
-        oss << duration / 1'000'000.0 << " ms";
+        Format::AppendFixed(out, duration / 1'000'000.0, 2);
+        out += " ms";
     } else {
-        oss << duration / 1'000'000'000.0 << " s";
+        Format::AppendFixed(out, duration / 1'000'000'000.0, 2);
+        out += " s";
     }
-    
-    return oss.str();
 }
 
-void CodeTimeMetric::Evaluate() {}
-
-void CodeTimeMetric::Reset() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    start_ = std::chrono::high_resolution_clock::now();
-    finish_ = std::chrono::high_resolution_clock::now();
-    is_running_ = false;
+template <ThreadingPolicy Policy>
+MetricSnapshot BasicCodeTimeMetric<Policy>::GetSnapshot() const {
+    std::lock_guard lock(mutex_);
+    return Snapshot::Duration{std::chrono::duration_cast<std::chrono::nanoseconds>(finish_ - start_)};
 }
 
-void CodeTimeMetric::Start() {
-    std::lock_guard<std::mutex> lock(mutex_);
+template <ThreadingPolicy Policy>
+void BasicCodeTimeMetric<Policy>::Evaluate() {}
+
+template <ThreadingPolicy Policy>
+void BasicCodeTimeMetric<Policy>::Reset() {
+    std::lock_guard lock(mutex_);
     start_ = std::chrono::high_resolution_clock::now();
     finish_ = std::chrono::high_resolution_clock::now();
-    is_running_ = true;
+    is_running_ = false;
 }
 
-void CodeTimeMetric::Stop() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (is_running_) {
-        finish_ = std::chrono::high_resolution_clock::now();   
-        is_running_ = false;
-    }
-}
\ No newline at end of file
+template class Metrics::BasicCodeTimeMetric<Metrics::SingleThreadPolicy>;
+template class Metrics::BasicCodeTimeMetric<Metrics::MutexPolicy>;
+template class Metrics::BasicCodeTimeMetric<Metrics::SpinLockPolicy>;
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "IMetrics.h"
+#include "ThreadingPolicy.h"
+#include "Demangle.h"
 
 #include <string>
 #include <mutex>
@@ -8,21 +10,39 @@
 #include <atomic>
 
 namespace Metrics {
-    class CodeTimeMetric final : public IMetric, public MetricTags::AlgoMetricTag {
+    // Policy - how Start()/Stop() and scrapes are synchronized, see ThreadingPolicy.h.
+    template <ThreadingPolicy Policy = MutexPolicy>
+    class BasicCodeTimeMetric final : public IMetric, public MetricTags::AlgoMetricTag {
     private:
-        static inline std::atomic<unsigned long long> counter = 0;
-        static inline std::mutex counter_mutex_;
         static std::string CreateDefaultName();
     public:
-        CodeTimeMetric(const std::string& name=CreateDefaultName());
+        static constexpr bool kThreadConfined = kThreadConfinedPolicy<Policy>;
+
+        BasicCodeTimeMetric(const std::string& name=CreateDefaultName());
         
         std::string GetName() const noexcept override;
         std::string GetValueAsString() const override;
+        void AppendName(OutputBuffer& out) const override;
+        void AppendValue(OutputBuffer& out) const override;
+        MetricSnapshot GetSnapshot() const override;
         void Evaluate() override;
         void Reset() override;
         
-        void Start();
-        void Stop();
+        void Start() {
+            std::lock_guard lock(mutex_);
+            start_ = std::chrono::high_resolution_clock::now();
+            finish_ = start_;
+            is_running_ = true;
+        }
+
+        void Stop() {
+            auto now = std::chrono::high_resolution_clock::now();
+            std::lock_guard lock(mutex_);
+            if (is_running_) {
+                finish_ = now;
+                is_running_ = false;
+            }
+        }
         
     private:
     
@@ -31,6 +51,18 @@ namespace Metrics {
         std::chrono::high_resolution_clock::time_point finish_;
         bool is_running_;
         
-        mutable std::mutex mutex_;
+        mutable typename Policy::Mutex mutex_;
     };
-}
\ No newline at end of file
+
+    // Safe to share between threads; the type existing code uses.
+    using CodeTimeMetric = BasicCodeTimeMetric<MutexPolicy>;
+
+    // Defined in CodeTimeMetric.cpp for the built-in policies.
+    extern template class BasicCodeTimeMetric<SingleThreadPolicy>;
+    extern template class BasicCodeTimeMetric<MutexPolicy>;
+    extern template class BasicCodeTimeMetric<SpinLockPolicy>;
+}
+
+// Keeps the log metadata name of the default instantiation.
+template <>
+inline constexpr std::string_view kTypeName<Metrics::CodeTimeMetric> = "Metrics::CodeTimeMetric";
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace Metrics {
+    // Per-CPU striping shared by the striped counters: one stripe per hardware thread, rounded up
+    // to a power of two so a CPU number maps to a stripe with a mask, at most kMaxCpuStripes.
+    inline constexpr std::size_t kMaxCpuStripes = 256;
+
+    inline std::size_t CpuStripeCount() noexcept {
+        static const std::size_t count = std::min<std::size_t>(
+            std::bit_ceil(std::max(1u, std::thread::hardware_concurrency())), kMaxCpuStripes);
+        return count;
+    }
+
+    // sched_getcpu() is a vDSO call (an rseq read on recent glibc), so it costs a few ns.
+    // A thread may migrate right after it, which only makes it share a stripe for one add.
+    // Elsewhere, or when the CPU is unknown, threads get stripes round-robin.
+    // Not masked: callers take it modulo their stripe count.
+    inline std::size_t CurrentCpuStripe() noexcept {
+#ifdef __linux__
+        int cpu = sched_getcpu();
+        if (cpu >= 0) {
+            return static_cast<std::size_t>(cpu);
+        }
+#endif
+        static std::atomic<std::size_t> next_slot{0};
+        static thread_local const std::size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    // Where BasicIncrementMetric keeps its count. Add() is the increment path, Load() - the scrape.
+    template <typename T>
+    concept CounterEngine = std::constructible_from<T, unsigned long long> &&
+        requires(T counter, const T const_counter, unsigned long long delta) {
+            counter.Add(delta);
+            { const_counter.Load() } -> std::convertible_to<unsigned long long>;
+            counter.Reset();
+        };
+
+    // One atomic. Cheapest to read and to keep around, but every updating thread writes the
+    // same cache line.
+    class AtomicCounter {
+    public:
+        explicit AtomicCounter(unsigned long long start = 0) noexcept : value_(start) {}
+
+        void Add(unsigned long long delta) noexcept {
+            value_.fetch_add(delta, std::memory_order_relaxed);
+        }
+
+        unsigned long long Load() const noexcept {
+            return value_.load(std::memory_order_relaxed);
+        }
+
+        void Reset() noexcept {
+            value_.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<unsigned long long> value_;
+    };
+
+    // One cache line per CPU: a thread adds to the stripe of the CPU it runs on, so threads on
+    // different cores don't contend; Load() sums the stripes. Costs 64 bytes per hardware thread
+    // (up to kMaxStripes) per counter, so it pays off only for counters updated from many cores.
+    class StripedCounter {
+    public:
+        static constexpr std::size_t kMaxStripes = kMaxCpuStripes;
+
+        explicit StripedCounter(unsigned long long start = 0)
+            : stripe_mask_(CpuStripeCount() - 1)
+            , stripes_(std::make_unique<Stripe[]>(CpuStripeCount()))
+        {
+            stripes_[0].value.store(start, std::memory_order_relaxed);
+        }
+
+        void Add(unsigned long long delta) noexcept {
+            stripes_[CurrentCpuStripe() & stripe_mask_].value.fetch_add(delta, std::memory_order_relaxed);
+        }
+
+        // Not a snapshot: increments that race with the scan may or may not be counted.
+        unsigned long long Load() const noexcept {
+            unsigned long long sum = 0;
+            for (std::size_t i = 0; i <= stripe_mask_; ++i) {
+                sum += stripes_[i].value.load(std::memory_order_relaxed);
+            }
+            return sum;
+        }
+
+        void Reset() noexcept {
+            for (std::size_t i = 0; i <= stripe_mask_; ++i) {
+                stripes_[i].value.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        std::size_t Stripes() const noexcept {
+            return stripe_mask_ + 1;
+        }
+
+    private:
+        struct alignas(64) Stripe {
+            std::atomic<unsigned long long> value{0};
+        };
+
+        std::size_t stripe_mask_;
+        std::unique_ptr<Stripe[]> stripes_;
+    };
+
+    // Dense indices into per-thread arrays that hold a thread's state for every object of a kind
+    // (PerThreadCounter, HistogramShards); an index is reused after its object is destroyed.
+    class PerThreadIndexPool {
+    public:
+        std::size_t Acquire() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (free_.empty()) {
+                return next_++;
+            }
+            std::size_t index = free_.back();
+            free_.pop_back();
+            return index;
+        }
+
+        void Release(std::size_t index) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_.push_back(index);
+        }
+
+    private:
+        std::mutex mutex_;
+        std::vector<std::size_t> free_;
+        std::size_t next_ = 0;
+    };
+
+    // Every thread counts into its own cache line with a plain load and store (it is the only
+    // writer), so an increment never touches a line other threads write. The per-thread slots
+    // are registered with the counter, and Load() sums them: a scrape sees every increment,
+    // whether or not the thread has incremented since. A thread's count moves into the shared
+    // base when the thread exits.
+    // Load() and Reset() lock and walk the slots, so they cost O(threads) and may throw.
+    class PerThreadCounter {
+    public:
+        explicit PerThreadCounter(unsigned long long start = 0)
+            : shared_(std::make_shared<Shared>(start))
+            , index_(Indices().Acquire())
+        {}
+
+        ~PerThreadCounter() {
+            Indices().Release(index_);
+        }
+
+        PerThreadCounter(const PerThreadCounter& other) = delete;
+        PerThreadCounter& operator=(const PerThreadCounter& other) = delete;
+
+        void Add(unsigned long long delta) {
+            std::atomic<unsigned long long>& count = LocalFor().slot->count;
+            count.store(count.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        }
+
+        unsigned long long Load() const {
+            std::lock_guard<std::mutex> lock(shared_->mutex);
+            return shared_->base + shared_->SumSlots();
+        }
+
+        // Increments racing it land on either side.
+        void Reset() {
+            std::lock_guard<std::mutex> lock(shared_->mutex);
+            // Slots belong to their threads; the base cancels what they hold so far.
+            shared_->base = 0 - shared_->SumSlots();
+        }
+
+    private:
+        struct alignas(64) Slot {
+            std::atomic<unsigned long long> count{0};
+        };
+
+        // Outlives the counter while some thread still has a slot in it.
+        struct Shared {
+            explicit Shared(unsigned long long start) : base(start) {}
+
+            // Called under mutex. Wraps around like the counter: base may be "negative".
+            unsigned long long SumSlots() const noexcept {
+                unsigned long long sum = 0;
+                for (const Slot* slot : slots) {
+                    sum += slot->count.load(std::memory_order_relaxed);
+                }
+                return sum;
+            }
+
+            std::mutex mutex;
+            // Counts of exited threads, minus the slots' counts at the last Reset().
+            unsigned long long base;
+            std::vector<Slot*> slots;
+        };
+
+        // One per thread and counter.
+        struct Local {
+            std::shared_ptr<Shared> shared;
+            std::unique_ptr<Slot> slot;
+
+            // Moves the thread's count into the base.
+            void Detach() {
+                std::lock_guard<std::mutex> lock(shared->mutex);
+                shared->base += slot->count.load(std::memory_order_relaxed);
+                std::erase(shared->slots, slot.get());
+                slot.reset();
+                shared.reset();
+            }
+        };
+
+        struct ThreadLocals {
+            std::vector<Local> locals;
+
+            ~ThreadLocals() {
+                for (Local& local : locals) {
+                    if (local.shared) {
+                        local.Detach();
+                    }
+                }
+            }
+        };
+
+        // Never destroyed: static counters may be destroyed after it at exit.
+        static PerThreadIndexPool& Indices() {
+            static PerThreadIndexPool* pool = new PerThreadIndexPool();
+            return *pool;
+        }
+
+        Local& LocalFor() {
+            thread_local ThreadLocals thread_locals;
+            if (index_ < thread_locals.locals.size()) {
+                Local& local = thread_locals.locals[index_];
+                if (local.shared == shared_) {
+                    return local;
+                }
+            }
+            return Attach(thread_locals);
+        }
+
+        // First increment from this thread, or the index belonged to a destroyed counter.
+        Local& Attach(ThreadLocals& thread_locals) {
+            if (index_ >= thread_locals.locals.size()) {
+                thread_locals.locals.resize(index_ + 1);
+            }
+            Local& local = thread_locals.locals[index_];
+            if (local.shared) {
+                local.Detach();
+            }
+            local.shared = shared_;
+            local.slot = std::make_unique<Slot>();
+            std::lock_guard<std::mutex> lock(shared_->mutex);
+            shared_->slots.push_back(local.slot.get());
+            return local;
+        }
+
+        std::shared_ptr<Shared> shared_;
+        std::size_t index_;
+    };
+}
@@ -1,6 +1,13 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+
+#if defined(__GXX_RTTI) || defined(_CPPRTTI)
+#define METRICS_HAS_RTTI 1
+#else
+#define METRICS_HAS_RTTI 0
+#endif
 
 #if defined(__GNUC__) || defined(__clang__)
 #include <cxxabi.h>
@@ -20,4 +27,36 @@ inline std::string demangle(const char* name) {
 #else
     return std::string(name);
 #endif
-}
\ No newline at end of file
+}
+// Name of T at compile time, without RTTI: "Metrics::IncrementMetric".
+template <typename T>
+constexpr std::string_view TypeName() noexcept {
+#if defined(__clang__)
+    std::string_view name = __PRETTY_FUNCTION__;
+    std::string_view prefix = "T = ";
+    std::size_t start = name.find(prefix) + prefix.size();
+    return name.substr(start, name.rfind(']') - start);
+#elif defined(__GNUC__)
+    std::string_view name = __PRETTY_FUNCTION__;
+    std::string_view prefix = "T = ";
+    std::size_t start = name.find(prefix) + prefix.size();
+    return name.substr(start, name.find_first_of(";]", start) - start);
+#elif defined(_MSC_VER)
+    std::string_view name = __FUNCSIG__;
+    std::size_t start = name.find("TypeName<") + 9;
+    std::size_t end = name.rfind(">(");
+    name = name.substr(start, end - start);
+    for (std::string_view keyword : {"class ", "struct "}) {
+        if (name.starts_with(keyword)) {
+            return name.substr(keyword.size());
+        }
+    }
+    return name;
+#else
+    return "unknown";
+#endif
+}
+
+// One object per type: its address identifies T and it holds TypeName<T>().
+template <typename T>
+inline constexpr std::string_view kTypeName = TypeName<T>();
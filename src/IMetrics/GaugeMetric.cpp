@@ -0,0 +1,93 @@
+#include "GaugeMetric.h"
+
+#include <algorithm>
+
+using namespace Metrics;
+
+namespace {
+    std::atomic<unsigned long long> default_name_counter = 0;
+}
+
+std::string GaugeMetric::CreateDefaultName() {
+    return "\"GaugeMetric " + std::to_string(++default_name_counter) + "\"";
+}
+
+GaugeMetric::GaugeMetric(const std::string& name, double initial)
+    : name_(name)
+    , value_(initial)
+    , min_(initial)
+    , max_(initial)
+    , integral_(0.0)
+    , last_change_(Now())
+    , interval_start_(last_change_.load())
+    , reported_value_(initial)
+    , reported_min_(initial)
+    , reported_max_(initial)
+    , reported_average_(initial)
+{}
+
+std::string GaugeMetric::GetName() const noexcept {
+    return name_;
+}
+
+std::string GaugeMetric::GetValueAsString() const {
+    std::string value;
+    AppendValue(value);
+    return value;
+}
+
+void GaugeMetric::AppendName(OutputBuffer& out) const {
+    out += name_;
+}
+
+void GaugeMetric::AppendValue(OutputBuffer& out) const {
+    Stats stats = LastInterval();
+    Format::AppendFixed(out, stats.value, 2);
+    out += " (min: ";
+    Format::AppendFixed(out, stats.min, 2);
+    out += ", max: ";
+    Format::AppendFixed(out, stats.max, 2);
+    out += ", avg: ";
+    Format::AppendFixed(out, stats.average, 2);
+    out += ')';
+}
+
+MetricSnapshot GaugeMetric::GetSnapshot() const {
+    return Snapshot::Gauge{reported_value_.load()};
+}
+
+GaugeMetric::Stats GaugeMetric::LastInterval() const noexcept {
+    return {reported_value_.load(), reported_min_.load(), reported_max_.load(), reported_average_.load()};
+}
+
+void GaugeMetric::Evaluate() {
+    std::int64_t now = Now();
+    double value = value_.load();
+
+    // Close the interval: the value has held since the last change, and the next interval
+    // starts with it as both min and max.
+    std::int64_t since = last_change_.exchange(now, std::memory_order_relaxed);
+    double integral = integral_.exchange(0.0, std::memory_order_relaxed);
+    if (now > since) {
+        integral += value * static_cast<double>(now - since);
+    }
+    std::int64_t start = interval_start_.exchange(now, std::memory_order_relaxed);
+
+    reported_value_ = value;
+    reported_min_ = std::min(min_.exchange(value, std::memory_order_relaxed), value);
+    reported_max_ = std::max(max_.exchange(value, std::memory_order_relaxed), value);
+    reported_average_ = now > start ? integral / static_cast<double>(now - start) : value;
+}
+
+void GaugeMetric::Reset() {
+    // MetricsManager resets after every scrape, so the value stays: an Add() and its Sub()
+    // may fall into different intervals. Only the interval restarts, at the current value; the
+    // last Evaluate() stays reported.
+    std::int64_t now = Now();
+    double value = value_.load();
+    min_ = value;
+    max_ = value;
+    integral_ = 0.0;
+    last_change_ = now;
+    interval_start_ = now;
+}
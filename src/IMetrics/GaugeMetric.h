@@ -0,0 +1,103 @@
+#pragma once
+
+#include "IMetrics.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace Metrics {
+    // A value that goes up and down: queue length, pool occupancy, requests in flight.
+    // Set/Add/Sub are lock-free. Every Evaluate() closes an interval and reports the current
+    // value, the min and max seen in the interval and the time-weighted average over it.
+    // Reset() restarts the interval but keeps the value. Like IncrementMetric it has no tag:
+    // what it measures depends on the caller.
+    class GaugeMetric final : public IMetric {
+    private:
+        static std::string CreateDefaultName();
+
+    public:
+        struct Stats {
+            double value = 0.0;
+            double min = 0.0;
+            double max = 0.0;
+            double average = 0.0;
+        };
+
+        GaugeMetric(const std::string& name=CreateDefaultName(), double initial=0.0);
+        std::string GetName() const noexcept override;
+        std::string GetValueAsString() const override;
+        void AppendName(OutputBuffer& out) const override;
+        void AppendValue(OutputBuffer& out) const override;
+        MetricSnapshot GetSnapshot() const override;
+        void Evaluate() override;
+        void Reset() override;
+
+        void Set(double value) noexcept {
+            Update(value_.exchange(value), value);
+        }
+
+        void Add(double delta) noexcept {
+            double old_value = value_.load(std::memory_order_relaxed);
+            while (!value_.compare_exchange_weak(old_value, old_value + delta)) {}
+            Update(old_value, old_value + delta);
+        }
+
+        void Sub(double delta) noexcept {
+            Add(-delta);
+        }
+
+        // The current value, not the one of the last Evaluate().
+        double Value() const noexcept {
+            return value_.load();
+        }
+
+        // What the last Evaluate() measured.
+        Stats LastInterval() const noexcept;
+
+    private:
+        static std::int64_t Now() noexcept {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        static void StoreMin(std::atomic<double>& target, double value) noexcept {
+            double current = target.load(std::memory_order_relaxed);
+            while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+        }
+
+        static void StoreMax(std::atomic<double>& target, double value) noexcept {
+            double current = target.load(std::memory_order_relaxed);
+            while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+        }
+
+        // old_value held from the previous change until now; two racing updates may attribute
+        // the few nanoseconds between them to each other's value.
+        void Update(double old_value, double new_value) noexcept {
+            std::int64_t now = Now();
+            std::int64_t since = last_change_.exchange(now, std::memory_order_relaxed);
+            if (now > since) {
+                integral_.fetch_add(old_value * static_cast<double>(now - since), std::memory_order_relaxed);
+            }
+            StoreMin(min_, new_value);
+            StoreMax(max_, new_value);
+        }
+
+        std::string name_;
+        std::atomic<double> value_;
+
+        // Current interval.
+        std::atomic<double> min_;
+        std::atomic<double> max_;
+        std::atomic<double> integral_;
+        std::atomic<std::int64_t> last_change_;
+        std::atomic<std::int64_t> interval_start_;
+
+        // Last Evaluate().
+        std::atomic<double> reported_value_;
+        std::atomic<double> reported_min_;
+        std::atomic<double> reported_max_;
+        std::atomic<double> reported_average_;
+    };
+}
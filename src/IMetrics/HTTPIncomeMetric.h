@@ -1,24 +1,158 @@
 #pragma once
 
 #include "IMetrics.h"
+#include "RateWindow.h"
+#include "Demangle.h"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
 
 namespace Metrics {
-    class HTTPIncomeMetric final : public IMetric, public MetricTags::ServerMetricTag {
-    private:
-        std::atomic<unsigned long long> counter_;
-        std::atomic<double> current_rps_value_;
-        std::atomic<unsigned long long> last_evaluated_counter_;
-        
+    // Requests per second measured against steady-clock time, so the value doesn't depend on how
+    // often the metric is scraped. The logged value is the rate over the last complete second;
+    // GetRates() also has the 10 and 60-second windows and the 1/5/15-minute EWMAs.
+    // The EWMAs take seconds from a 64-second ring: scrape at least once a minute, older seconds
+    // count as idle. Reset() keeps all of it, so scrapes by MetricsManager don't disturb it.
+    // Clock - where the time comes from, a type with a static noexcept now() returning a
+    // std::chrono::steady_clock::time_point. It is a template parameter so that ++ calls
+    // steady_clock::now() directly; tests pass a fake clock.
+    template <typename Clock = std::chrono::steady_clock>
+    class BasicHTTPIncomeMetric final : public IMetric, public MetricTags::ServerMetricTag {
     public:
-        HTTPIncomeMetric(unsigned long long start=0);
+        BasicHTTPIncomeMetric();
+        [[deprecated("start is ignored: the rate counts requests from construction on")]]
+        explicit BasicHTTPIncomeMetric(unsigned long long start);
         std::string GetName() const noexcept override;
         std::string GetValueAsString() const override;
-        void Evaluate() noexcept override;
-        void Reset() noexcept override;
-        
-        HTTPIncomeMetric& operator++(int) noexcept;
-        HTTPIncomeMetric& operator++() noexcept;
-    };   
-}
\ No newline at end of file
+        void AppendName(OutputBuffer& out) const override;
+        void AppendValue(OutputBuffer& out) const override;
+        MetricSnapshot GetSnapshot() const override;
+        void Evaluate() override;
+        void Reset() override;
+        std::string_view GetUnit() const noexcept override { return "rps"; }
+
+        // As of the last Evaluate().
+        Rates GetRates() const;
+
+        BasicHTTPIncomeMetric& operator++(int) noexcept {
+            return ++(*this);
+        }
+
+        BasicHTTPIncomeMetric& operator++() noexcept {
+            counts_.Add(SecondOf(Clock::now()));
+            return *this;
+        }
+
+    private:
+        PerSecondCounts counts_;
+        std::atomic<double> current_rps_value_;
+
+        // Evaluate() state.
+        std::int64_t start_second_;
+        // Seconds before it are already in averages_.
+        std::int64_t averaged_second_;
+        ExponentialRates averages_;
+        Rates rates_;
+        mutable std::mutex mutex_;
+    };
+
+    using HTTPIncomeMetric = BasicHTTPIncomeMetric<>;
+
+    template <typename Clock>
+    BasicHTTPIncomeMetric<Clock>::BasicHTTPIncomeMetric()
+        : current_rps_value_(0.0)
+        , start_second_(SecondOf(Clock::now()))
+        , averaged_second_(start_second_)
+    {}
+
+    template <typename Clock>
+    BasicHTTPIncomeMetric<Clock>::BasicHTTPIncomeMetric(unsigned long long)
+        : BasicHTTPIncomeMetric()
+    {}
+
+    template <typename Clock>
+    std::string BasicHTTPIncomeMetric<Clock>::GetName() const noexcept {
+        return "\"HTTPS requests RPS\"";
+    }
+
+    template <typename Clock>
+    std::string BasicHTTPIncomeMetric<Clock>::GetValueAsString() const {
+        std::string value;
+        AppendValue(value);
+        return value;
+    }
+
+    template <typename Clock>
+    void BasicHTTPIncomeMetric<Clock>::AppendName(OutputBuffer& out) const {
+        out += "\"HTTPS requests RPS\"";
+    }
+
+    template <typename Clock>
+    void BasicHTTPIncomeMetric<Clock>::AppendValue(OutputBuffer& out) const {
+        Format::AppendFixed(out, current_rps_value_.load(), 2);
+    }
+
+    template <typename Clock>
+    MetricSnapshot BasicHTTPIncomeMetric<Clock>::GetSnapshot() const {
+        return Snapshot::Gauge{current_rps_value_.load()};
+    }
+
+    template <typename Clock>
+    Rates BasicHTTPIncomeMetric<Clock>::GetRates() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return rates_;
+    }
+
+    template <typename Clock>
+    void BasicHTTPIncomeMetric<Clock>::Evaluate() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Only complete seconds count: the current one is still filling up.
+        std::int64_t now = SecondOf(Clock::now());
+        std::int64_t elapsed = now - start_second_;
+
+        auto window = [&](std::int64_t seconds) {
+            seconds = std::min(seconds, elapsed);
+            if (seconds <= 0) {
+                return 0.0;
+            }
+            unsigned long long requests = 0;
+            for (std::int64_t second = now - seconds; second < now; ++second) {
+                requests += counts_.Count(second);
+            }
+            return static_cast<double>(requests) / static_cast<double>(seconds);
+        };
+        rates_.last_1s = window(1);
+        rates_.last_10s = window(10);
+        rates_.last_60s = window(60);
+
+        // The bucket of `now - kSeconds` is already reused by `now`.
+        std::int64_t oldest = now - PerSecondCounts::kSeconds + 1;
+        if (averaged_second_ < oldest) {
+            averages_.Update(0.0, static_cast<double>(oldest - averaged_second_));
+            averaged_second_ = oldest;
+        }
+        for (; averaged_second_ < now; ++averaged_second_) {
+            averages_.Update(static_cast<double>(counts_.Count(averaged_second_)), 1.0);
+        }
+        rates_.ewma_1m = averages_.OneMinute();
+        rates_.ewma_5m = averages_.FiveMinutes();
+        rates_.ewma_15m = averages_.FifteenMinutes();
+
+        current_rps_value_ = rates_.last_1s;
+    }
+
+    // MetricsManager resets after every scrape, so the window and the EWMAs stay: they are
+    // measured against the clock, not per scrape, and there are no lifetime totals to clear.
+    template <typename Clock>
+    void BasicHTTPIncomeMetric<Clock>::Reset() {}
+
+    // Defined in HTTPIncomeMetric.cpp.
+    extern template class BasicHTTPIncomeMetric<std::chrono::steady_clock>;
+}
+
+// Keeps the log metadata name of the default instantiation.
+template <>
+inline constexpr std::string_view kTypeName<Metrics::HTTPIncomeMetric> = "Metrics::HTTPIncomeMetric";
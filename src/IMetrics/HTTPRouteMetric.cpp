@@ -0,0 +1,158 @@
+#include "HTTPRouteMetric.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace Metrics;
+
+namespace {
+    std::atomic<unsigned long long> default_name_counter = 0;
+}
+
+RouteTable::RouteTable(std::initializer_list<std::string_view> routes) {
+    for (std::string_view route : routes) {
+        Register(route);
+    }
+}
+
+RouteId RouteTable::Register(std::string_view route) {
+    auto [it, inserted] = ids_.try_emplace(std::string(route), names_.size());
+    if (inserted) {
+        names_.push_back(it->first);
+    }
+    return it->second;
+}
+
+RouteId RouteTable::Find(std::string_view route) const {
+    auto it = ids_.find(std::string(route));
+    if (it == ids_.end()) {
+        throw std::out_of_range("Unknown route: " + std::string(route));
+    }
+    return it->second;
+}
+
+const std::string& RouteTable::Name(RouteId route) const {
+    return names_.at(route);
+}
+
+std::string HTTPRouteMetric::CreateDefaultName() {
+    return "\"HTTPRouteMetric " + std::to_string(++default_name_counter) + "\"";
+}
+
+HTTPRouteMetric::HTTPRouteMetric(RouteTable routes, const std::string& name, SteadyClock clock)
+    : routes_(std::move(routes))
+    , name_(name)
+    , clock_(clock)
+    , stripe_mask_(CpuStripeCount() - 1)
+    , stripe_cells_((Cells() + kCellsPerLine - 1) / kCellsPerLine * kCellsPerLine)
+    , lines_(std::make_unique<Line[]>(CpuStripeCount() * stripe_cells_ / kCellsPerLine))
+    , last_evaluate_(clock_())
+    , interval_(Cells(), 0)
+    , averages_(Cells())
+    , rates_(Cells())
+{}
+
+std::string HTTPRouteMetric::GetName() const noexcept {
+    return name_;
+}
+
+std::string HTTPRouteMetric::GetValueAsString() const {
+    std::string value;
+    AppendValue(value);
+    return value;
+}
+
+void HTTPRouteMetric::AppendName(OutputBuffer& out) const {
+    out += name_;
+}
+
+void HTTPRouteMetric::AppendLabel(OutputBuffer& out, std::size_t cell) const {
+    out += routes_.Name(cell / kStatusClasses);
+    out += ' ';
+    out += kStatusClassNames[cell % kStatusClasses];
+}
+
+// "<route> <status class>: <rps>" in route table order. A cell is left out only while it is idle:
+// a route without requests since Reset() stays in the log until its averages decay.
+void HTTPRouteMetric::AppendValue(OutputBuffer& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool first = true;
+    for (std::size_t cell = 0; cell < rates_.size(); ++cell) {
+        if (Idle(rates_[cell])) {
+            continue;
+        }
+        if (!first) {
+            out += ", ";
+        }
+        first = false;
+        AppendLabel(out, cell);
+        out += ": ";
+        Format::AppendFixed(out, rates_[cell].rps, 2);
+    }
+    if (first) {
+        out += "no requests";
+    }
+}
+
+MetricSnapshot HTTPRouteMetric::GetSnapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Snapshot::Breakdown breakdown;
+    for (std::size_t cell = 0; cell < rates_.size(); ++cell) {
+        const CellRates& rates = rates_[cell];
+        if (Idle(rates)) {
+            continue;
+        }
+        Snapshot::Breakdown::Cell& out = breakdown.cells.emplace_back();
+        AppendLabel(out.label, cell);
+        out.total = rates.total;
+        out.rate = rates.rps;
+        out.ewma_1m = rates.ewma_1m;
+        out.ewma_5m = rates.ewma_5m;
+        out.ewma_15m = rates.ewma_15m;
+    }
+    return breakdown;
+}
+
+HTTPRouteMetric::CellRates HTTPRouteMetric::GetRates(RouteId route, StatusClass status) const {
+    if (route >= routes_.Size()) {
+        throw std::out_of_range("Unknown route id: " + std::to_string(route));
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rates_[route * kStatusClasses + static_cast<std::size_t>(status)];
+}
+
+void HTTPRouteMetric::Evaluate() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = clock_();
+    double seconds = std::chrono::duration<double>(now - last_evaluate_).count();
+    last_evaluate_ = now;
+
+    // Stripe by stripe, so the scan walks memory in order. exchange() takes the counts, so
+    // increments that land after a cell is scanned count in the next interval.
+    std::fill(interval_.begin(), interval_.end(), 0);
+    for (std::size_t stripe = 0; stripe <= stripe_mask_; ++stripe) {
+        for (std::size_t cell = 0; cell < interval_.size(); ++cell) {
+            interval_[cell] += Cell(stripe, cell).exchange(0, std::memory_order_relaxed);
+        }
+    }
+
+    for (std::size_t cell = 0; cell < interval_.size(); ++cell) {
+        double requests = static_cast<double>(interval_[cell]);
+        CellRates& rates = rates_[cell];
+        rates.total += interval_[cell];
+        rates.rps = seconds > 0.0 ? requests / seconds : 0.0;
+        averages_[cell].Update(requests, seconds);
+        rates.ewma_1m = averages_[cell].OneMinute();
+        rates.ewma_5m = averages_[cell].FiveMinutes();
+        rates.ewma_15m = averages_[cell].FifteenMinutes();
+    }
+}
+
+// MetricsManager resets after every scrape: the rates and averages are measured against the
+// clock and stay, only the totals start over.
+void HTTPRouteMetric::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& rates : rates_) {
+        rates.total = 0;
+    }
+}
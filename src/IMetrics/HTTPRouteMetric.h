@@ -0,0 +1,149 @@
+#pragma once
+
+#include "IMetrics.h"
+#include "CounterEngine.h"
+#include "RateWindow.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Metrics {
+    using RouteId = std::size_t;
+
+    // Routes an HTTPRouteMetric breaks requests down by, registered before the metric is created.
+    // Requests then name the route by its id, so the increment path never looks a path up.
+    class RouteTable {
+    public:
+        RouteTable() = default;
+        RouteTable(std::initializer_list<std::string_view> routes);
+
+        // The id of an already registered route is returned again.
+        RouteId Register(std::string_view route);
+        // Throws std::out_of_range for an unknown route.
+        RouteId Find(std::string_view route) const;
+        const std::string& Name(RouteId route) const;
+
+        std::size_t Size() const noexcept {
+            return names_.size();
+        }
+
+    private:
+        std::vector<std::string> names_;
+        std::unordered_map<std::string, RouteId> ids_;
+    };
+
+    enum class StatusClass : std::uint8_t {
+        Informational,
+        Success,
+        Redirection,
+        ClientError,
+        ServerError,
+        // Not a valid HTTP status.
+        Other,
+    };
+
+    inline constexpr std::size_t kStatusClasses = 6;
+    inline constexpr std::array<std::string_view, kStatusClasses> kStatusClassNames = {"1xx", "2xx", "3xx", "4xx", "5xx", "other"};
+
+    constexpr StatusClass ClassOf(int status) noexcept {
+        return status >= 100 && status < 600 ? static_cast<StatusClass>(status / 100 - 1) : StatusClass::Other;
+    }
+
+    // Request rates by route and status class in one metric, instead of an HTTPIncomeMetric per
+    // combination. Counts live in a dense routes x status classes array, one copy per CPU
+    // (see CpuStripeCount()): an increment is one relaxed add to the calling CPU's copy, without
+    // hashing or locking. Every copy takes whole cache lines, so CPUs don't share lines; the
+    // memory is 8 bytes per cell and CPU.
+    // Evaluate() takes the counts out of the copies and turns them into per-cell rates over the
+    // steady-clock time since the previous Evaluate(). Reset() only clears the totals.
+    class HTTPRouteMetric final : public IMetric, public MetricTags::ServerMetricTag {
+    private:
+        static std::string CreateDefaultName();
+
+    public:
+        struct CellRates {
+            // Requests since construction or Reset().
+            unsigned long long total = 0;
+            // Since the previous Evaluate().
+            double rps = 0.0;
+            double ewma_1m = 0.0;
+            double ewma_5m = 0.0;
+            double ewma_15m = 0.0;
+        };
+
+        explicit HTTPRouteMetric(RouteTable routes, const std::string& name=CreateDefaultName(), SteadyClock clock=&SteadyNow);
+        std::string GetName() const noexcept override;
+        std::string GetValueAsString() const override;
+        void AppendName(OutputBuffer& out) const override;
+        void AppendValue(OutputBuffer& out) const override;
+        // The cells AppendValue() logs, labelled "<route> <status class>".
+        MetricSnapshot GetSnapshot() const override;
+        void Evaluate() override;
+        void Reset() override;
+        std::string_view GetUnit() const noexcept override { return "rps"; }
+
+        // Ids outside the route table are not counted.
+        void Increment(RouteId route, int status) noexcept {
+            if (route >= routes_.Size()) {
+                return;
+            }
+            std::size_t stripe = CurrentCpuStripe() & stripe_mask_;
+            std::size_t cell = route * kStatusClasses + static_cast<std::size_t>(ClassOf(status));
+            Cell(stripe, cell).fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // As of the last Evaluate().
+        CellRates GetRates(RouteId route, StatusClass status) const;
+
+        const RouteTable& Routes() const noexcept {
+            return routes_;
+        }
+
+    private:
+        static constexpr std::size_t kCellsPerLine = 64 / sizeof(std::atomic<unsigned long long>);
+
+        struct alignas(64) Line {
+            std::array<std::atomic<unsigned long long>, kCellsPerLine> cells{};
+        };
+
+        std::atomic<unsigned long long>& Cell(std::size_t stripe, std::size_t cell) const noexcept {
+            std::size_t index = stripe * stripe_cells_ + cell;
+            return lines_[index / kCellsPerLine].cells[index % kCellsPerLine];
+        }
+
+        std::size_t Cells() const noexcept {
+            return routes_.Size() * kStatusClasses;
+        }
+
+        // No requests since Reset() and the averages have decayed to zero.
+        static bool Idle(const CellRates& rates) noexcept {
+            return rates.total == 0 && rates.ewma_1m == 0.0 && rates.ewma_5m == 0.0 && rates.ewma_15m == 0.0;
+        }
+
+        void AppendLabel(OutputBuffer& out, std::size_t cell) const;
+
+        RouteTable routes_;
+        std::string name_;
+        SteadyClock clock_;
+        std::size_t stripe_mask_;
+        // Cells per stripe, rounded up to whole lines.
+        std::size_t stripe_cells_;
+        std::unique_ptr<Line[]> lines_;
+
+        // Evaluate() state, one entry per cell. interval_ is scratch space for the scan.
+        std::chrono::steady_clock::time_point last_evaluate_;
+        std::vector<unsigned long long> interval_;
+        std::vector<ExponentialRates> averages_;
+        std::vector<CellRates> rates_;
+        mutable std::mutex mutex_;
+    };
+}
@@ -0,0 +1,120 @@
+#include "HistogramShards.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+using namespace Metrics;
+
+HistogramShards::Shared::Shared(std::int64_t lowest, std::int64_t highest, int significant_figures)
+    : lowest(lowest)
+    , highest(highest)
+    , significant_figures(significant_figures)
+    , collected(Create())
+    , spare(nullptr)
+{
+    try {
+        spare = Create();
+    } catch (...) {
+        hdr_close(collected);
+        throw;
+    }
+}
+
+HistogramShards::Shared::~Shared() {
+    hdr_close(collected);
+    hdr_close(spare);
+}
+
+hdr_histogram* HistogramShards::Shared::Create() const {
+    hdr_histogram* histogram = nullptr;
+    if (hdr_init(lowest, highest, significant_figures, &histogram) != 0) {
+        throw std::runtime_error("Error during histogram shard creation.");
+    }
+    return histogram;
+}
+
+// On the slot's own thread, so the shard isn't being recorded into.
+void HistogramShards::Shared::Retire(Slot* slot) {
+    hdr_histogram* shard = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        live.erase(std::find(live.begin(), live.end(), slot));
+        shard = slot->shard.load(std::memory_order_relaxed);
+        hdr_add(collected, shard);
+    }
+    hdr_close(shard);
+}
+
+void HistogramShards::Shared::Collect() {
+    for (Slot* slot : live) {
+        hdr_histogram* shard = slot->shard.load(std::memory_order_relaxed);
+        // Only swap while the thread isn't recording; it gives the shard back within one record.
+        while (shard == nullptr || !slot->shard.compare_exchange_weak(shard, spare, std::memory_order_acq_rel)) {
+            if (shard == nullptr) {
+                std::this_thread::yield();
+                shard = slot->shard.load(std::memory_order_relaxed);
+            }
+        }
+        hdr_add(collected, shard);
+        hdr_reset(shard);
+        spare = shard;
+    }
+}
+
+void HistogramShards::Local::Retire() {
+    shared->Retire(slot.get());
+    slot.reset();
+    shared.reset();
+}
+
+HistogramShards::ThreadLocals::~ThreadLocals() {
+    for (Local& local : locals) {
+        if (local.shared) {
+            local.Retire();
+        }
+    }
+}
+
+HistogramShards::HistogramShards(std::int64_t lowest, std::int64_t highest, int significant_figures)
+    : shared_(std::make_shared<Shared>(lowest, highest, significant_figures))
+    , index_(Indices().Acquire())
+{}
+
+HistogramShards::~HistogramShards() {
+    Indices().Release(index_);
+}
+
+HistogramShards::Slot& HistogramShards::Attach(ThreadLocals& thread_locals) {
+    if (index_ >= thread_locals.locals.size()) {
+        thread_locals.locals.resize(index_ + 1);
+    }
+    Local& local = thread_locals.locals[index_];
+    if (local.shared) {
+        local.Retire();
+    }
+    auto slot = std::make_unique<Slot>();
+    slot->shard.store(shared_->Create(), std::memory_order_relaxed);
+    try {
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        shared_->live.push_back(slot.get());
+    } catch (...) {
+        hdr_close(slot->shard.load(std::memory_order_relaxed));
+        throw;
+    }
+    local.shared = shared_;
+    local.slot = std::move(slot);
+    return *local.slot;
+}
+
+void HistogramShards::AddTo(hdr_histogram* to) const {
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    shared_->Collect();
+    hdr_add(to, shared_->collected);
+}
+
+void HistogramShards::Reset() {
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    shared_->Collect();
+    hdr_reset(shared_->collected);
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CounterEngine.h"
+
+#include <hdr/hdr_histogram.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Metrics {
+    // One hdr_histogram per recording thread, so threads record latencies without a shared lock.
+    // A thread's shard is created on its first Record() and lives as long as the thread: on
+    // exit it is added into a histogram of collected samples and closed.
+    // A scrape never reads a shard its thread may be writing. The thread holds the shard out of
+    // its slot while it records; the scrape swaps a spare shard into the slot and merges the
+    // old one, which is then its own, into the collected histogram. The scrape costs a hdr_add
+    // and a hdr_reset per live thread.
+    // A shard takes as much memory as a full histogram (for LatencyMetric's range about 270 KB
+    // at 3 significant figures, 37 KB at 2), per thread and metric.
+    class HistogramShards {
+    public:
+        HistogramShards(std::int64_t lowest, std::int64_t highest, int significant_figures);
+        ~HistogramShards();
+
+        HistogramShards(const HistogramShards& other) = delete;
+        HistogramShards& operator=(const HistogramShards& other) = delete;
+
+        void Record(std::int64_t value) {
+            Slot& slot = LocalSlot();
+            // Empty while recording, so a scrape waits instead of taking the shard.
+            hdr_histogram* shard = slot.shard.exchange(nullptr, std::memory_order_acquire);
+            hdr_record_value(shard, value);
+            slot.shard.store(shard, std::memory_order_release);
+        }
+
+        // Samples recorded while it runs may or may not be added.
+        void AddTo(hdr_histogram* to) const;
+
+        // Samples recorded while it runs may survive it.
+        void Reset();
+
+    private:
+        struct alignas(64) Slot {
+            std::atomic<hdr_histogram*> shard{nullptr};
+        };
+
+        // Outlives HistogramShards while some thread still has a shard of it.
+        struct Shared {
+            Shared(std::int64_t lowest, std::int64_t highest, int significant_figures);
+            ~Shared();
+
+            hdr_histogram* Create() const;
+            void Retire(Slot* slot);
+            // Moves the samples of live shards into collected. Under mutex.
+            void Collect();
+
+            std::int64_t lowest;
+            std::int64_t highest;
+            int significant_figures;
+            std::mutex mutex;
+            std::vector<Slot*> live;
+            hdr_histogram* collected;
+            // Empty shard swapped into the next slot Collect() takes.
+            hdr_histogram* spare;
+        };
+
+        // One per thread and HistogramShards.
+        struct Local {
+            std::shared_ptr<Shared> shared;
+            std::unique_ptr<Slot> slot;
+
+            void Retire();
+        };
+
+        struct ThreadLocals {
+            std::vector<Local> locals;
+
+            ~ThreadLocals();
+        };
+
+        Slot& LocalSlot() {
+            thread_local ThreadLocals thread_locals;
+            if (index_ < thread_locals.locals.size()) {
+                Local& local = thread_locals.locals[index_];
+                if (local.shared == shared_) {
+                    return *local.slot;
+                }
+            }
+            return Attach(thread_locals);
+        }
+
+        // Never destroyed: static metrics may be destroyed after it at exit.
+        static PerThreadIndexPool& Indices() {
+            static PerThreadIndexPool* pool = new PerThreadIndexPool();
+            return *pool;
+        }
+
+        // First record from this thread, or the index belonged to destroyed shards.
+        Slot& Attach(ThreadLocals& thread_locals);
+
+        std::shared_ptr<Shared> shared_;
+        std::size_t index_;
+    };
+}
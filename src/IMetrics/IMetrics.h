@@ -1,9 +1,13 @@
 #pragma once
 
+#include <chrono>
 #include <string>
+#include <string_view>
 #include <type_traits>
 
+#include "MetricSnapshot.h"
 #include "MetricsTags.h"
+#include "OutputBuffer.h"
 
 namespace Metrics {
     
@@ -16,6 +20,34 @@ namespace Metrics {
         virtual void Evaluate() = 0;
         virtual void Reset() = 0;
         
+        // Append the name / value to out, same text as GetName() / GetValueAsString(). Scrapes use
+        // these; built-in metrics implement them without heap allocations and their Get* methods
+        // wrap them.
+        virtual void AppendName(OutputBuffer& out) const {
+            out += GetName();
+        }
+        
+        virtual void AppendValue(OutputBuffer& out) const {
+            out += GetValueAsString();
+        }
+        
+        // The value as numbers, same state as GetValueAsString(). Metrics without a typed value
+        // return it as Snapshot::Text.
+        virtual MetricSnapshot GetSnapshot() const {
+            return Snapshot::Text{GetValueAsString()};
+        }
+        
+        // Scrapes that come sooner than this after the last Evaluate() reuse its result instead
+        // of evaluating the metric again (and don't reset it). Zero - evaluate on every scrape.
+        virtual std::chrono::nanoseconds MinEvaluateInterval() const noexcept {
+            return std::chrono::nanoseconds::zero();
+        }
+        
+        // Unit of the value, written to log metadata; empty if the value has none.
+        virtual std::string_view GetUnit() const noexcept {
+            return {};
+        }
+        
         IMetric(const IMetric& other) = delete;
         IMetric(IMetric&& other) = delete;
         
@@ -1,37 +1,60 @@
 #include "IncrementMetric.h"
 
+#include <atomic>
+
 using namespace Metrics;
 
-std::string IncrementMetric::CreateDefaultName() {
-    std::lock_guard<std::mutex> lock(counter_mutex_);
-    return "\"IncrementMetric " + std::to_string(++counter) + "\"";
+namespace {
+    // Shared by every engine, so default names stay unique.
+    std::atomic<unsigned long long> default_name_counter = 0;
+}
+
+template <CounterEngine Counter>
+std::string BasicIncrementMetric<Counter>::CreateDefaultName() {
+    return "\"IncrementMetric " + std::to_string(++default_name_counter) + "\"";
 }
 
-IncrementMetric::IncrementMetric(const std::string& name, unsigned long long start) 
+template <CounterEngine Counter>
+BasicIncrementMetric<Counter>::BasicIncrementMetric(const std::string& name, unsigned long long start) 
     : name_(name)
     , counter_(start)
 {}
 
-std::string IncrementMetric::GetName() const noexcept {
+template <CounterEngine Counter>
+std::string BasicIncrementMetric<Counter>::GetName() const noexcept {
     return name_;
 }
 
-std::string IncrementMetric::GetValueAsString() const noexcept {
-    return std::to_string(counter_);
+template <CounterEngine Counter>
+std::string BasicIncrementMetric<Counter>::GetValueAsString() const {
+    std::string value;
+    AppendValue(value);
+    return value;
 }
 
-void IncrementMetric::Evaluate() {}
+template <CounterEngine Counter>
+void BasicIncrementMetric<Counter>::AppendName(OutputBuffer& out) const {
+    out += name_;
+}
 
-void IncrementMetric::Reset() {
-    counter_ = 0;
+template <CounterEngine Counter>
+void BasicIncrementMetric<Counter>::AppendValue(OutputBuffer& out) const {
+    Format::AppendInteger(out, counter_.Load());
 }
 
-IncrementMetric& IncrementMetric::operator++() {
-    ++counter_;
-    
-    return *this;
+template <CounterEngine Counter>
+MetricSnapshot BasicIncrementMetric<Counter>::GetSnapshot() const {
+    return Snapshot::Counter{counter_.Load()};
+}
+
+template <CounterEngine Counter>
+void BasicIncrementMetric<Counter>::Evaluate() {}
+
+template <CounterEngine Counter>
+void BasicIncrementMetric<Counter>::Reset() {
+    counter_.Reset();
 }
 
-IncrementMetric& IncrementMetric::operator++(int) {
-    return ++(*this);
-}
\ No newline at end of file
+template class Metrics::BasicIncrementMetric<Metrics::AtomicCounter>;
+template class Metrics::BasicIncrementMetric<Metrics::StripedCounter>;
+template class Metrics::BasicIncrementMetric<Metrics::PerThreadCounter>;
@@ -1,30 +1,60 @@
 #pragma once
 
 #include "IMetrics.h"
+#include "CounterEngine.h"
+#include "Demangle.h"
 
-#include <atomic>
-#include <mutex>
 #include <string>
 
 namespace Metrics {
-    class IncrementMetric : public IMetric {
+    // Counter - how the count is stored, see CounterEngine.h.
+    template <CounterEngine Counter = AtomicCounter>
+    class BasicIncrementMetric final : public IMetric {
     private:
-        static inline std::atomic<unsigned long long> counter = 0;
-        static inline std::mutex counter_mutex_;
         static std::string CreateDefaultName();
         
     public:
-        IncrementMetric(const std::string& name=CreateDefaultName(), unsigned long long start=0);
+        BasicIncrementMetric(const std::string& name=CreateDefaultName(), unsigned long long start=0);
         std::string GetName() const noexcept override;
-        std::string GetValueAsString() const noexcept override;
+        // Not noexcept: PerThreadCounter::Load() takes a mutex.
+        std::string GetValueAsString() const override;
+        void AppendName(OutputBuffer& out) const override;
+        void AppendValue(OutputBuffer& out) const override;
+        MetricSnapshot GetSnapshot() const override;
         void Evaluate() override;
         void Reset() override;
         
-        IncrementMetric& operator++();
-        IncrementMetric& operator++(int);
+        BasicIncrementMetric& operator++() {
+            counter_.Add(1);
+            return *this;
+        }
+
+        BasicIncrementMetric& operator++(int) {
+            return ++(*this);
+        }
         
     private:
         std::string name_;
-        std::atomic<unsigned long long> counter_;
+        Counter counter_;
     };
-}
\ No newline at end of file
+
+    using IncrementMetric = BasicIncrementMetric<AtomicCounter>;
+    // For counters incremented from many cores at once.
+    using StripedIncrementMetric = BasicIncrementMetric<StripedCounter>;
+    // For counters incremented millions of times per second from a few long-lived threads;
+    // reading it locks and costs O(threads).
+    using PerThreadIncrementMetric = BasicIncrementMetric<PerThreadCounter>;
+
+    // Defined in IncrementMetric.cpp for the built-in engines.
+    extern template class BasicIncrementMetric<AtomicCounter>;
+    extern template class BasicIncrementMetric<StripedCounter>;
+    extern template class BasicIncrementMetric<PerThreadCounter>;
+}
+
+// Log metadata names of the aliases.
+template <>
+inline constexpr std::string_view kTypeName<Metrics::IncrementMetric> = "Metrics::IncrementMetric";
+template <>
+inline constexpr std::string_view kTypeName<Metrics::StripedIncrementMetric> = "Metrics::StripedIncrementMetric";
+template <>
+inline constexpr std::string_view kTypeName<Metrics::PerThreadIncrementMetric> = "Metrics::PerThreadIncrementMetric";
@@ -1,54 +1,88 @@
 #include "LatencyMetric.h"
 
 #include <mutex>
-#include <sstream>
 #include <stdexcept>
 
 using namespace Metrics;
 
-LatencyMetric::LatencyMetric() {
-    std::lock_guard<std::mutex> lock(mutex_);
+template <ThreadingPolicy Policy>
+BasicLatencyMetric<Policy>::BasicLatencyMetric(int significant_figures) {
+    std::lock_guard lock(mutex_);
     int64_t max_latency_ns = 3600000000000;
-    if (hdr_init(1, max_latency_ns, 3, &histogram_) != 0) {
+    if (hdr_init(1, max_latency_ns, significant_figures, &histogram_) != 0) {
         throw std::runtime_error("Error during LatencyMetric creation.");
     }
+    if constexpr (kSharded) {
+        try {
+            shards_.emplace(1, max_latency_ns, significant_figures);
+        } catch (...) {
+            hdr_close(histogram_);
+            throw;
+        }
+    }
 }
 
-LatencyMetric::~LatencyMetric() {
-    std::lock_guard<std::mutex> lock(mutex_);
+template <ThreadingPolicy Policy>
+BasicLatencyMetric<Policy>::~BasicLatencyMetric() {
+    std::lock_guard lock(mutex_);
     hdr_close(histogram_);
 }
 
-void LatencyMetric::Observe(std::chrono::nanoseconds latency) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    hdr_record_value(histogram_, latency.count());
+template <ThreadingPolicy Policy>
+std::string BasicLatencyMetric<Policy>::GetName() const noexcept {
+    return "\"Percentile Latency\"";
 }
 
-std::string LatencyMetric::GetName() const noexcept {
-    return "\"Percentile Latency\"";
+template <ThreadingPolicy Policy>
+std::string BasicLatencyMetric<Policy>::GetValueAsString() const {
+    std::string value;
+    AppendValue(value);
+    return value;
+}
+
+template <ThreadingPolicy Policy>
+void BasicLatencyMetric<Policy>::AppendName(OutputBuffer& out) const {
+    out += "\"Percentile Latency\"";
+}
+
+template <ThreadingPolicy Policy>
+void BasicLatencyMetric<Policy>::AppendValue(OutputBuffer& out) const {
+    Format::AppendPercentiles(out, Percentiles(), "ns");
 }
 
-std::string LatencyMetric::GetValueAsString() const {
-    double p90, p95, p99, p999;
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        p90 = hdr_value_at_percentile(histogram_, 90.0);
-        p95 = hdr_value_at_percentile(histogram_, 95.0);
-        p99 = hdr_value_at_percentile(histogram_, 99.0);
-        p999 = hdr_value_at_percentile(histogram_, 99.9);
+template <ThreadingPolicy Policy>
+MetricSnapshot BasicLatencyMetric<Policy>::GetSnapshot() const {
+    return Percentiles();
+}
+
+template <ThreadingPolicy Policy>
+Snapshot::Percentiles BasicLatencyMetric<Policy>::Percentiles() const {
+    std::lock_guard lock(mutex_);
+    if constexpr (kSharded) {
+        hdr_reset(histogram_);
+        shards_->AddTo(histogram_);
+    }
+    Snapshot::Percentiles percentiles;
+    for (size_t i = 0; i < percentiles.points.size(); ++i) {
+        double percentile = Snapshot::Percentiles::kPercentiles[i];
+        percentiles.points[i] = {percentile, static_cast<double>(hdr_value_at_percentile(histogram_, percentile))};
     }
-    
-    std::ostringstream oss;
-    oss << "P90: " << p90 << "ns, ";
-    oss << "P95: " << p95 << "ns, ";
-    oss << "P99: " << p99 << "ns, ";
-    oss << "P999: " << p999 << "ns";
-    return oss.str();
+    percentiles.count = static_cast<std::uint64_t>(histogram_->total_count);
+    return percentiles;
 }
 
-void LatencyMetric::Evaluate() {}
+template <ThreadingPolicy Policy>
+void BasicLatencyMetric<Policy>::Evaluate() {}
 
-void LatencyMetric::Reset() {
-    std::lock_guard<std::mutex> lock(mutex_);
+template <ThreadingPolicy Policy>
+void BasicLatencyMetric<Policy>::Reset() {
+    std::lock_guard lock(mutex_);
     hdr_reset(histogram_);
-}
\ No newline at end of file
+    if constexpr (kSharded) {
+        shards_->Reset();
+    }
+}
+
+template class Metrics::BasicLatencyMetric<Metrics::SingleThreadPolicy>;
+template class Metrics::BasicLatencyMetric<Metrics::MutexPolicy>;
+template class Metrics::BasicLatencyMetric<Metrics::SpinLockPolicy>;
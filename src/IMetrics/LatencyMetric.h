@@ -1,25 +1,67 @@
 #pragma once
 
 #include "IMetrics.h"
+#include "ThreadingPolicy.h"
+#include "HistogramShards.h"
+#include "Demangle.h"
 
 #include <hdr/hdr_histogram.h>
 #include <chrono>
 #include <mutex>
+#include <optional>
+#include <type_traits>
 
 namespace Metrics {
- class LatencyMetric final : public IMetric, public MetricTags::ComputerMetricTag {
+ // Policy - how Observe() and scrapes are synchronized, see ThreadingPolicy.h. With
+ // SingleThreadPolicy Observe() records straight into one histogram; with the thread-safe
+ // policies every thread records into its own shard (HistogramShards) without locking, and a
+ // scrape merges the shards under Policy::Mutex.
+ template <ThreadingPolicy Policy = MutexPolicy>
+ class BasicLatencyMetric final : public IMetric, public MetricTags::ComputerMetricTag {
  public:
-    LatencyMetric();
-    ~LatencyMetric() override;
+    static constexpr bool kThreadConfined = kThreadConfinedPolicy<Policy>;
+
+    // significant_figures - precision of the histogram and of every shard: 3 keeps percentiles
+    // within 0.1%, 2 within 1% with shards about 7 times smaller and cheaper to merge.
+    explicit BasicLatencyMetric(int significant_figures = 3);
+    ~BasicLatencyMetric() override;
     std::string GetName() const noexcept override;
     std::string GetValueAsString() const override;
+    void AppendName(OutputBuffer& out) const override;
+    void AppendValue(OutputBuffer& out) const override;
+    MetricSnapshot GetSnapshot() const override;
     void Evaluate() override;
     void Reset() override;
+    std::string_view GetUnit() const noexcept override { return "ns"; }
     
-    void Observe(std::chrono::nanoseconds latency);
+    void Observe(std::chrono::nanoseconds latency) {
+        if constexpr (kSharded) {
+            shards_->Record(latency.count());
+        } else {
+            hdr_record_value(histogram_, latency.count());
+        }
+    }
          
  private:
+    static constexpr bool kSharded = !kThreadConfined;
+
+    Snapshot::Percentiles Percentiles() const;
+    
+    // Sharded: the shards merged by the last scrape.
     hdr_histogram* histogram_;
-    mutable std::mutex mutex_;
+    std::optional<HistogramShards> shards_;
+    mutable typename Policy::Mutex mutex_;
  };
-} 
\ No newline at end of file
+
+ // Safe to share between threads; the type existing code uses.
+ using LatencyMetric = BasicLatencyMetric<MutexPolicy>;
+
+ // Defined in LatencyMetric.cpp for the built-in policies.
+ extern template class BasicLatencyMetric<SingleThreadPolicy>;
+ extern template class BasicLatencyMetric<MutexPolicy>;
+ extern template class BasicLatencyMetric<SpinLockPolicy>;
+}
+
+// Keeps the log metadata name of the default instantiation.
+template <>
+inline constexpr std::string_view kTypeName<Metrics::LatencyMetric> = "Metrics::LatencyMetric";
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace Metrics {
+    // Typed values of a metric, the numbers behind GetValueAsString(). The set of kinds is closed:
+    // a consumer handles every one of them with a single std::visit.
+    namespace Snapshot {
+        // Monotonic count, e.g. IncrementMetric.
+        struct Counter {
+            unsigned long long value = 0;
+        };
+
+        // Value measured at the last Evaluate(), in GetUnit() units: rps, %.
+        struct Gauge {
+            double value = 0.0;
+        };
+
+        // Latency distribution, values in GetUnit() units.
+        struct Percentiles {
+            struct Point {
+                double percentile = 0.0;
+                double value = 0.0;
+            };
+
+            static constexpr std::array<double, 4> kPercentiles = {90.0, 95.0, 99.0, 99.9};
+            // How GetValueAsString() names them.
+            static constexpr std::array<std::string_view, kPercentiles.size()> kLabels = {"P90", "P95", "P99", "P999"};
+
+            std::array<Point, kPercentiles.size()> points{};
+            std::uint64_t count = 0;
+        };
+
+        // Most frequent items of a cardinality metric, most frequent first.
+        struct TopN {
+            struct Item {
+                std::string label;
+                long long count = 0;
+            };
+
+            unsigned long long unique = 0;
+            std::vector<Item> items;
+        };
+
+        // Request rates broken down by label, e.g. HTTPRouteMetric: one cell per route and status
+        // class, rates in GetUnit() units.
+        struct Breakdown {
+            struct Cell {
+                std::string label;
+                unsigned long long total = 0;
+                double rate = 0.0;
+                double ewma_1m = 0.0;
+                double ewma_5m = 0.0;
+                double ewma_15m = 0.0;
+            };
+
+            std::vector<Cell> cells;
+        };
+
+        // Measured time span, e.g. CodeTimeMetric.
+        struct Duration {
+            std::chrono::nanoseconds value{0};
+        };
+
+        // Metrics that don't provide a typed value: their GetValueAsString().
+        struct Text {
+            std::string value;
+        };
+    }
+
+    using MetricSnapshot = std::variant<Snapshot::Counter, Snapshot::Gauge, Snapshot::Percentiles,
+                                        Snapshot::TopN, Snapshot::Breakdown, Snapshot::Duration,
+                                        Snapshot::Text>;
+
+    // Builds a visitor out of lambdas, one per snapshot kind:
+    //   std::visit(SnapshotVisitor{
+    //       [](const Snapshot::Counter& counter) { ... },
+    //       [](const auto& other) { ... },
+    //   }, metric.GetSnapshot());
+    template <typename... Handlers>
+    struct SnapshotVisitor : Handlers... {
+        using Handlers::operator()...;
+    };
+
+    template <typename... Handlers>
+    SnapshotVisitor(Handlers...) -> SnapshotVisitor<Handlers...>;
+
+    struct NamedSnapshot {
+        std::string name;
+        MetricSnapshot value;
+    };
+}
@@ -5,6 +5,10 @@
 #include "CodeTimeMetric.h"
 #include "CPUUsageMetric.h"
 #include "CPUUtilMetric.h"
+#include "GaugeMetric.h"
 #include "HTTPIncomeMetric.h"
+#include "HTTPRouteMetric.h"
 #include "IncrementMetric.h"
-#include "LatencyMetric.h"
\ No newline at end of file
+#include "LatencyMetric.h"
+#include "RequestMetric.h"
+#include "SharedMetrics.h"
\ No newline at end of file
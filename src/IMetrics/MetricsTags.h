@@ -1,11 +1,176 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
 namespace MetricTags {
-    struct DefaultMetricTag {};
-    
-    struct AlgoMetricTag : DefaultMetricTag {};
-    
-    struct ComputerMetricTag : DefaultMetricTag {};
-    
-    struct ServerMetricTag : DefaultMetricTag {};
-}
\ No newline at end of file
+    // Set of tags as bits. A metric's tags are known at compile time (kTagsOf), so filtering a
+    // scrape is a mask AND instead of a dynamic_cast per metric.
+    using TagMask = std::uint64_t;
+
+    // Every metric has it; it has no bit and matches everything.
+    struct DefaultMetricTag {
+        static constexpr TagMask kTagMask = 0;
+    };
+
+    struct AlgoMetricTag : DefaultMetricTag {
+        static constexpr TagMask kTagMask = TagMask{1} << 2;
+    };
+
+    struct ComputerMetricTag : DefaultMetricTag {
+        static constexpr TagMask kTagMask = TagMask{1} << 1;
+    };
+
+    struct ServerMetricTag : DefaultMetricTag {
+        static constexpr TagMask kTagMask = TagMask{1} << 0;
+    };
+
+    inline constexpr std::size_t kBuiltinTagCount = 3;
+    inline constexpr std::size_t kMaxUserTags = 64 - kBuiltinTagCount;
+
+    // Registers a user-defined tag under its own Index; metrics inherit the tag as usual:
+    //   using QueueMetricTag = MetricTags::UserTag<0>;
+    //   class QueueDepth : public Metrics::IMetric, public QueueMetricTag { ... };
+    template <std::size_t Index>
+    requires (Index < kMaxUserTags)
+    struct UserTag : DefaultMetricTag {
+        static constexpr TagMask kTagMask = TagMask{1} << (kBuiltinTagCount + Index);
+    };
+
+    // Tags a metric class inherits.
+    template <typename T>
+    inline constexpr TagMask kTagsOf = [] {
+        TagMask mask = 0;
+        if constexpr (std::is_base_of_v<ServerMetricTag, T>) mask |= ServerMetricTag::kTagMask;
+        if constexpr (std::is_base_of_v<ComputerMetricTag, T>) mask |= ComputerMetricTag::kTagMask;
+        if constexpr (std::is_base_of_v<AlgoMetricTag, T>) mask |= AlgoMetricTag::kTagMask;
+        [&mask]<std::size_t... Index>(std::index_sequence<Index...>) {
+            ((mask |= std::is_base_of_v<UserTag<Index>, T> ? UserTag<Index>::kTagMask : 0), ...);
+        }(std::make_index_sequence<kMaxUserTags>{});
+        return mask;
+    }();
+
+    // Whether T merely inherits the bit of a tag it derives from, like
+    // struct MyTag : ServerMetricTag {}, which would select every server metric.
+    template <typename T, typename Base>
+    inline constexpr bool kSharesTagMask = !std::is_same_v<T, Base> && std::is_base_of_v<Base, T>
+                                           && T::kTagMask == Base::kTagMask;
+
+    template <typename T>
+    inline constexpr bool kHasOwnTagMask = [] {
+        bool shared = kSharesTagMask<T, DefaultMetricTag> || kSharesTagMask<T, ServerMetricTag>
+                      || kSharesTagMask<T, ComputerMetricTag> || kSharesTagMask<T, AlgoMetricTag>;
+        [&shared]<std::size_t... Index>(std::index_sequence<Index...>) {
+            shared = shared || (kSharesTagMask<T, UserTag<Index>> || ...);
+        }(std::make_index_sequence<kMaxUserTags>{});
+        return !shared;
+    }();
+
+    // A tag is an empty struct with a bit of its own, which metrics deriving from it get in
+    // kTagsOf: the built-in tags and UserTag<Index>. DefaultMetricTag has no bit and is not one;
+    // a struct derived from a tag without a new registered bit isn't either.
+    template <typename T>
+    concept Tag = std::is_base_of_v<DefaultMetricTag, T> && std::is_empty_v<T>
+                  && T::kTagMask != 0 && kHasOwnTagMask<T> && kTagsOf<T> == T::kTagMask;
+
+    template <Tag... Tags>
+    constexpr TagMask MaskOf() noexcept {
+        return (TagMask{0} | ... | Tags::kTagMask);
+    }
+
+    // Metrics a scrape selects: all tags of `all`, at least one tag of every non-empty `any`
+    // group and none of `none`.
+    struct TagFilter {
+        static constexpr std::size_t kMaxAnyGroups = 4;
+
+        TagMask all = 0;
+        std::array<TagMask, kMaxAnyGroups> any{};
+        TagMask none = 0;
+
+        constexpr bool Matches(TagMask tags) const noexcept {
+            if ((tags & all) != all || (tags & none) != 0) {
+                return false;
+            }
+            for (TagMask group : any) {
+                if (group != 0 && (tags & group) == 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Both filters must match, so AnyOf<A>() & AnyOf<B>() needs A and B. A group that
+        // contains another is dropped: the smaller one already requires it. Throws
+        // std::length_error past kMaxAnyGroups groups.
+        friend constexpr TagFilter operator&(const TagFilter& lhs, const TagFilter& rhs) {
+            TagFilter result{lhs.all | rhs.all, lhs.any, lhs.none | rhs.none};
+            for (TagMask group : rhs.any) {
+                result.AddAnyGroup(group);
+            }
+            return result;
+        }
+
+    private:
+        constexpr void AddAnyGroup(TagMask group) {
+            if (group == 0) {
+                return;
+            }
+            for (TagMask& existing : any) {
+                if (existing != 0 && (existing & group) == existing) {
+                    return;
+                }
+            }
+            for (TagMask& existing : any) {
+                if ((group & existing) == group) {
+                    existing = 0;
+                }
+            }
+            for (TagMask& existing : any) {
+                if (existing == 0) {
+                    existing = group;
+                    return;
+                }
+            }
+            throw std::length_error("TagFilter: too many AnyOf groups");
+        }
+    };
+
+    template <Tag... Tags>
+    constexpr TagFilter AllOf() noexcept {
+        return {MaskOf<Tags...>(), {}, 0};
+    }
+
+    template <Tag... Tags>
+    constexpr TagFilter AnyOf() noexcept {
+        return {0, {MaskOf<Tags...>()}, 0};
+    }
+
+    template <Tag... Tags>
+    constexpr TagFilter NoneOf() noexcept {
+        return {0, {}, MaskOf<Tags...>()};
+    }
+
+    // "server,computer,algo" for the log metadata; user tags are named "user<Index>".
+    inline std::string TagNames(TagMask tags) {
+        std::string names;
+        auto add = [&names](std::string_view name) {
+            names += names.empty() ? "" : ",";
+            names += name;
+        };
+        if (tags & ServerMetricTag::kTagMask) add("server");
+        if (tags & ComputerMetricTag::kTagMask) add("computer");
+        if (tags & AlgoMetricTag::kTagMask) add("algo");
+        for (std::size_t index = 0; index < kMaxUserTags; ++index) {
+            if (tags & (TagMask{1} << (kBuiltinTagCount + index))) {
+                add("user" + std::to_string(index));
+            }
+        }
+        return names;
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "MetricSnapshot.h"
+
+#include <charconv>
+#include <concepts>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace Metrics {
+    // Caller-owned text buffer that IMetric::AppendName/AppendValue write into. A buffer reused
+    // across scrapes stops allocating once its capacity has grown to a scrape's size.
+    using OutputBuffer = std::string;
+
+    // std::to_chars based formatting, without streams or temporary strings.
+    namespace Format {
+        template <std::integral T>
+        void AppendInteger(OutputBuffer& out, T value) {
+            char digits[std::numeric_limits<T>::digits10 + 3];
+            auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            out.append(digits, result.ptr);
+        }
+
+        // Same text as `stream << std::fixed << std::setprecision(precision) << value`.
+        inline void AppendFixed(OutputBuffer& out, double value, int precision) {
+            char digits[std::numeric_limits<double>::max_exponent10 + std::numeric_limits<double>::max_digits10 + 8];
+            auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, precision);
+            out.append(digits, result.ptr);
+        }
+
+        // Same text as `stream << value` with the default stream precision of 6.
+        inline void AppendGeneral(OutputBuffer& out, double value) {
+            char digits[32];
+            auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::general, 6);
+            out.append(digits, result.ptr);
+        }
+
+        // "P90: <value><unit>, P95: ..., P999: <value><unit>".
+        inline void AppendPercentiles(OutputBuffer& out, const Snapshot::Percentiles& percentiles, std::string_view unit) {
+            for (std::size_t i = 0; i < percentiles.points.size(); ++i) {
+                if (i != 0) {
+                    out += ", ";
+                }
+                out += Snapshot::Percentiles::kLabels[i];
+                out += ": ";
+                AppendGeneral(out, percentiles.points[i].value);
+                out += unit;
+            }
+        }
+    }
+}
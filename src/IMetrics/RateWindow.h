@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+namespace Metrics {
+    // Where rate metrics take the time from; tests pass a fake clock.
+    using SteadyClock = std::chrono::steady_clock::time_point (*)() noexcept;
+
+    inline std::chrono::steady_clock::time_point SteadyNow() noexcept {
+        return std::chrono::steady_clock::now();
+    }
+
+    inline std::int64_t SecondOf(std::chrono::steady_clock::time_point time) noexcept {
+        return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+    }
+
+    // Requests per second over the last complete 1, 10 and 60 seconds, and exponentially
+    // weighted 1, 5 and 15-minute rates, like load averages.
+    struct Rates {
+        double last_1s = 0.0;
+        double last_10s = 0.0;
+        double last_60s = 0.0;
+        double ewma_1m = 0.0;
+        double ewma_5m = 0.0;
+        double ewma_15m = 0.0;
+    };
+
+    class ExponentialRates {
+    public:
+        // count events spread evenly over the given number of seconds.
+        void Update(double count, double seconds) noexcept {
+            if (seconds <= 0.0) {
+                return;
+            }
+            double rate = count / seconds;
+            for (std::size_t i = 0; i < kPeriods.size(); ++i) {
+                rates_[i] = rate + (rates_[i] - rate) * std::exp(-seconds / kPeriods[i]);
+            }
+        }
+
+        void Reset() noexcept {
+            rates_ = {};
+        }
+
+        double OneMinute() const noexcept { return rates_[0]; }
+        double FiveMinutes() const noexcept { return rates_[1]; }
+        double FifteenMinutes() const noexcept { return rates_[2]; }
+
+    private:
+        static constexpr std::array<double, 3> kPeriods = {60.0, 300.0, 900.0};
+
+        std::array<double, kPeriods.size()> rates_{};
+    };
+
+    // Event counts of the last kSeconds seconds, one bucket per second. Add() is lock-free: a
+    // bucket keeps the second it counts in its high bits, and the first Add() of a new second
+    // takes the bucket over with a CAS.
+    class PerSecondCounts {
+    public:
+        static constexpr std::int64_t kSeconds = 64;
+
+        void Add(std::int64_t second, unsigned long long count = 1) noexcept {
+            auto& bucket = buckets_[static_cast<std::size_t>(second) % kSeconds];
+            std::uint64_t tag = Tag(second);
+            std::uint64_t value = bucket.load(std::memory_order_relaxed);
+            while (true) {
+                if ((value >> kCountBits) == tag) {
+                    bucket.fetch_add(count, std::memory_order_relaxed);
+                    return;
+                }
+                if (bucket.compare_exchange_weak(value, (tag << kCountBits) | count, std::memory_order_relaxed)) {
+                    return;
+                }
+            }
+        }
+
+        // Zero for seconds the bucket no longer (or doesn't yet) hold.
+        unsigned long long Count(std::int64_t second) const noexcept {
+            std::uint64_t value = buckets_[static_cast<std::size_t>(second) % kSeconds].load(std::memory_order_relaxed);
+            return (value >> kCountBits) == Tag(second) ? value & kCountMask : 0;
+        }
+
+        void Clear() noexcept {
+            for (auto& bucket : buckets_) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        // 2^40 events per second at most; the tag repeats every 2^24 seconds (194 days), far
+        // longer than a bucket lives.
+        static constexpr int kCountBits = 40;
+        static constexpr std::uint64_t kCountMask = (std::uint64_t{1} << kCountBits) - 1;
+
+        static std::uint64_t Tag(std::int64_t second) noexcept {
+            return static_cast<std::uint64_t>(second) & ((std::uint64_t{1} << (64 - kCountBits)) - 1);
+        }
+
+        alignas(64) std::array<std::atomic<std::uint64_t>, kSeconds> buckets_{};
+    };
+}
@@ -0,0 +1,85 @@
+#include "RequestMetric.h"
+
+using namespace Metrics;
+
+namespace {
+    std::atomic<unsigned long long> default_name_counter = 0;
+}
+
+std::string RequestMetric::CreateDefaultName() {
+    return "\"RequestMetric " + std::to_string(++default_name_counter) + "\"";
+}
+
+RequestMetric::RequestMetric(const std::string& name, SteadyClock clock)
+    : name_(name)
+    , clock_(clock)
+    , last_evaluate_(clock_())
+{}
+
+std::string RequestMetric::GetName() const noexcept {
+    return name_;
+}
+
+std::string RequestMetric::GetValueAsString() const {
+    std::string value;
+    AppendValue(value);
+    return value;
+}
+
+void RequestMetric::AppendName(OutputBuffer& out) const {
+    out += name_;
+}
+
+// "rps: <rps>, in flight: <n>, <status class>: <count>..., P90: <latency>ns, ...", only the
+// status classes that have been seen.
+void RequestMetric::AppendValue(OutputBuffer& out) const {
+    Stats stats = LastInterval();
+    out += "rps: ";
+    Format::AppendFixed(out, stats.rps, 2);
+    out += ", in flight: ";
+    Format::AppendInteger(out, stats.in_flight);
+    for (std::size_t i = 0; i < kStatusClasses; ++i) {
+        if (stats.statuses[i] == 0) {
+            continue;
+        }
+        out += ", ";
+        out += kStatusClassNames[i];
+        out += ": ";
+        Format::AppendInteger(out, stats.statuses[i]);
+    }
+    out += ", ";
+    Format::AppendPercentiles(out, stats.latency, "ns");
+}
+
+RequestMetric::Stats RequestMetric::LastInterval() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+// Counters and latency buckets are taken with exchange(0), so requests that finish while the
+// value is logged count towards the next interval.
+void RequestMetric::Evaluate() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = clock_();
+    double seconds = std::chrono::duration<double>(now - last_evaluate_).count();
+    unsigned long long started = state_.started.exchange(0, std::memory_order_relaxed);
+
+    stats_.rps = seconds > 0.0 ? static_cast<double>(started) / seconds : 0.0;
+    stats_.in_flight = state_.in_flight.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < kStatusClasses; ++i) {
+        statuses_[i] += state_.statuses[i].exchange(0, std::memory_order_relaxed);
+    }
+    stats_.statuses = statuses_;
+    latency_.TakeInto(latencies_);
+    stats_.latency = SharedHistogramState::PercentilesOf(latencies_);
+
+    last_evaluate_ = now;
+}
+
+// Only drops what Evaluate() has taken: the live counters belong to the trackers, and
+// LastInterval() keeps the last evaluated stats.
+void RequestMetric::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statuses_.fill(0);
+    latencies_.fill(0);
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "IMetrics.h"
+#include "HTTPRouteMetric.h"
+#include "RateWindow.h"
+#include "SharedMetrics.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace Metrics {
+    // Everything a request updates besides the latency bucket: in flight, started requests and
+    // finished requests by status class. One cache line, so a request touches this line and one
+    // histogram bucket instead of a metric (and a lock or atomic) per aspect.
+    struct alignas(64) RequestState {
+        std::atomic<long long> in_flight{0};
+        std::atomic<unsigned long long> started{0};
+        std::array<std::atomic<unsigned long long>, kStatusClasses> statuses{};
+    };
+
+    static_assert(sizeof(RequestState) == 64, "RequestState must stay one cache line");
+
+    // Rate, in-flight count, latency and status of requests, updated by one scoped Tracker per
+    // request:
+    //   auto tracker = requests->Track();
+    //   ...
+    //   tracker.SetStatus(200);
+    // Latencies go into a log-linear histogram (SharedHistogramState) with atomic buckets, so
+    // nothing on the request path takes a lock.
+    class RequestMetric final : public IMetric, public MetricTags::ServerMetricTag {
+    private:
+        static std::string CreateDefaultName();
+
+    public:
+        struct Stats {
+            // Requests started per second since the previous Evaluate().
+            double rps = 0.0;
+            long long in_flight = 0;
+            // Finished requests by status class, since construction or Reset(), as of the
+            // Evaluate() that made the stats.
+            std::array<unsigned long long, kStatusClasses> statuses{};
+            // Latencies of finished requests in ns, since construction or Reset().
+            Snapshot::Percentiles latency;
+        };
+
+        // Counts the request as started when created and as finished when destroyed. A tracker
+        // destroyed without SetStatus() (e.g. by an exception) counts under StatusClass::Other.
+        class Tracker {
+        public:
+            explicit Tracker(RequestMetric& metric) noexcept
+                : metric_(&metric)
+                , start_(metric.clock_())
+            {
+                metric.state_.in_flight.fetch_add(1, std::memory_order_relaxed);
+                metric.state_.started.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            Tracker(Tracker&& other) noexcept
+                : metric_(std::exchange(other.metric_, nullptr))
+                , start_(other.start_)
+                , status_(other.status_)
+            {}
+
+            Tracker(const Tracker& other) = delete;
+            Tracker& operator=(const Tracker& other) = delete;
+            Tracker& operator=(Tracker&& other) = delete;
+
+            ~Tracker() {
+                if (metric_ == nullptr) {
+                    return;
+                }
+                auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(metric_->clock_() - start_);
+                metric_->latency_.Record(latency.count());
+                RequestState& state = metric_->state_;
+                state.statuses[static_cast<std::size_t>(ClassOf(status_))].fetch_add(1, std::memory_order_relaxed);
+                state.in_flight.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            void SetStatus(int status) noexcept {
+                status_ = status;
+            }
+
+        private:
+            RequestMetric* metric_;
+            std::chrono::steady_clock::time_point start_;
+            int status_ = 0;
+        };
+
+        explicit RequestMetric(const std::string& name=CreateDefaultName(), SteadyClock clock=&SteadyNow);
+        std::string GetName() const noexcept override;
+        std::string GetValueAsString() const override;
+        void AppendName(OutputBuffer& out) const override;
+        void AppendValue(OutputBuffer& out) const override;
+        void Evaluate() override;
+        void Reset() override;
+
+        Tracker Track() noexcept {
+            return Tracker(*this);
+        }
+
+        // As of the last Evaluate(); Reset() doesn't clear it.
+        Stats LastInterval() const;
+
+    private:
+        RequestState state_;
+        SharedHistogramState latency_{};
+
+        std::string name_;
+        SteadyClock clock_;
+
+        // Evaluate() state: what it has taken since Reset(), and the last stats.
+        std::chrono::steady_clock::time_point last_evaluate_;
+        std::array<unsigned long long, kStatusClasses> statuses_{};
+        SharedHistogramState::Counts latencies_{};
+        Stats stats_;
+        mutable std::mutex mutex_;
+    };
+}
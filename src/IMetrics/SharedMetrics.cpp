@@ -0,0 +1,184 @@
+#include "SharedMetrics.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+using namespace Metrics;
+
+std::int64_t SharedHistogramState::BucketUpperBound(std::size_t index) noexcept {
+    if (index < kSubBuckets) {
+        return static_cast<std::int64_t>(index);
+    }
+    std::size_t shift = index / kSubBuckets - 1;
+    std::uint64_t mantissa = kSubBuckets + index % kSubBuckets;
+    return static_cast<std::int64_t>(((mantissa + 1) << shift) - 1);
+}
+
+void SharedHistogramState::TakeInto(Counts& into) noexcept {
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+        if (counts[i].load(std::memory_order_relaxed) != 0) {
+            into[i] += counts[i].exchange(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+Snapshot::Percentiles SharedHistogramState::Percentiles() const {
+    Counts loaded;
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+        loaded[i] = counts[i].load(std::memory_order_relaxed);
+    }
+    return PercentilesOf(loaded);
+}
+
+Snapshot::Percentiles SharedHistogramState::PercentilesOf(const Counts& counts) {
+    std::uint64_t total = 0;
+    for (std::uint64_t count : counts) {
+        total += count;
+    }
+    
+    // Same rule as hdr_value_at_percentile: the bucket holding the ceil(p * total)-th value.
+    auto percentile = [&](double p) -> double {
+        if (total == 0) {
+            return 0.0;
+        }
+        std::uint64_t target = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(p / 100.0 * total)));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            seen += counts[i];
+            if (seen >= target) {
+                return static_cast<double>(BucketUpperBound(i));
+            }
+        }
+        return static_cast<double>(kMaxValue);
+    };
+    
+    Snapshot::Percentiles percentiles;
+    for (std::size_t i = 0; i < percentiles.points.size(); ++i) {
+        double p = Snapshot::Percentiles::kPercentiles[i];
+        percentiles.points[i] = {p, percentile(p)};
+    }
+    percentiles.count = total;
+    return percentiles;
+}
+
+SharedIncrementMetric::SharedIncrementMetric(MetricsMemory::SharedArena& arena, const std::string& name)
+    : name_(name)
+    , state_(arena.Find<SharedCounterState>(name))
+{}
+
+std::string SharedIncrementMetric::GetName() const noexcept {
+    return name_;
+}
+
+std::string SharedIncrementMetric::GetValueAsString() const {
+    std::string value;
+    AppendValue(value);
+    return value;
+}
+
+void SharedIncrementMetric::AppendName(OutputBuffer& out) const {
+    out += name_;
+}
+
+void SharedIncrementMetric::AppendValue(OutputBuffer& out) const {
+    Format::AppendInteger(out, taken_.load(std::memory_order_relaxed));
+}
+
+MetricSnapshot SharedIncrementMetric::GetSnapshot() const {
+    return Snapshot::Counter{taken_.load(std::memory_order_relaxed)};
+}
+
+void SharedIncrementMetric::Evaluate() noexcept {
+    taken_.fetch_add(state_.value.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void SharedIncrementMetric::Reset() noexcept {
+    taken_.store(0, std::memory_order_relaxed);
+}
+
+SharedHTTPIncomeMetric::SharedHTTPIncomeMetric(MetricsMemory::SharedArena& arena, const std::string& key, SteadyClock clock)
+    : state_(arena.Find<SharedCounterState>(key))
+    , clock_(clock)
+    , current_rps_value_(0.0)
+    , last_evaluate_(clock_())
+    , last_evaluated_counter_(state_.value.load(std::memory_order_relaxed))
+{}
+
+std::string SharedHTTPIncomeMetric::GetName() const noexcept {
+    return "\"HTTPS requests RPS\"";
+}
+
+std::string SharedHTTPIncomeMetric::GetValueAsString() const {
+    std::string value;
+    AppendValue(value);
+    return value;
+}
+
+void SharedHTTPIncomeMetric::AppendName(OutputBuffer& out) const {
+    out += "\"HTTPS requests RPS\"";
+}
+
+void SharedHTTPIncomeMetric::AppendValue(OutputBuffer& out) const {
+    Format::AppendFixed(out, current_rps_value_.load(), 2);
+}
+
+MetricSnapshot SharedHTTPIncomeMetric::GetSnapshot() const {
+    return Snapshot::Gauge{current_rps_value_.load()};
+}
+
+void SharedHTTPIncomeMetric::Evaluate() noexcept {
+    auto now = clock_();
+    double seconds = std::chrono::duration<double>(now - last_evaluate_).count();
+    if (seconds < 1.0) {
+        return;
+    }
+    unsigned long long current_total_requests = state_.value.load(std::memory_order_relaxed);
+    unsigned long long requests_in_interval = current_total_requests - last_evaluated_counter_;
+    current_rps_value_ = static_cast<double>(requests_in_interval) / seconds;
+    last_evaluated_counter_ = current_total_requests;
+    last_evaluate_ = now;
+}
+
+// MetricsManager resets after every scrape; the rate is measured against the clock, and the
+// counter belongs to all workers.
+void SharedHTTPIncomeMetric::Reset() noexcept {}
+
+SharedLatencyMetric::SharedLatencyMetric(MetricsMemory::SharedArena& arena, const std::string& key)
+    : state_(arena.Find<SharedHistogramState>(key))
+{}
+
+std::string SharedLatencyMetric::GetName() const noexcept {
+    return "\"Percentile Latency\"";
+}
+
+std::string SharedLatencyMetric::GetValueAsString() const {
+    std::string value;
+    AppendValue(value);
+    return value;
+}
+
+void SharedLatencyMetric::AppendName(OutputBuffer& out) const {
+    out += "\"Percentile Latency\"";
+}
+
+void SharedLatencyMetric::AppendValue(OutputBuffer& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Format::AppendPercentiles(out, SharedHistogramState::PercentilesOf(taken_), "ns");
+}
+
+MetricSnapshot SharedLatencyMetric::GetSnapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return SharedHistogramState::PercentilesOf(taken_);
+}
+
+void SharedLatencyMetric::Evaluate() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state_.TakeInto(taken_);
+}
+
+// The shared buckets are left to the workers; only what Evaluate() took is dropped.
+void SharedLatencyMetric::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    taken_.fill(0);
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "IMetrics.h"
+#include "RateWindow.h"
+#include "MetricsManager/SharedArena.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Metrics whose state lives in a MetricsMemory::SharedArena, so that several processes (e.g.
+// pre-forked workers) update one series with atomics. Every process constructs the metric with
+// the same arena and key; one of them registers it in its MetricsManager and logs the aggregate.
+// Evaluate() takes from the shared state, so only that process should call it.
+namespace Metrics {
+    struct SharedCounterState {
+        std::atomic<unsigned long long> value;
+    };
+
+    // Log-linear histogram: exact below 64 ns, then 64 buckets per power of two, so a reported
+    // percentile is within 1/64 of the recorded value. Covers up to 2^43 ns, about 146 minutes.
+    // Lock-free, so it's also used outside shared memory (RequestMetric).
+    struct SharedHistogramState {
+        static constexpr std::size_t kSubBuckets = 64;
+        static constexpr std::size_t kMaxShift = 36;
+        static constexpr std::size_t kBuckets = kSubBuckets * (kMaxShift + 2);
+        static constexpr std::int64_t kMaxValue = (std::int64_t{2} * kSubBuckets << kMaxShift) - 1;
+
+        static std::size_t BucketIndex(std::int64_t value) noexcept {
+            std::uint64_t v = static_cast<std::uint64_t>(std::clamp<std::int64_t>(value, 0, kMaxValue));
+            if (v < kSubBuckets) {
+                return static_cast<std::size_t>(v);
+            }
+            // Keep the top 7 bits: the leading one plus 6 bits of sub-bucket.
+            std::size_t shift = static_cast<std::size_t>(std::bit_width(v)) - 7;
+            return kSubBuckets * (shift + 1) + static_cast<std::size_t>((v >> shift) - kSubBuckets);
+        }
+        static std::int64_t BucketUpperBound(std::size_t index) noexcept;
+
+        void Record(std::int64_t value) noexcept {
+            counts[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        using Counts = std::array<std::uint64_t, kBuckets>;
+
+        // Adds the counts into `into` and takes them with exchange(0), so samples recorded
+        // meanwhile stay for the next call instead of being cleared away.
+        void TakeInto(Counts& into) noexcept;
+        Snapshot::Percentiles Percentiles() const;
+        static Snapshot::Percentiles PercentilesOf(const Counts& counts);
+
+        std::atomic<std::uint64_t> counts[kBuckets];
+    };
+
+    // Evaluate() moves the shared count into the metric with exchange(0), so increments made
+    // while the value is logged count towards the next interval instead of being reset away.
+    // The value reported is the count taken by Evaluate() since the last Reset().
+    class SharedIncrementMetric final : public IMetric {
+    public:
+        SharedIncrementMetric(MetricsMemory::SharedArena& arena, const std::string& name);
+        std::string GetName() const noexcept override;
+        std::string GetValueAsString() const override;
+        void AppendName(OutputBuffer& out) const override;
+        void AppendValue(OutputBuffer& out) const override;
+        MetricSnapshot GetSnapshot() const override;
+        void Evaluate() noexcept override;
+        void Reset() noexcept override;
+        
+        SharedIncrementMetric& operator++() noexcept {
+            state_.value.fetch_add(1, std::memory_order_relaxed);
+            return *this;
+        }
+
+        SharedIncrementMetric& operator++(int) noexcept {
+            return ++(*this);
+        }
+        
+    private:
+        std::string name_;
+        SharedCounterState& state_;
+        std::atomic<unsigned long long> taken_{0};
+    };
+
+    // Requests per second over steady-clock time between scrapes. Workers only add to the shared
+    // counter, so the rate is taken from its growth: scrapes less than a second after the
+    // previous measured one keep the previous rate. Reset() keeps the counter and the rate.
+    class SharedHTTPIncomeMetric final : public IMetric, public MetricTags::ServerMetricTag {
+    public:
+        explicit SharedHTTPIncomeMetric(MetricsMemory::SharedArena& arena, const std::string& key="http_income", SteadyClock clock=&SteadyNow);
+        std::string GetName() const noexcept override;
+        std::string GetValueAsString() const override;
+        void AppendName(OutputBuffer& out) const override;
+        void AppendValue(OutputBuffer& out) const override;
+        MetricSnapshot GetSnapshot() const override;
+        void Evaluate() noexcept override;
+        void Reset() noexcept override;
+        
+        SharedHTTPIncomeMetric& operator++() noexcept {
+            state_.value.fetch_add(1, std::memory_order_relaxed);
+            return *this;
+        }
+
+        SharedHTTPIncomeMetric& operator++(int) noexcept {
+            return ++(*this);
+        }
+        
+    private:
+        SharedCounterState& state_;
+        SteadyClock clock_;
+        std::atomic<double> current_rps_value_;
+
+        // Evaluate() state.
+        std::chrono::steady_clock::time_point last_evaluate_;
+        unsigned long long last_evaluated_counter_;
+    };
+
+    // Like SharedIncrementMetric, Evaluate() takes the buckets with exchange(0), so samples
+    // recorded while the value is logged count towards the next interval. The percentiles
+    // reported are of the samples taken by Evaluate() since the last Reset().
+    class SharedLatencyMetric final : public IMetric, public MetricTags::ComputerMetricTag {
+    public:
+        explicit SharedLatencyMetric(MetricsMemory::SharedArena& arena, const std::string& key="latency");
+        std::string GetName() const noexcept override;
+        std::string GetValueAsString() const override;
+        void AppendName(OutputBuffer& out) const override;
+        void AppendValue(OutputBuffer& out) const override;
+        MetricSnapshot GetSnapshot() const override;
+        void Evaluate() override;
+        void Reset() override;
+        
+        void Observe(std::chrono::nanoseconds latency) noexcept {
+            state_.Record(latency.count());
+        }
+        
+    private:
+        SharedHistogramState& state_;
+        SharedHistogramState::Counts taken_{};
+        mutable std::mutex mutex_;
+    };
+}
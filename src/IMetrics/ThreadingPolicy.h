@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+namespace Metrics {
+    // How a metric guards its state. Policy::Mutex is used with std::lock_guard on every update
+    // and read; a metric that is only touched from one thread can drop the synchronization.
+    // There is no lock-free policy: what the policy guards is state that changes several words at
+    // once (a histogram merge, a start/finish pair, a hash map, the previous /proc/stat sample).
+    // Values that fit one atomic are read without the lock instead, under every policy.
+
+    // For metrics confined to one thread (including their scrapes): locking compiles to nothing.
+    // Such a metric may only be registered in a MetricsManager that scrapes it on the updating
+    // thread: the manager refuses to mix it with Serve() and SetExecutor(), whose threads read
+    // metrics too (see ThreadConfinedMetric).
+    struct SingleThreadPolicy {
+        struct Mutex {
+            void lock() noexcept {}
+            bool try_lock() noexcept { return true; }
+            void unlock() noexcept {}
+        };
+    };
+
+    // The default: any number of threads, waiters sleep.
+    struct MutexPolicy {
+        using Mutex = std::mutex;
+    };
+
+    // Any number of threads; a spinlock, not a lock-free scheme: waiters yield in a loop instead
+    // of sleeping, and a holder preempted mid-section stalls them. Only worth it for very short
+    // critical sections under little contention, e.g. a few updating threads and a periodic
+    // scrape.
+    struct SpinLockPolicy {
+        class Mutex {
+        public:
+            void lock() noexcept {
+                while (flag_.test_and_set(std::memory_order_acquire)) {
+                    while (flag_.test(std::memory_order_relaxed)) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+
+            bool try_lock() noexcept {
+                return !flag_.test_and_set(std::memory_order_acquire);
+            }
+
+            void unlock() noexcept {
+                flag_.clear(std::memory_order_release);
+            }
+
+        private:
+            std::atomic_flag flag_;
+        };
+    };
+
+    template <typename Policy>
+    concept ThreadingPolicy = requires(typename Policy::Mutex& mutex) {
+        mutex.lock();
+        mutex.unlock();
+    };
+
+    template <typename Policy>
+    inline constexpr bool kThreadConfinedPolicy = std::is_same_v<Policy, SingleThreadPolicy>;
+
+    // Metrics built on SingleThreadPolicy declare kThreadConfined = true.
+    template <typename T>
+    concept ThreadConfinedMetric = requires { requires T::kThreadConfined; };
+}
@@ -0,0 +1,119 @@
+#include "EpochReclaimer.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <thread>
+
+using namespace MetricsMemory;
+
+EpochReclaimer::Guard::Guard(std::atomic<std::uint64_t>* slot) noexcept : slot_(slot) {}
+
+EpochReclaimer::Guard::Guard(Guard&& other) noexcept : slot_(other.slot_) {
+    other.slot_ = nullptr;
+}
+
+EpochReclaimer::Guard& EpochReclaimer::Guard::operator=(Guard&& other) noexcept {
+    if (this != &other) {
+        Release();
+        slot_ = other.slot_;
+        other.slot_ = nullptr;
+    }
+    return *this;
+}
+
+EpochReclaimer::Guard::~Guard() {
+    Release();
+}
+
+void EpochReclaimer::Guard::Release() noexcept {
+    if (slot_ != nullptr) {
+        slot_->store(0, std::memory_order_release);
+        slot_ = nullptr;
+    }
+}
+
+EpochReclaimer::~EpochReclaimer() {
+    std::lock_guard<std::mutex> lock(retired_mutex_);
+    retired_.clear();
+}
+
+EpochReclaimer::Guard EpochReclaimer::Pin() noexcept {
+    static thread_local const std::size_t hint = std::hash<std::thread::id>{}(std::this_thread::get_id());
+
+    for (std::size_t attempt = 0;; ++attempt) {
+        std::uint64_t epoch = global_epoch_.load();
+        auto& slot = readers_[(hint + attempt) % kMaxReaders].epoch;
+
+        std::uint64_t expected = 0;
+        if (!slot.compare_exchange_strong(expected, epoch)) {
+            if (attempt % kMaxReaders == kMaxReaders - 1) {
+                std::this_thread::yield();
+            }
+            continue;
+        }
+
+        // Republish until the epoch is stable, so a reclaimer that scanned before our store
+        // cannot have advanced past what we announced.
+        for (std::uint64_t current = global_epoch_.load(); current != epoch; current = global_epoch_.load()) {
+            epoch = current;
+            slot.store(epoch);
+        }
+
+        return Guard(&slot);
+    }
+}
+
+void EpochReclaimer::Retire(MetricPtr metric, std::function<void()> on_reclaim) {
+    if (!metric) {
+        return;
+    }
+
+    std::uint64_t epoch = global_epoch_.fetch_add(1);
+    std::lock_guard<std::mutex> lock(retired_mutex_);
+    retired_.push_back(Retired{epoch, std::move(metric), std::move(on_reclaim)});
+    pending_.store(retired_.size(), std::memory_order_relaxed);
+}
+
+std::size_t EpochReclaimer::Reclaim() {
+    if (pending_.load(std::memory_order_relaxed) == 0) {
+        return 0;
+    }
+
+    std::vector<Retired> reclaimable;
+    {
+        std::lock_guard<std::mutex> lock(retired_mutex_);
+        std::uint64_t min_epoch = MinPinnedEpoch();
+
+        auto middle = std::partition(retired_.begin(), retired_.end(), [min_epoch](const Retired& retired) {
+            return retired.epoch >= min_epoch;
+        });
+        std::move(middle, retired_.end(), std::back_inserter(reclaimable));
+        retired_.erase(middle, retired_.end());
+        pending_.store(retired_.size(), std::memory_order_relaxed);
+    }
+
+    // Destructors and callbacks run outside the lock.
+    for (Retired& retired : reclaimable) {
+        retired.metric.reset();
+        if (retired.on_reclaim) {
+            retired.on_reclaim();
+        }
+    }
+    return reclaimable.size();
+}
+
+std::size_t EpochReclaimer::PendingCount() const noexcept {
+    return pending_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t EpochReclaimer::MinPinnedEpoch() const noexcept {
+    std::uint64_t min_epoch = std::numeric_limits<std::uint64_t>::max();
+    for (const auto& reader : readers_) {
+        std::uint64_t epoch = reader.epoch.load();
+        if (epoch != 0) {
+            min_epoch = std::min(min_epoch, epoch);
+        }
+    }
+    return min_epoch;
+}
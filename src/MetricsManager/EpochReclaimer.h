@@ -0,0 +1,85 @@
+#pragma once
+
+#include "MetricsManager/MetricsArena.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace MetricsMemory {
+
+// Epoch-based reclamation for metrics removed from a MetricsManager.
+//
+// Readers pin the current epoch for the duration of a scrape (or any other access to metrics
+// they did not create). A retired metric is stamped with the epoch it was unlinked in and is
+// destroyed only once every pinned reader has moved past that epoch, so nobody can still be
+// holding a pointer to it.
+class EpochReclaimer {
+public:
+    static constexpr std::size_t kMaxReaders = 128;
+
+    class Guard {
+    public:
+        Guard() noexcept = default;
+        Guard(Guard&& other) noexcept;
+        Guard& operator=(Guard&& other) noexcept;
+        ~Guard();
+
+        Guard(const Guard& other) = delete;
+        Guard& operator=(const Guard& other) = delete;
+
+        void Release() noexcept;
+
+    private:
+        friend class EpochReclaimer;
+        explicit Guard(std::atomic<std::uint64_t>* slot) noexcept;
+
+        std::atomic<std::uint64_t>* slot_ = nullptr;
+    };
+
+    EpochReclaimer() = default;
+    ~EpochReclaimer();
+
+    EpochReclaimer(const EpochReclaimer& other) = delete;
+    EpochReclaimer& operator=(const EpochReclaimer& other) = delete;
+
+    // Never blocks on writers; spins only if more than kMaxReaders guards are alive at once.
+    Guard Pin() noexcept;
+
+    // The metric must already be unreachable for new readers. on_reclaim runs from the Reclaim()
+    // that destroys the metric, after the destruction and outside the reclaimer's lock; it is
+    // dropped if the reclaimer itself is destroyed first.
+    void Retire(MetricPtr metric, std::function<void()> on_reclaim = {});
+
+    // Destroys every retired metric no pinned reader can observe. Returns how many were destroyed.
+    std::size_t Reclaim();
+
+    std::size_t PendingCount() const noexcept;
+
+private:
+    struct alignas(64) ReaderSlot {
+        // 0 - free, otherwise the epoch the reader pinned.
+        std::atomic<std::uint64_t> epoch{0};
+    };
+
+    struct Retired {
+        std::uint64_t epoch;
+        MetricPtr metric;
+        std::function<void()> on_reclaim;
+    };
+
+    std::uint64_t MinPinnedEpoch() const noexcept;
+
+    std::atomic<std::uint64_t> global_epoch_{1};
+    std::array<ReaderSlot, kMaxReaders> readers_;
+
+    std::vector<Retired> retired_;
+    std::atomic<std::size_t> pending_{0};
+    mutable std::mutex retired_mutex_;
+};
+
+}
@@ -0,0 +1,486 @@
+#include "HttpServer.h"
+
+#include <iostream>
+
+#ifdef __linux__
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace MetricsServer;
+
+struct HttpServer::Response {
+    std::string data;
+    // HEAD requests get only the first header_size bytes.
+    std::size_t header_size;
+};
+
+#ifdef __linux__
+
+namespace {
+    constexpr std::size_t kMaxRequestSize = 8 * 1024;
+    constexpr int kMaxEvents = 64;
+
+    bool EqualsIgnoreCase(std::string_view lhs, std::string_view rhs) {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](char a, char b) {
+            return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+        });
+    }
+
+    bool ContainsIgnoreCase(std::string_view text, std::string_view word) {
+        if (word.size() > text.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i + word.size() <= text.size(); ++i) {
+            if (EqualsIgnoreCase(text.substr(i, word.size()), word)) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+struct HttpServer::Connection {
+    struct Pending {
+        std::shared_ptr<const Response> response;
+        std::size_t length;
+        std::size_t offset = 0;
+    };
+
+    int fd;
+    std::string in;
+    std::deque<Pending> out;
+    bool close_after_write = false;
+    bool waiting_for_write = false;
+};
+
+struct HttpServer::State {
+    std::unordered_map<int, Connection> connections;
+    std::shared_ptr<const Response> cached;
+    std::chrono::steady_clock::time_point cached_at;
+    std::string body;
+
+    std::shared_ptr<const Response> bad_request = MakeResponse("400 Bad Request", "Bad Request\n");
+    std::shared_ptr<const Response> not_found = MakeResponse("404 Not Found", "Not Found\n");
+    std::shared_ptr<const Response> not_allowed = MakeResponse("405 Method Not Allowed", "Method Not Allowed\n");
+    std::shared_ptr<const Response> too_large = MakeResponse("431 Request Header Fields Too Large", "Request Too Large\n");
+    std::shared_ptr<const Response> internal_error = MakeResponse("500 Internal Server Error", "Internal Server Error\n");
+};
+
+std::shared_ptr<const HttpServer::Response> HttpServer::MakeResponse(std::string_view status, std::string_view body) {
+    auto response = std::make_shared<Response>();
+    std::string& data = response->data;
+    data.reserve(128 + body.size());
+    data += "HTTP/1.1 ";
+    data += status;
+    data += "\r\nContent-Type: text/plain; charset=utf-8\r\nContent-Length: ";
+    data += std::to_string(body.size());
+    data += "\r\n\r\n";
+    response->header_size = data.size();
+    data += body;
+    return response;
+}
+
+HttpServer::HttpServer(RenderFunction render, const HttpServerOptions& options)
+    : render_(std::move(render))
+    , options_(options)
+{}
+
+HttpServer::~HttpServer() {
+    Stop();
+}
+
+bool HttpServer::Start() {
+    if (running_) {
+        return true;
+    }
+
+    state_ = std::make_unique<State>();
+    if (!OpenListener()) {
+        CloseAll();
+        return false;
+    }
+
+    running_ = true;
+    try {
+        server_thread_ = std::thread(&HttpServer::EventLoop, this);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to start metrics server thread: " << e.what() << std::endl;
+        running_ = false;
+        CloseAll();
+        return false;
+    }
+
+    return true;
+}
+
+void HttpServer::Stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    std::uint64_t one = 1;
+    [[maybe_unused]] ssize_t written = write(wake_fd_, &one, sizeof(one));
+    if (server_thread_.joinable()) {
+        server_thread_.join();
+    }
+    CloseAll();
+}
+
+bool HttpServer::OpenListener() {
+    if (!options_.unix_socket_path.empty()) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (options_.unix_socket_path.size() >= sizeof(address.sun_path)) {
+            std::cerr << "UNIX socket path is too long: " << options_.unix_socket_path << std::endl;
+            return false;
+        }
+        std::memcpy(address.sun_path, options_.unix_socket_path.c_str(), options_.unix_socket_path.size() + 1);
+        unlink(options_.unix_socket_path.c_str());
+
+        listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_fd_ == -1 || bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) {
+            std::cerr << "Failed to bind metrics server to " << options_.unix_socket_path << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        port_ = 0;
+    } else {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(options_.port);
+        if (inet_pton(AF_INET, options_.address.c_str(), &address.sin_addr) != 1) {
+            std::cerr << "Invalid metrics server address: " << options_.address << std::endl;
+            return false;
+        }
+
+        listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int reuse = 1;
+        if (listen_fd_ == -1
+            || setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) == -1
+            || bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) {
+            std::cerr << "Failed to bind metrics server to " << options_.address << ":" << options_.port
+                      << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        socklen_t length = sizeof(address);
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length);
+        port_ = ntohs(address.sin_port);
+    }
+
+    if (listen(listen_fd_, SOMAXCONN) == -1) {
+        std::cerr << "Failed to listen on metrics server socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd_ == -1 || wake_fd_ == -1) {
+        std::cerr << "Failed to create metrics server event loop: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = listen_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &event);
+    event.data.fd = wake_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event);
+
+    return true;
+}
+
+void HttpServer::CloseAll() {
+    if (state_) {
+        for (auto& [fd, connection] : state_->connections) {
+            close(fd);
+        }
+        state_->connections.clear();
+    }
+    for (int* fd : {&listen_fd_, &epoll_fd_, &wake_fd_}) {
+        if (*fd != -1) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+    if (!options_.unix_socket_path.empty()) {
+        unlink(options_.unix_socket_path.c_str());
+    }
+}
+
+void HttpServer::EventLoop() noexcept {
+    epoll_event events[kMaxEvents];
+
+    while (running_) {
+        int count = epoll_wait(epoll_fd_, events, kMaxEvents, -1);
+        if (count == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "Metrics server epoll_wait failed: " << std::strerror(errno) << std::endl;
+            return;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == wake_fd_) {
+                return;
+            }
+            if (fd == listen_fd_) {
+                Accept();
+                continue;
+            }
+
+            auto it = state_->connections.find(fd);
+            if (it == state_->connections.end()) {
+                continue;
+            }
+
+            if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+                HandleReadable(it->second);
+            } else if (events[i].events & EPOLLOUT) {
+                Flush(it->second);
+            }
+        }
+    }
+}
+
+void HttpServer::Accept() {
+    while (true) {
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd == -1) {
+            return;
+        }
+        if (state_->connections.size() >= options_.max_connections) {
+            close(fd);
+            continue;
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == -1) {
+            close(fd);
+            continue;
+        }
+        state_->connections.emplace(fd, Connection{fd, {}, {}});
+    }
+}
+
+void HttpServer::HandleReadable(Connection& connection) {
+    char buffer[4096];
+    bool peer_closed = false;
+
+    while (true) {
+        ssize_t received = recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            connection.in.append(buffer, static_cast<std::size_t>(received));
+            continue;
+        }
+        if (received == 0) {
+            peer_closed = true;
+            break;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        CloseConnection(connection.fd);
+        return;
+    }
+
+    if (peer_closed) {
+        connection.close_after_write = true;
+    }
+    HandleRequests(connection);
+}
+
+void HttpServer::HandleRequests(Connection& connection) {
+    // Pipelined requests are answered in order.
+    while (!connection.in.empty()) {
+        std::size_t end = connection.in.find("\r\n\r\n");
+        if (end == std::string::npos) {
+            if (connection.in.size() > kMaxRequestSize) {
+                connection.out.push_back({state_->too_large, state_->too_large->data.size()});
+                connection.close_after_write = true;
+                connection.in.clear();
+            }
+            break;
+        }
+
+        std::string_view request(connection.in.data(), end);
+        std::string_view request_line = request.substr(0, request.find("\r\n"));
+        std::string_view headers = request.substr(request_line.size());
+
+        std::size_t method_end = request_line.find(' ');
+        std::size_t target_end = method_end == std::string_view::npos ? std::string_view::npos : request_line.find(' ', method_end + 1);
+        if (target_end == std::string_view::npos) {
+            connection.out.push_back({state_->bad_request, state_->bad_request->data.size()});
+            connection.close_after_write = true;
+            connection.in.clear();
+            break;
+        }
+
+        std::string_view method = request_line.substr(0, method_end);
+        std::string_view target = request_line.substr(method_end + 1, target_end - method_end - 1);
+        std::string_view version = request_line.substr(target_end + 1);
+        target = target.substr(0, target.find('?'));
+
+        bool keep_alive = version == "HTTP/1.1";
+        for (std::size_t pos = 0; pos < headers.size();) {
+            std::size_t line_end = headers.find("\r\n", pos + 2);
+            std::string_view line = headers.substr(pos + 2, line_end == std::string_view::npos ? std::string_view::npos : line_end - pos - 2);
+            std::size_t colon = line.find(':');
+            if (colon != std::string_view::npos && EqualsIgnoreCase(line.substr(0, colon), "connection")) {
+                std::string_view value = line.substr(colon + 1);
+                if (ContainsIgnoreCase(value, "close")) {
+                    keep_alive = false;
+                } else if (ContainsIgnoreCase(value, "keep-alive")) {
+                    keep_alive = true;
+                }
+            }
+            pos = line_end == std::string_view::npos ? headers.size() : line_end;
+        }
+
+        std::shared_ptr<const Response> response;
+        if (method != "GET" && method != "HEAD") {
+            // The request body is not parsed, so the connection can't be reused.
+            response = state_->not_allowed;
+            keep_alive = false;
+        } else if (target != "/metrics") {
+            response = state_->not_found;
+        } else {
+            response = MetricsResponse();
+        }
+
+        std::size_t length = method == "HEAD" ? response->header_size : response->data.size();
+        connection.out.push_back({std::move(response), length});
+        connection.in.erase(0, end + 4);
+
+        if (!keep_alive) {
+            connection.close_after_write = true;
+            connection.in.clear();
+            break;
+        }
+    }
+
+    Flush(connection);
+}
+
+bool HttpServer::Flush(Connection& connection) {
+    while (!connection.out.empty()) {
+        auto& pending = connection.out.front();
+        ssize_t sent = send(connection.fd, pending.response->data.data() + pending.offset,
+                            pending.length - pending.offset, MSG_NOSIGNAL);
+        if (sent == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                CloseConnection(connection.fd);
+                return false;
+            }
+            if (!connection.waiting_for_write) {
+                epoll_event event{};
+                event.events = EPOLLIN | EPOLLOUT;
+                event.data.fd = connection.fd;
+                epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, connection.fd, &event);
+                connection.waiting_for_write = true;
+            }
+            return true;
+        }
+
+        pending.offset += static_cast<std::size_t>(sent);
+        if (pending.offset == pending.length) {
+            connection.out.pop_front();
+        }
+    }
+
+    if (connection.close_after_write) {
+        CloseConnection(connection.fd);
+        return false;
+    }
+
+    if (connection.waiting_for_write) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = connection.fd;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.waiting_for_write = false;
+    }
+    return true;
+}
+
+void HttpServer::CloseConnection(int fd) {
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    state_->connections.erase(fd);
+}
+
+std::shared_ptr<const HttpServer::Response> HttpServer::MetricsResponse() {
+    auto now = std::chrono::steady_clock::now();
+    if (state_->cached && now - state_->cached_at < options_.cache_ttl) {
+        return state_->cached;
+    }
+
+    try {
+        state_->body.clear();
+        render_(state_->body);
+        render_count_.fetch_add(1, std::memory_order_relaxed);
+        state_->cached = MakeResponse("200 OK", state_->body);
+        state_->cached_at = now;
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to render metrics: " << e.what() << std::endl;
+        return state_->internal_error;
+    }
+
+    return state_->cached;
+}
+
+#else
+
+struct HttpServer::Connection {};
+struct HttpServer::State {};
+
+HttpServer::HttpServer(RenderFunction render, const HttpServerOptions& options)
+    : render_(std::move(render))
+    , options_(options)
+{}
+
+HttpServer::~HttpServer() = default;
+
+bool HttpServer::Start() {
+    std::cerr << "Metrics HTTP server is only supported on Linux." << std::endl;
+    return false;
+}
+
+void HttpServer::Stop() {}
+
+#endif
+
+bool HttpServer::IsRunning() const noexcept {
+    return running_;
+}
+
+std::uint16_t HttpServer::Port() const noexcept {
+    return port_;
+}
+
+std::size_t HttpServer::RenderCount() const noexcept {
+    return render_count_.load(std::memory_order_relaxed);
+}
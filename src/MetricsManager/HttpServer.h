@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace MetricsServer {
+
+struct HttpServerOptions {
+    // Address to bind; loopback by default so metrics are not exposed outside the host.
+    std::string address = "127.0.0.1";
+    // 0 picks a free port, see HttpServer::Port().
+    std::uint16_t port = 0;
+    // If set, listen on this UNIX socket instead of TCP.
+    std::string unix_socket_path;
+    // A cached response younger than this is served without rendering the metrics again.
+    std::chrono::milliseconds cache_ttl{100};
+    std::size_t max_connections = 64;
+};
+
+// Minimal HTTP/1.1 server answering GET /metrics.
+//
+// Everything runs on one thread with an epoll loop: accepting, parsing, rendering and sending.
+// The response is encoded once (status line, headers and body) and shared by every request that
+// arrives within cache_ttl, so frequent scrapes cost a send() each. Application threads are never
+// involved. Only available on Linux; elsewhere Start() returns false.
+class HttpServer {
+public:
+    // Appends the response body to the string. Called on the server thread only.
+    using RenderFunction = std::function<void(std::string& body)>;
+
+    HttpServer(RenderFunction render, const HttpServerOptions& options = {});
+    ~HttpServer();
+
+    HttpServer(const HttpServer& other) = delete;
+    HttpServer& operator=(const HttpServer& other) = delete;
+
+    bool Start();
+    void Stop();
+    bool IsRunning() const noexcept;
+
+    // The bound TCP port, valid after a successful Start(). 0 for UNIX sockets.
+    std::uint16_t Port() const noexcept;
+
+    // How many times the body was rendered; requests served from the cache don't count.
+    std::size_t RenderCount() const noexcept;
+
+private:
+    struct Connection;
+    struct Response;
+
+    bool OpenListener();
+    void CloseAll();
+    void EventLoop() noexcept;
+    void Accept();
+    void HandleReadable(Connection& connection);
+    void HandleRequests(Connection& connection);
+    bool Flush(Connection& connection);
+    void CloseConnection(int fd);
+    std::shared_ptr<const Response> MetricsResponse();
+
+    static std::shared_ptr<const Response> MakeResponse(std::string_view status, std::string_view body);
+
+    RenderFunction render_;
+    HttpServerOptions options_;
+
+    int listen_fd_ = -1;
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    std::uint16_t port_ = 0;
+
+    std::atomic<bool> running_{false};
+    std::atomic<std::size_t> render_count_{0};
+    std::thread server_thread_;
+
+    // Owned by the server thread.
+    struct State;
+    std::unique_ptr<State> state_;
+};
+
+}
@@ -0,0 +1,126 @@
+#include "MetricsArena.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+using namespace MetricsMemory;
+
+HugePageResource* HugePageResource::Instance() noexcept {
+    static HugePageResource instance;
+    return &instance;
+}
+
+#ifdef __linux__
+void* HugePageResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    if (alignment > kHugePageSize) {
+        throw std::bad_alloc();
+    }
+    std::size_t length = (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+
+    void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p == MAP_FAILED) {
+        // No reserved hugetlbfs pages: ask for transparent huge pages instead.
+        p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        madvise(p, length, MADV_HUGEPAGE);
+    }
+
+    return p;
+}
+
+void HugePageResource::do_deallocate(void* p, std::size_t bytes, std::size_t) {
+    std::size_t length = (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    munmap(p, length);
+}
+#else
+void* HugePageResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void HugePageResource::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+#endif
+
+bool HugePageResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+TypePool::TypePool(const void* type_key, std::size_t size, std::size_t alignment,
+                   std::size_t initial_chunk_size, std::pmr::memory_resource* upstream)
+    : type_key_(type_key)
+    , size_(std::max(size, sizeof(FreeSlot)))
+    , alignment_(std::max(alignment, alignof(FreeSlot)))
+    , live_objects_(0)
+    , free_list_(nullptr)
+    , chunks_(initial_chunk_size, upstream)
+{}
+
+void* TypePool::Allocate() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++live_objects_;
+
+    if (free_list_ != nullptr) {
+        FreeSlot* slot = free_list_;
+        free_list_ = slot->next;
+        return slot;
+    }
+
+    try {
+        return chunks_.allocate(size_, alignment_);
+    } catch (...) {
+        --live_objects_;
+        throw;
+    }
+}
+
+void TypePool::Release(void* p) noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --live_objects_;
+    free_list_ = ::new (p) FreeSlot{free_list_};
+}
+
+const void* TypePool::TypeKey() const noexcept {
+    return type_key_;
+}
+
+std::size_t TypePool::Size() const noexcept {
+    return size_;
+}
+
+std::size_t TypePool::LiveObjects() const noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return live_objects_;
+}
+
+MetricsArena::MetricsArena(const ArenaOptions& options)
+    : options_(options)
+    , upstream_(options.use_huge_pages ? static_cast<std::pmr::memory_resource*>(HugePageResource::Instance())
+                                       : std::pmr::new_delete_resource())
+{
+    if (options_.use_huge_pages) {
+        options_.initial_chunk_size = std::max(options_.initial_chunk_size, HugePageResource::kHugePageSize);
+    }
+}
+
+bool MetricsArena::UsesHugePages() const noexcept {
+    return options_.use_huge_pages;
+}
+
+TypePool& MetricsArena::PoolFor(const void* type_key, std::size_t size, std::size_t alignment) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& pool : pools_) {
+        if (pool->TypeKey() == type_key) {
+            return *pool;
+        }
+    }
+
+    pools_.push_back(std::make_unique<TypePool>(type_key, size, alignment, options_.initial_chunk_size, upstream_));
+    return *pools_.back();
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "IMetrics/IMetrics.h"
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace MetricsMemory {
+
+struct ArenaOptions {
+    // Back the arena with 2 MiB pages (MAP_HUGETLB, or transparent huge pages as a fallback).
+    bool use_huge_pages = false;
+    // Size of the first chunk of every per-type pool. Later chunks grow geometrically.
+    std::size_t initial_chunk_size = 64 * 1024;
+};
+
+// Upstream resource handing out memory in huge-page sized mappings.
+// On platforms without huge page support it falls back to the default new/delete resource.
+class HugePageResource final : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t kHugePageSize = 2 * 1024 * 1024;
+
+    static HugePageResource* Instance() noexcept;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+// Storage for objects of exactly one metric type. Objects are carved sequentially out of
+// monotonic chunks, so metrics of the same type end up next to each other in memory.
+// Freed slots are kept in an intrusive free list and reused by the next Allocate().
+class TypePool {
+public:
+    TypePool(const void* type_key, std::size_t size, std::size_t alignment,
+             std::size_t initial_chunk_size, std::pmr::memory_resource* upstream);
+
+    TypePool(const TypePool& other) = delete;
+    TypePool& operator=(const TypePool& other) = delete;
+
+    void* Allocate();
+    void Release(void* p) noexcept;
+
+    const void* TypeKey() const noexcept;
+    std::size_t Size() const noexcept;
+    std::size_t LiveObjects() const noexcept;
+
+private:
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    const void* type_key_;
+    std::size_t size_;
+    std::size_t alignment_;
+    std::size_t live_objects_;
+    FreeSlot* free_list_;
+    std::pmr::monotonic_buffer_resource chunks_;
+    mutable std::mutex mutex_;
+};
+
+// Destroys a metric living in a TypePool and gives its slot back.
+struct MetricDeleter {
+    TypePool* pool = nullptr;
+    void* storage = nullptr;
+
+    void operator()(Metrics::IMetric* metric) const noexcept {
+        metric->~IMetric();
+        if (pool != nullptr) {
+            pool->Release(storage);
+        }
+    }
+};
+
+using MetricPtr = std::unique_ptr<Metrics::IMetric, MetricDeleter>;
+
+// Address of TypeKey<T> identifies T without RTTI.
+template <typename T>
+inline constexpr char TypeKey = 0;
+
+class MetricsArena {
+public:
+    explicit MetricsArena(const ArenaOptions& options = {});
+
+    MetricsArena(const MetricsArena& other) = delete;
+    MetricsArena& operator=(const MetricsArena& other) = delete;
+
+    template <typename T, typename... Args>
+    requires (std::is_base_of_v<Metrics::IMetric, T>)
+    std::pair<T*, MetricPtr> Create(Args&&... args) {
+        TypePool& pool = PoolFor(&TypeKey<T>, sizeof(T), alignof(T));
+        void* storage = pool.Allocate();
+
+        T* metric;
+        try {
+            metric = ::new (storage) T(std::forward<Args>(args)...);
+        } catch (...) {
+            pool.Release(storage);
+            throw;
+        }
+
+        return {metric, MetricPtr(metric, MetricDeleter{&pool, storage})};
+    }
+
+    bool UsesHugePages() const noexcept;
+
+private:
+    TypePool& PoolFor(const void* type_key, std::size_t size, std::size_t alignment);
+
+    ArenaOptions options_;
+    std::pmr::memory_resource* upstream_;
+    std::vector<std::unique_ptr<TypePool>> pools_;
+    std::mutex mutex_;
+};
+
+}
@@ -2,14 +2,31 @@
 
 #include "MultiThreadWriter/Writer.h"
 #include "MultiThreadWriter/WriterUtils.h"
+#include "MultiThreadWriter/WriterService.h"
+#include "MetricsManager/MetricsArena.h"
+#include "MetricsManager/MetricsRegistry.h"
+#include "MetricsManager/EpochReclaimer.h"
+#include "MetricsManager/HttpServer.h"
+#include "MetricsManager/SharedMemoryTable.h"
+#include "MetricsManager/WorkStealingPool.h"
 #include "IMetrics/IMetrics.h"
 #include "IMetrics/Demangle.h"
+#include "IMetrics/ThreadingPolicy.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
+#include <unordered_map>
 #include <memory>
 #include <mutex>
+#include <atomic>
 
 template <typename Alloc = std::allocator<std::unique_ptr<Metrics::IMetric>>>
 class MetricsManager {
@@ -22,12 +39,29 @@ private:
     }
     
 public:
-    MetricsManager(const std::string& name=CreateLogDefaultName()) : async_writer_(name) 
+    using MetricPtr = MetricsMemory::MetricPtr;
+    using ReadGuard = MetricsMemory::EpochReclaimer::Guard;
+
+    MetricsManager(const std::string& name=CreateLogDefaultName(),
+                   const MetricsMemory::ArenaOptions& arena_options={})
+        : async_writer_(name)
+        , arena_(arena_options)
+    {
+        async_writer_.Start();
+    }
+    
+    // Logs through a shared WriterService instead of a writer thread of its own.
+    explicit MetricsManager(NonBlockingWriter::WriterService& writer_service,
+                            const std::string& name=CreateLogDefaultName(),
+                            const MetricsMemory::ArenaOptions& arena_options={})
+        : async_writer_(writer_service, name)
+        , arena_(arena_options)
     {
         async_writer_.Start();
     }
     
     ~MetricsManager() {
+        StopServing();
         async_writer_.Stop();
     }
     
@@ -36,83 +70,652 @@ public:
     MetricsManager(MetricsManager&& other) = delete;
     MetricsManager& operator=(MetricsManager&& other) = delete;
     
+    // Indices of removed metrics are reused by later CreateMetric calls, once no scrape can
+    // still be working on the removed metric.
+    // Throws std::runtime_error for a Metrics::ThreadConfinedMetric while Serve() or
+    // SetExecutor() has threads of the manager reading metrics.
     template <typename T, typename... Args>
     requires (std::is_base_of_v<Metrics::IMetric, T>)
     T* CreateMetric(Args&&... args) {
         std::lock_guard<std::mutex> lock(mutex_);
-        metrics_.emplace_back(std::make_unique<T>(std::forward<Args>(args)...));
+        if constexpr (Metrics::ThreadConfinedMetric<T>) {
+            if (serving_ || executor_.load(std::memory_order_relaxed) != nullptr) {
+                throw std::runtime_error("A SingleThreadPolicy metric can't be registered while the manager "
+                                         "reads metrics from its own threads (Serve, SetExecutor).");
+            }
+        }
+        auto [metric, owner] = arena_.template Create<T>(std::forward<Args>(args)...);
+
+        if (!free_indices_.empty()) {
+            size_t index = free_indices_.back();
+            free_indices_.pop_back();
+            StoreMetric<T>(registry_[index], index, metric, std::move(owner));
+        } else {
+            size_t index = registry_.Size();
+            StoreMetric<T>(registry_.Reserve(), index, metric, std::move(owner));
+            registry_.Publish();
+        }
         
-        return static_cast<T*>(metrics_.back().get());
+        return metric;
+    }
+    
+    // Removes the metric and destroys it once no scrape can observe it anymore.
+    // Pointers to a removed metric must not be used after Remove returns, unless the
+    // access happens under a guard obtained from Pin() before the call.
+    bool Remove(size_t index) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (index >= registry_.Size()) {
+                throw std::out_of_range("Index out of range.");
+            }
+            if (!RemoveLocked(index)) {
+                return false;
+            }
+        }
+        reclaimer_.Reclaim();
+        
+        return true;
     }
     
     template <typename T>
-    T* GetMetric(size_t index) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (index >= metrics_.size()) {
-            throw std::out_of_range("Index out of range.");
+    requires (std::is_base_of_v<Metrics::IMetric, T>)
+    bool Remove(const T* metric) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = index_of_.find(metric);
+            if (it == index_of_.end() || !RemoveLocked(it->second)) {
+                return false;
+            }
         }
+        reclaimer_.Reclaim();
         
-        Metrics::IMetric* base_ptr = metrics_[index].get();
+        return true;
+    }
+    
+    // Keeps every metric reachable at the moment of the call alive until the guard is released.
+    ReadGuard Pin() noexcept {
+        return reclaimer_.Pin();
+    }
+    
+    // Without RTTI T has to be the exact type the metric was created with.
+    template <typename T>
+    T* GetMetric(size_t index) {
+        Metrics::IMetric* base_ptr = LoadMetric(index);
+        const std::string_view* type_name = registry_[index].type_name.load(std::memory_order_relaxed);
+#if METRICS_HAS_RTTI
         T* metric_ptr = dynamic_cast<T*>(base_ptr);
+#else
+        T* metric_ptr = type_name == &kTypeName<T> ? static_cast<T*>(base_ptr) : nullptr;
+#endif
         
         if (metric_ptr == nullptr) {
-            std::string actual_type_name = "";
-            if (base_ptr) {
-                actual_type_name = demangle(typeid(*base_ptr).name());
-            }
             throw std::runtime_error("Type inconsistency for metric at index " +
                                         std::to_string(index) +
-                                        ". Expected type: " + demangle(typeid(T).name()) +
-                                        ", actual type: " + actual_type_name);
+                                        ". Expected type: " + std::string(kTypeName<T>) +
+                                        ", actual type: " + std::string(*type_name));
         }
             
         return metric_ptr;
     }
     
+    // Logs the metrics that have the tag T or, for a metric class T, the metrics of that class
+    // and its subclasses. Tags and final classes are matched without RTTI; a class with
+    // subclasses needs dynamic_cast, so under -fno-rtti only metrics created as exactly T match.
     template <typename T = MetricTags::DefaultMetricTag>
     requires (std::is_base_of_v<MetricTags::DefaultMetricTag, T>)
     void Log() {
-        std::vector<Metrics::IMetric*> metrics_to_process;
-        metrics_to_process.reserve(metrics_.size());
-        
+        LogSelection(SelectionOf<T>(), std::chrono::steady_clock::time_point::max());
+    }
+    
+    // Logs the metrics the filter selects, e.g.
+    // Log(MetricTags::AnyOf<ServerMetricTag, AlgoMetricTag>() & MetricTags::NoneOf<ComputerMetricTag>()).
+    void Log(MetricTags::TagFilter filter) {
+        LogSelection(Selection{filter}, std::chrono::steady_clock::time_point::max());
+    }
+    
+    // Scrape that doesn't wait for slow collectors past the deadline: metrics reached after it,
+    // or being evaluated by another scrape, are written with the value of their last evaluation
+    // and the kStaleMarker suffix, and are neither evaluated nor reset.
+    template <typename T = MetricTags::DefaultMetricTag>
+    requires (std::is_base_of_v<MetricTags::DefaultMetricTag, T>)
+    void Log(std::chrono::steady_clock::time_point deadline) {
+        LogSelection(SelectionOf<T>(), deadline);
+    }
+    
+    void Log(MetricTags::TagFilter filter, std::chrono::steady_clock::time_point deadline) {
+        LogSelection(Selection{filter}, deadline);
+    }
+    
+    // Incremental scrape for large registries. Each call logs at most `budget` registry slots,
+    // continuing where the previous call stopped, so one period's work can be spread over many
+    // short calls (see ChunkBudget). A period starts on the first call after the previous one
+    // finished and covers the metrics registered at that moment; every line of the period carries
+    // its start timestamp. Returns true when the call completed the period.
+    template <typename T = MetricTags::DefaultMetricTag>
+    requires (std::is_base_of_v<MetricTags::DefaultMetricTag, T>)
+    bool LogChunk(size_t budget) {
+        return LogChunkSelection(budget, SelectionOf<T>());
+    }
+    
+    bool LogChunk(size_t budget, MetricTags::TagFilter filter) {
+        return LogChunkSelection(budget, Selection{filter});
+    }
+    
+    // Per-call budget for LogChunk that covers the current registry once per period when
+    // LogChunk is called every tick.
+    size_t ChunkBudget(std::chrono::nanoseconds period, std::chrono::nanoseconds tick) const {
+        size_t ticks = std::max<size_t>(1, static_cast<size_t>(period / std::max(tick, std::chrono::nanoseconds(1))));
+        return std::max<size_t>(1, (registry_.Size() + ticks - 1) / ticks);
+    }
+    
+    static constexpr size_t kDefaultExecutorChunkSize = 1024;
+    static constexpr std::string_view kStaleMarker = " (stale)";
+    
+    // Runs Log() and LogChunk() scrapes on the pool: chunks of chunk_size registry slots are
+    // evaluated and formatted in parallel and written in registry order. Ranges no longer than
+    // one chunk stay on the calling thread; nullptr goes back to serial scrapes. The pool may be
+    // shared between managers and must outlive its use here.
+    // Throws std::runtime_error if a Metrics::ThreadConfinedMetric is registered.
+    void SetExecutor(MetricsExecution::WorkStealingPool* executor, size_t chunk_size = kDefaultExecutorChunkSize) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (executor != nullptr) {
+            CheckNoThreadConfinedMetrics("SetExecutor");
+        }
+        executor_chunk_size_.store(std::max<size_t>(chunk_size, 1), std::memory_order_relaxed);
+        executor_.store(executor, std::memory_order_release);
+    }
+    
+    // Change-only logging: a scrape writes only the metrics whose value differs from the one it
+    // last wrote, and every keyframe_interval-th scrape (a keyframe, starting with the next one)
+    // writes all of them. Metrics are still evaluated and reset on every scrape. 0 turns it off.
+    void SetChangeOnlyLogging(size_t keyframe_interval) {
+        keyframe_interval_.store(keyframe_interval, std::memory_order_relaxed);
+        scrape_count_.store(0, std::memory_order_relaxed);
+    }
+    
+    // With LogEncoding::Dictionary scrapes write a metric's name, type, unit and tags once per
+    // file, then only its index and value; NonBlockingWriter::LogDecoder restores text lines.
+    // Switching the encoding starts a new segment: every metric is defined again.
+    void SetLogEncoding(NonBlockingWriter::LogEncoding encoding) {
+        log_encoding_.store(encoding, std::memory_order_relaxed);
+        dictionary_generation_.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    // Always writes the metric, whatever the logging mode.
+    void Log(size_t index) {
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            for (const auto& metric_ptr_unique : metrics_) {
-                if (!metric_ptr_unique) continue;
-
-                if (dynamic_cast<T*>(metric_ptr_unique.get()) != nullptr) {
-                    metrics_to_process.push_back(metric_ptr_unique.get());
-                }
+            ReadGuard guard = reclaimer_.Pin();
+            NonBlockingWriter::ScrapeBatch batch = MakeBatch();
+            auto exporter = shared_memory_.load();
+            LogMetric(batch, LoadMetric(index), exporter.get(), index, ScrapeState{});
+            CommitBatch(batch);
+            if (exporter) {
+                exporter->Commit();
             }
         }
+        reclaimer_.Reclaim();
+    }
+    
+    // Appends every metric as a "name: value" line. Neither Evaluate() nor Reset() is called, so
+    // this can run next to Log() at any rate without changing what Log() reports.
+    void RenderText(std::string& out) {
+        ReadGuard guard = reclaimer_.Pin();
+        size_t size = registry_.Size();
+        for (size_t index = 0; index < size; ++index) {
+            Metrics::IMetric* metric = registry_[index].metric.load(std::memory_order_acquire);
+            if (metric == nullptr) continue;
 
-        for (const auto& metric_ptr_raw : metrics_to_process) {
-            metric_ptr_raw->Evaluate();
-            NonBlockingWriter::WriterUtils::WriteMetricWithTimestamp(async_writer_, metric_ptr_raw->GetName(), metric_ptr_raw->GetValueAsString());
-            metric_ptr_raw->Reset();
+            metric->AppendName(out);
+            out += ": ";
+            metric->AppendValue(out);
+            out += '\n';
         }
     }
     
-    void Log(size_t index) {
-        Metrics::IMetric* metric_ptr_raw;
+    // Appends the typed value of every metric, for consumers that need numbers rather than text.
+    // Like RenderText(), calls neither Evaluate() nor Reset().
+    void CollectSnapshots(std::vector<Metrics::NamedSnapshot>& out) {
+        ReadGuard guard = reclaimer_.Pin();
+        size_t size = registry_.Size();
+        for (size_t index = 0; index < size; ++index) {
+            Metrics::IMetric* metric = registry_[index].metric.load(std::memory_order_acquire);
+            if (metric == nullptr) continue;
+
+            out.push_back({metric->GetName(), metric->GetSnapshot()});
+        }
+    }
+    
+    // Serves RenderText() at GET /metrics from a background thread. Returns false if the socket
+    // can't be opened; calling it again while serving restarts the server with the new options.
+    // Throws std::runtime_error if a Metrics::ThreadConfinedMetric is registered.
+    bool Serve(const MetricsServer::HttpServerOptions& options = {}) {
+        std::lock_guard<std::mutex> lock(server_mutex_);
+        {
+            std::lock_guard<std::mutex> registry_lock(mutex_);
+            CheckNoThreadConfinedMetrics("Serve");
+            serving_ = true;
+        }
+        server_.reset();
+        auto server = std::make_unique<MetricsServer::HttpServer>([this](std::string& body) {
+            RenderText(body);
+        }, options);
+        if (!server->Start()) {
+            std::lock_guard<std::mutex> registry_lock(mutex_);
+            serving_ = false;
+            return false;
+        }
+        server_ = std::move(server);
         
+        return true;
+    }
+    
+    void StopServing() {
+        std::lock_guard<std::mutex> lock(server_mutex_);
+        server_.reset();
+        std::lock_guard<std::mutex> registry_lock(mutex_);
+        serving_ = false;
+    }
+    
+    // TCP port of the running server, 0 if not serving or serving on a UNIX socket.
+    uint16_t ServerPort() {
+        std::lock_guard<std::mutex> lock(server_mutex_);
+        return server_ ? server_->Port() : 0;
+    }
+    
+    // Publishes every Log() into a POSIX shared-memory table (see SharedMemoryTable.h) that other
+    // processes can sample with SharedMemoryReader. Slot i holds the metric at index i.
+    bool ExportToSharedMemory(const MetricsServer::SharedMemoryOptions& options) {
+        auto exporter = std::make_shared<MetricsServer::SharedMemoryWriter>(options);
+        if (!exporter->Open()) {
+            return false;
+        }
+        shared_memory_.store(std::move(exporter));
+        PublishToSharedMemory();
+        
+        return true;
+    }
+    
+    void StopSharedMemoryExport() {
+        shared_memory_.store(nullptr);
+    }
+    
+    // Refreshes the shared-memory table without Evaluate() or Reset(), like RenderText().
+    void PublishToSharedMemory() {
+        auto exporter = shared_memory_.load();
+        if (!exporter) {
+            return;
+        }
+        
+        ReadGuard guard = reclaimer_.Pin();
+        size_t size = registry_.Size();
+        for (size_t index = 0; index < size; ++index) {
+            Metrics::IMetric* metric = registry_[index].metric.load(std::memory_order_acquire);
+            if (metric == nullptr) {
+                exporter->Clear(index);
+                continue;
+            }
+            
+            ScrapeBuffers& buffers = Scratch();
+            buffers.name.clear();
+            buffers.value.clear();
+            metric->AppendName(buffers.name);
+            metric->AppendValue(buffers.value);
+            exporter->Publish(index, buffers.name, buffers.value);
+        }
+        exporter->Commit();
+    }
+    
+private:
+    struct Selection {
+        MetricTags::TagFilter filter{};
+        // &kTypeName<T> to log only metrics of class T, nullptr - any type.
+        const std::string_view* type = nullptr;
+        // Matches subclasses of that class, nullptr - only metrics created as exactly it.
+        bool (*is_subclass)(Metrics::IMetric*) = nullptr;
+        
+        bool MatchesType(const std::string_view* type_name, Metrics::IMetric* metric) const {
+            return type == nullptr || type == type_name || (is_subclass != nullptr && is_subclass(metric));
+        }
+    };
+
+    template <typename T>
+    static Selection SelectionOf() {
+        if constexpr (std::is_same_v<T, MetricTags::DefaultMetricTag>) {
+            return Selection{};
+        } else if constexpr (MetricTags::Tag<T>) {
+            return Selection{MetricTags::AllOf<T>()};
+        } else {
+            static_assert(std::is_base_of_v<Metrics::IMetric, T>,
+                          "T is neither a metric class nor a tag with a bit of its own (see MetricTags::Tag)");
+            Selection selection{{}, &kTypeName<T>};
+#if METRICS_HAS_RTTI
+            if constexpr (!std::is_final_v<T>) {
+                selection.is_subclass = [](Metrics::IMetric* metric) { return dynamic_cast<T*>(metric) != nullptr; };
+            }
+#endif
+            return selection;
+        }
+    }
+
+    struct ScrapeState {
+        // Write every metric, see SetChangeOnlyLogging.
+        bool keyframe = true;
+        Selection selection{};
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    };
+
+    struct ScrapePeriod {
+        bool active = false;
+        bool keyframe = true;
+        std::chrono::system_clock::time_point timestamp;
+        size_t cursor = 0;
+        size_t end = 0;
+    };
+
+    struct MetricSlot {
+        // Read by scrapes and GetMetric without the manager mutex.
+        std::atomic<Metrics::IMetric*> metric{nullptr};
+        // Set before metric is published; scrapes filter on tags without touching the metric.
+        std::atomic<MetricTags::TagMask> tags{0};
+        // &kTypeName<T> of the created type.
+        std::atomic<const std::string_view*> type_name{nullptr};
+        // Owned by writers, guarded by mutex_.
+        MetricPtr owner;
+        // The metric is a Metrics::ThreadConfinedMetric. Guarded by mutex_.
+        bool thread_confined = false;
+        // Hash of the last value written to the log, 0 - nothing written yet. Used by
+        // change-only logging.
+        std::atomic<uint64_t> last_value_hash{0};
+        
+        // Result of the last Evaluate(), for metrics with a minimal evaluation interval and for
+        // scrapes past their deadline. Guarded by cache_mutex, which is also held while the
+        // metric is evaluated so that concurrent scrapes don't evaluate it twice.
+        std::mutex cache_mutex;
+        std::string cached_value;
+        std::chrono::steady_clock::time_point evaluated_at;
+        bool evaluated = false;
+        
+        // Dictionary segment the metric was last defined in, 0 - none.
+        std::atomic<uint64_t> dictionary_generation{0};
+    };
+
+    NonBlockingWriter::ScrapeBatch MakeBatch(std::chrono::system_clock::time_point time_point = std::chrono::system_clock::now()) {
+        return NonBlockingWriter::ScrapeBatch(async_writer_, time_point, log_encoding_.load(std::memory_order_relaxed));
+    }
+
+    Metrics::IMetric* LoadMetric(size_t index) {
+        if (index >= registry_.Size()) {
+            throw std::out_of_range("Index out of range.");
+        }
+        Metrics::IMetric* metric = registry_[index].metric.load(std::memory_order_acquire);
+        if (metric == nullptr) {
+            throw std::out_of_range("Metric at index " + std::to_string(index) + " was removed.");
+        }
+        
+        return metric;
+    }
+
+    // Counts a scrape; returns whether it has to write every metric.
+    bool StartScrape() {
+        size_t interval = keyframe_interval_.load(std::memory_order_relaxed);
+        if (interval == 0) {
+            return true;
+        }
+        return scrape_count_.fetch_add(1, std::memory_order_relaxed) % interval == 0;
+    }
+
+    void LogSelection(const Selection& selection, std::chrono::steady_clock::time_point deadline) {
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            if (index >= metrics_.size()) {
-                throw std::out_of_range("Index out of range.");
+            ReadGuard guard = reclaimer_.Pin();
+            NonBlockingWriter::ScrapeBatch batch = MakeBatch();
+            LogRange(batch, 0, registry_.Size(), ScrapeState{StartScrape(), selection, deadline});
+        }
+        reclaimer_.Reclaim();
+    }
+
+    bool LogChunkSelection(size_t budget, const Selection& selection) {
+        bool finished = false;
+        {
+            std::lock_guard<std::mutex> lock(scrape_mutex_);
+            if (!scrape_period_.active) {
+                scrape_period_ = ScrapePeriod{true, StartScrape(), std::chrono::system_clock::now(), 0, registry_.Size()};
             }
-            metric_ptr_raw = metrics_[index].get();
+            
+            size_t begin = scrape_period_.cursor;
+            size_t end = std::min(scrape_period_.end, begin + std::max<size_t>(budget, 1));
+            {
+                ReadGuard guard = reclaimer_.Pin();
+                NonBlockingWriter::ScrapeBatch batch = MakeBatch(scrape_period_.timestamp);
+                LogRange(batch, begin, end, ScrapeState{scrape_period_.keyframe, selection});
+            }
+            
+            scrape_period_.cursor = end;
+            finished = end == scrape_period_.end;
+            scrape_period_.active = !finished;
         }
+        reclaimer_.Reclaim();
+        
+        return finished;
+    }
 
-        metric_ptr_raw->Evaluate();
-        NonBlockingWriter::WriterUtils::WriteMetricWithTimestamp(async_writer_, metric_ptr_raw->GetName(), metric_ptr_raw->GetValueAsString());
-        metric_ptr_raw->Reset();
+    // Logs the metrics in [begin, end) selected by scrape.selection as one batch. The caller pins
+    // the registry.
+    void LogRange(NonBlockingWriter::ScrapeBatch& batch, size_t begin, size_t end, const ScrapeState& scrape) {
+        auto exporter = shared_memory_.load();
+        auto* executor = executor_.load(std::memory_order_acquire);
+        size_t chunk_size = executor_chunk_size_.load(std::memory_order_relaxed);
+        
+        if (executor == nullptr || end - begin <= chunk_size) {
+            LogSlots(batch, exporter.get(), begin, end, scrape);
+        } else {
+            // Each chunk is formatted into its own batch; joining them in order keeps the
+            // output identical to a serial scrape.
+            size_t chunks = (end - begin + chunk_size - 1) / chunk_size;
+            std::vector<std::optional<NonBlockingWriter::ScrapeBatch>> parts(chunks);
+            executor->ParallelFor(chunks, [&](size_t chunk) {
+                size_t chunk_begin = begin + chunk * chunk_size;
+                auto& part = parts[chunk].emplace(async_writer_, batch.TimePoint(), batch.Encoding());
+                LogSlots(part, exporter.get(), chunk_begin, std::min(end, chunk_begin + chunk_size), scrape);
+            });
+            for (auto& part : parts) {
+                batch.Merge(*part);
+            }
+        }
+        
+        CommitBatch(batch);
+        if (exporter) {
+            exporter->Commit();
+        }
     }
     
-private:
+    // Metrics defined in the batch count as defined only once it reaches the writer: if the
+    // write fails, or another scrape is between defining a metric and committing, the next
+    // scrape defines it again. A metric defined twice is harmless for the decoder; one never
+    // defined leaves its samples undecodable. The caller pins the registry, so the slots are
+    // not reused meanwhile.
+    bool CommitBatch(NonBlockingWriter::ScrapeBatch& batch) {
+        uint64_t generation = dictionary_generation_.load(std::memory_order_relaxed);
+        if (!batch.Commit()) {
+            return false;
+        }
+        for (uint64_t index : batch.DefinedIds()) {
+            registry_[index].dictionary_generation.store(generation, std::memory_order_relaxed);
+        }
+        return true;
+    }
+    
+    void LogSlots(NonBlockingWriter::ScrapeBatch& batch, MetricsServer::SharedMemoryWriter* exporter,
+                  size_t begin, size_t end, const ScrapeState& scrape) {
+        for (size_t index = begin; index < end; ++index) {
+            Metrics::IMetric* metric_ptr_raw = registry_[index].metric.load(std::memory_order_acquire);
+            if (metric_ptr_raw == nullptr) {
+                // Drops a value a concurrent Remove() may have raced with.
+                if (exporter) {
+                    exporter->Clear(index);
+                }
+                continue;
+            }
+
+            const MetricSlot& slot = registry_[index];
+            if (scrape.selection.filter.Matches(slot.tags.load(std::memory_order_relaxed))
+                && scrape.selection.MatchesType(slot.type_name.load(std::memory_order_relaxed), metric_ptr_raw)) {
+                LogMetric(batch, metric_ptr_raw, exporter, index, scrape);
+            }
+        }
+    }
+
+    void LogMetric(NonBlockingWriter::ScrapeBatch& batch, Metrics::IMetric* metric,
+                   MetricsServer::SharedMemoryWriter* exporter, size_t index, const ScrapeState& scrape) {
+        MetricSlot& slot = registry_[index];
+        std::string& value = Scratch().value;
+        value.clear();
+        {
+            auto now = std::chrono::steady_clock::now();
+            std::unique_lock<std::mutex> lock(slot.cache_mutex, std::defer_lock);
+            bool stale = false;
+            if (scrape.deadline == std::chrono::steady_clock::time_point::max()) {
+                lock.lock();
+            } else if (now >= scrape.deadline || !lock.try_lock()) {
+                stale = true;
+            }
+            
+            if (stale) {
+                // Another scrape may be evaluating the metric; its old value is lost then.
+                if (lock.owns_lock() || lock.try_lock()) {
+                    value += slot.cached_value;
+                }
+                value += value.empty() ? kStaleMarker.substr(1) : kStaleMarker;
+            } else if (slot.evaluated && now - slot.evaluated_at < metric->MinEvaluateInterval()) {
+                value += slot.cached_value;
+            } else {
+                metric->Evaluate();
+                metric->AppendValue(value);
+                metric->Reset();
+                // Assigning into the existing string keeps its capacity.
+                slot.cached_value.assign(value);
+                slot.evaluated_at = now;
+                slot.evaluated = true;
+            }
+        }
+        
+        uint64_t hash = std::hash<std::string_view>{}(value);
+        hash = hash == 0 ? 1 : hash;
+        uint64_t previous = slot.last_value_hash.exchange(hash, std::memory_order_relaxed);
+        if (!scrape.keyframe && previous == hash) {
+            return;
+        }
+        
+        if (batch.Encoding() == NonBlockingWriter::LogEncoding::Dictionary) {
+            uint64_t generation = dictionary_generation_.load(std::memory_order_relaxed);
+            if (slot.dictionary_generation.load(std::memory_order_relaxed) != generation) {
+                batch.AddMetadata(index, *slot.type_name.load(std::memory_order_relaxed), metric->GetUnit(),
+                                  MetricTags::TagNames(slot.tags.load(std::memory_order_relaxed)), metric->GetName());
+            }
+            batch.AddSample(index, value);
+        } else {
+            batch.AddWith([metric](std::string& out) { metric->AppendName(out); },
+                          [&value](std::string& out) { out += value; });
+        }
+        if (exporter != nullptr) {
+            std::string& name = Scratch().name;
+            name.clear();
+            metric->AppendName(name);
+            exporter->Publish(index, name, value);
+        }
+    }
+    
+    // Per-thread formatting buffers: after the first scrape they have grown to the longest
+    // name and value, and formatting a metric no longer allocates.
+    struct ScrapeBuffers {
+        std::string name;
+        std::string value;
+    };
+    
+    static ScrapeBuffers& Scratch() {
+        thread_local ScrapeBuffers buffers;
+        return buffers;
+    }
+
+    // Called under mutex_.
+    void CheckNoThreadConfinedMetrics(std::string_view caller) const {
+        if (thread_confined_metrics_ != 0) {
+            throw std::runtime_error(std::string(caller) + " would read SingleThreadPolicy metrics from "
+                                     "another thread; remove them first.");
+        }
+    }
+
+    template <typename T>
+    void StoreMetric(MetricSlot& slot, size_t index, Metrics::IMetric* metric, MetricPtr owner) {
+        slot.owner = std::move(owner);
+        slot.thread_confined = Metrics::ThreadConfinedMetric<T>;
+        thread_confined_metrics_ += slot.thread_confined ? 1 : 0;
+        slot.tags.store(MetricTags::kTagsOf<T>, std::memory_order_relaxed);
+        slot.type_name.store(&kTypeName<T>, std::memory_order_relaxed);
+        slot.last_value_hash.store(0, std::memory_order_relaxed);
+        slot.dictionary_generation.store(0, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(slot.cache_mutex);
+            slot.cached_value.clear();
+            slot.evaluated = false;
+        }
+        slot.metric.store(metric, std::memory_order_release);
+        index_of_[metric] = index;
+    }
+
+    bool RemoveLocked(size_t index) {
+        MetricSlot& slot = registry_[index];
+        Metrics::IMetric* metric = slot.metric.exchange(nullptr, std::memory_order_acq_rel);
+        if (metric == nullptr) {
+            return false;
+        }
+        
+        index_of_.erase(metric);
+        thread_confined_metrics_ -= slot.thread_confined ? 1 : 0;
+        slot.thread_confined = false;
+        if (auto exporter = shared_memory_.load()) {
+            exporter->Clear(index);
+        }
+        // A scrape pinned before the removal may still write the slot's cache and hashes, so
+        // the index is free only once the metric is reclaimed. Reclaim() is never called under
+        // mutex_.
+        reclaimer_.Retire(std::move(slot.owner), [this, index] {
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_indices_.push_back(index);
+        });
+        
+        return true;
+    }
 
     NonBlockingWriter::AsyncWriter async_writer_;
-    std::vector<std::unique_ptr<Metrics::IMetric>, Alloc> metrics_;
+    // Metric objects live in the arena, grouped by type; the arena must outlive everything
+    // that owns metrics (retired list and registry).
+    MetricsMemory::MetricsArena arena_;
+    MetricsMemory::EpochReclaimer reclaimer_;
+    MetricsRegistry<MetricSlot, Alloc> registry_;
+    std::vector<size_t> free_indices_;
+    std::unordered_map<const Metrics::IMetric*, size_t> index_of_;
+    // Registered SingleThreadPolicy metrics, and whether Serve() is on: they exclude each other
+    // (and SetExecutor). Guarded by mutex_.
+    size_t thread_confined_metrics_ = 0;
+    bool serving_ = false;
 
     std::mutex mutex_;
+
+    ScrapePeriod scrape_period_;
+    std::mutex scrape_mutex_;
+
+    std::atomic<MetricsExecution::WorkStealingPool*> executor_{nullptr};
+    std::atomic<size_t> executor_chunk_size_{kDefaultExecutorChunkSize};
+
+    std::atomic<NonBlockingWriter::LogEncoding> log_encoding_{NonBlockingWriter::LogEncoding::Text};
+    std::atomic<uint64_t> dictionary_generation_{1};
+
+    std::atomic<size_t> keyframe_interval_{0};
+    std::atomic<size_t> scrape_count_{0};
+
+    std::atomic<std::shared_ptr<MetricsServer::SharedMemoryWriter>> shared_memory_;
+
+    // Declared last: the server thread reads the registry until it is joined.
+    std::mutex server_mutex_;
+    std::unique_ptr<MetricsServer::HttpServer> server_;
 };
\ No newline at end of file
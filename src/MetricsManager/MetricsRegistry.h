@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+// Append-only array of slots that readers can index without locks.
+//
+// Slots live in segments of geometrically growing size (64, 128, 256, ...). Segments are never
+// moved or freed before the registry itself, so a slot reference stays valid while writers keep
+// appending. Appends must be serialized by the caller; Size() publishes them to readers.
+template <typename Slot, typename Alloc = std::allocator<Slot>>
+class MetricsRegistry {
+private:
+    using SlotAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Slot>;
+    using SlotAllocTraits = std::allocator_traits<SlotAlloc>;
+
+    static constexpr std::size_t kFirstSegmentSize = 64;
+    static constexpr std::size_t kMaxSegments = 48;
+
+public:
+    explicit MetricsRegistry(const Alloc& alloc = Alloc()) : alloc_(alloc) {}
+
+    ~MetricsRegistry() {
+        for (std::size_t segment = 0; segment < kMaxSegments; ++segment) {
+            Slot* slots = segments_[segment].load(std::memory_order_relaxed);
+            if (slots == nullptr) {
+                break;
+            }
+            for (std::size_t i = 0; i < SegmentSize(segment); ++i) {
+                SlotAllocTraits::destroy(alloc_, slots + i);
+            }
+            SlotAllocTraits::deallocate(alloc_, slots, SegmentSize(segment));
+        }
+    }
+
+    MetricsRegistry(const MetricsRegistry& other) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry& other) = delete;
+
+    std::size_t Size() const noexcept {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    // Only valid for index < Size().
+    Slot& operator[](std::size_t index) noexcept {
+        auto [segment, offset] = Locate(index);
+        return segments_[segment].load(std::memory_order_acquire)[offset];
+    }
+
+    const Slot& operator[](std::size_t index) const noexcept {
+        auto [segment, offset] = Locate(index);
+        return segments_[segment].load(std::memory_order_acquire)[offset];
+    }
+
+    // Writer side: returns the slot at index Size(). It becomes visible to readers on Publish().
+    Slot& Reserve() {
+        std::size_t index = size_.load(std::memory_order_relaxed);
+        auto [segment, offset] = Locate(index);
+
+        Slot* slots = segments_[segment].load(std::memory_order_relaxed);
+        if (slots == nullptr) {
+            slots = SlotAllocTraits::allocate(alloc_, SegmentSize(segment));
+            for (std::size_t i = 0; i < SegmentSize(segment); ++i) {
+                SlotAllocTraits::construct(alloc_, slots + i);
+            }
+            segments_[segment].store(slots, std::memory_order_release);
+        }
+
+        return slots[offset];
+    }
+
+    void Publish() noexcept {
+        size_.fetch_add(1, std::memory_order_release);
+    }
+
+private:
+    static constexpr std::size_t SegmentSize(std::size_t segment) noexcept {
+        return kFirstSegmentSize << segment;
+    }
+
+    static std::pair<std::size_t, std::size_t> Locate(std::size_t index) noexcept {
+        std::size_t biased = index / kFirstSegmentSize + 1;
+        std::size_t segment = std::bit_width(biased) - 1;
+        std::size_t segment_begin = kFirstSegmentSize * ((std::size_t{1} << segment) - 1);
+        return {segment, index - segment_begin};
+    }
+
+    SlotAlloc alloc_;
+    std::array<std::atomic<Slot*>, kMaxSegments> segments_{};
+    std::atomic<std::size_t> size_{0};
+};
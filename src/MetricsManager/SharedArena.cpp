@@ -0,0 +1,208 @@
+#include "SharedArena.h"
+
+#include <pthread.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace MetricsMemory;
+
+struct SharedArena::Header {
+    struct Object {
+        char key[kMaxKeySize + 1];
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    // Set last by the creator; attaching processes wait for it.
+    std::atomic<std::uint32_t> magic;
+    std::uint32_t version;
+    std::uint64_t size;
+    // Cross-process mutex guarding the fields below. Only taken to look objects up, which
+    // happens when metrics are constructed, never on update paths. Robust: if a process dies
+    // holding it, the next one to lock it takes it over instead of waiting forever.
+    pthread_mutex_t lock;
+    std::uint32_t object_count;
+    std::uint64_t used;
+    Object objects[kMaxObjects];
+};
+
+namespace {
+    constexpr std::uint32_t kMagic = 0x4D415245; // "MARE"
+    constexpr std::uint32_t kVersion = 2;
+    constexpr std::size_t kObjectAlignment = 64;
+    constexpr auto kAttachTimeout = std::chrono::seconds(5);
+
+    std::size_t AlignUp(std::size_t value, std::size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    class ArenaLockGuard {
+    public:
+        explicit ArenaLockGuard(pthread_mutex_t& lock) : lock_(lock) {
+            int result = pthread_mutex_lock(&lock_);
+            if (result == EOWNERDEAD) {
+                // The owner died inside FindOrAllocate(). It publishes an object by bumping
+                // object_count last, so the fields are consistent: at worst some memory is lost.
+                pthread_mutex_consistent(&lock_);
+            } else if (result != 0) {
+                throw std::runtime_error(std::string("Failed to lock shared arena: ") + std::strerror(result));
+            }
+        }
+        ~ArenaLockGuard() {
+            pthread_mutex_unlock(&lock_);
+        }
+
+    private:
+        pthread_mutex_t& lock_;
+    };
+}
+
+const std::string& SharedArena::Name() const noexcept {
+    return name_;
+}
+
+void* SharedArena::FindOrAllocate(std::string_view key, std::size_t size, std::size_t align, void (*construct)(void*)) {
+    if (key.empty() || key.size() > kMaxKeySize) {
+        throw std::runtime_error("Invalid shared arena key: \"" + std::string(key) + "\"");
+    }
+
+    auto* base = reinterpret_cast<char*>(header_);
+    ArenaLockGuard lock(header_->lock);
+
+    for (std::uint32_t i = 0; i < header_->object_count; ++i) {
+        const auto& object = header_->objects[i];
+        if (key == object.key) {
+            if (object.size != size) {
+                throw std::runtime_error("Shared arena key \"" + std::string(key) + "\" holds an object of another type.");
+            }
+            return base + object.offset;
+        }
+    }
+
+    if (header_->object_count == kMaxObjects) {
+        throw std::runtime_error("Shared arena " + name_ + " has no free object slots.");
+    }
+    // Separate cache lines keep processes updating different series from contending.
+    std::size_t offset = AlignUp(header_->used, std::max(align, kObjectAlignment));
+    if (offset + size > header_->size) {
+        throw std::runtime_error("Shared arena " + name_ + " is out of memory.");
+    }
+
+    construct(base + offset);
+
+    auto& object = header_->objects[header_->object_count];
+    std::memcpy(object.key, key.data(), key.size());
+    object.key[key.size()] = '\0';
+    object.offset = offset;
+    object.size = size;
+    header_->used = offset + size;
+    ++header_->object_count;
+
+    return base + offset;
+}
+
+#ifdef __linux__
+
+SharedArena::SharedArena(const SharedArenaOptions& options) : name_(options.name) {
+    bool creator = true;
+    int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd == -1 && errno == EEXIST) {
+        creator = false;
+        fd = shm_open(name_.c_str(), O_RDWR, 0);
+    }
+    if (fd == -1) {
+        throw std::runtime_error("Failed to open shared arena " + name_ + ": " + std::strerror(errno));
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + kAttachTimeout;
+    if (creator) {
+        size_ = std::max(options.size, AlignUp(sizeof(Header), kObjectAlignment));
+        if (ftruncate(fd, static_cast<off_t>(size_)) == -1) {
+            close(fd);
+            shm_unlink(name_.c_str());
+            throw std::runtime_error("Failed to size shared arena " + name_ + ": " + std::strerror(errno));
+        }
+    } else {
+        // The creator may not have sized the segment yet.
+        struct stat info{};
+        while (fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) < sizeof(Header)
+               && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        size_ = static_cast<std::size_t>(info.st_size);
+        if (size_ < sizeof(Header)) {
+            close(fd);
+            throw std::runtime_error("Shared arena " + name_ + " was not initialized.");
+        }
+    }
+
+    void* memory = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        if (creator) {
+            shm_unlink(name_.c_str());
+        }
+        throw std::runtime_error("Failed to map shared arena " + name_ + ": " + std::strerror(errno));
+    }
+
+    if (creator) {
+        header_ = new (memory) Header{};
+        pthread_mutexattr_t attributes;
+        pthread_mutexattr_init(&attributes);
+        pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+        pthread_mutex_init(&header_->lock, &attributes);
+        pthread_mutexattr_destroy(&attributes);
+        header_->version = kVersion;
+        header_->size = size_;
+        header_->used = sizeof(Header);
+        header_->magic.store(kMagic, std::memory_order_release);
+        return;
+    }
+
+    header_ = static_cast<Header*>(memory);
+    while (header_->magic.load(std::memory_order_acquire) != kMagic && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (header_->magic.load(std::memory_order_acquire) != kMagic || header_->version != kVersion || header_->size != size_) {
+        munmap(memory, size_);
+        header_ = nullptr;
+        throw std::runtime_error("Shared arena " + name_ + " has an unknown layout.");
+    }
+}
+
+SharedArena::~SharedArena() {
+    if (header_ != nullptr) {
+        munmap(header_, size_);
+    }
+}
+
+bool SharedArena::Unlink(const std::string& name) {
+    return shm_unlink(name.c_str()) == 0;
+}
+
+#else
+
+SharedArena::SharedArena(const SharedArenaOptions& options) : name_(options.name) {
+    throw std::runtime_error("Shared arenas are only supported on Linux.");
+}
+
+SharedArena::~SharedArena() = default;
+
+bool SharedArena::Unlink(const std::string&) {
+    return false;
+}
+
+#endif
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace MetricsMemory {
+
+struct SharedArenaOptions {
+    // POSIX shared memory object name, e.g. "/my_service_counters".
+    std::string name;
+    // Total size of the segment; only used by the process that creates it.
+    std::size_t size = 1 << 20;
+};
+
+// Named POSIX shared-memory region holding metric state shared by several processes.
+//
+// The first process to open a name creates the segment, later ones (or children forked after
+// the arena was opened) attach to it. Objects are looked up by key: Find<T>("requests") returns
+// the same object in every process, allocating a zero-filled one on first use. Objects are never
+// freed while the segment exists, and must be usable from raw shared memory: only lock-free
+// atomics and plain data, no pointers.
+class SharedArena {
+public:
+    static constexpr std::size_t kMaxKeySize = 63;
+    static constexpr std::size_t kMaxObjects = 256;
+
+    // Throws std::runtime_error if the segment can't be created or has another layout.
+    explicit SharedArena(const SharedArenaOptions& options);
+    ~SharedArena();
+
+    SharedArena(const SharedArena& other) = delete;
+    SharedArena& operator=(const SharedArena& other) = delete;
+
+    // Removes the name; processes that still map the segment keep using it.
+    static bool Unlink(const std::string& name);
+
+    const std::string& Name() const noexcept;
+
+    // Throws std::runtime_error if the key is too long, the arena is full, or the key already
+    // holds an object of a different size.
+    template <typename T>
+    T& Find(std::string_view key) {
+        static_assert(std::is_trivially_destructible_v<T>, "shared objects are never destroyed");
+        // The object is constructed once, by whichever process allocates it; the others see it
+        // through their own mapping.
+        void* memory = FindOrAllocate(key, sizeof(T), alignof(T), [](void* storage) {
+            new (storage) T{};
+        });
+        return *std::launder(static_cast<T*>(memory));
+    }
+
+private:
+    struct Header;
+
+    void* FindOrAllocate(std::string_view key, std::size_t size, std::size_t align, void (*construct)(void*));
+
+    std::string name_;
+    Header* header_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+}
@@ -0,0 +1,329 @@
+#include "SharedMemoryTable.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <thread>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace MetricsServer;
+using namespace MetricsServer::SharedMemoryLayout;
+
+namespace {
+    // A writer that died in the middle of an update leaves the sequence odd forever, so readers
+    // give up on a slot after this many attempts.
+    constexpr int kMaxReadAttempts = 1 << 16;
+    constexpr int kAttemptsBeforeYield = 64;
+
+    template <std::size_t Capacity>
+    void StoreEntry(Entry<Capacity>& entry, std::string_view text) {
+        text = text.substr(0, Capacity);
+
+        std::uint32_t sequence = entry.sequence.load(std::memory_order_relaxed);
+        entry.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        entry.length.store(static_cast<std::uint32_t>(text.size() + 1), std::memory_order_relaxed);
+        for (std::size_t offset = 0; offset < text.size(); offset += sizeof(std::uint64_t)) {
+            std::uint64_t word = 0;
+            std::memcpy(&word, text.data() + offset, std::min(sizeof(word), text.size() - offset));
+            entry.words[offset / sizeof(word)].store(word, std::memory_order_relaxed);
+        }
+
+        entry.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    template <std::size_t Capacity>
+    void ClearEntry(Entry<Capacity>& entry) {
+        std::uint32_t sequence = entry.sequence.load(std::memory_order_relaxed);
+        entry.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        entry.length.store(0, std::memory_order_relaxed);
+        entry.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Returns the sequence the text was read at, or 0 if the slot is empty or stuck.
+    template <std::size_t Capacity>
+    std::uint32_t LoadEntry(const Entry<Capacity>& entry, std::string& out) {
+        for (int attempt = 0; attempt < kMaxReadAttempts; ++attempt) {
+            if (attempt % kAttemptsBeforeYield == kAttemptsBeforeYield - 1) {
+                std::this_thread::yield();
+            }
+
+            std::uint32_t sequence = entry.sequence.load(std::memory_order_acquire);
+            if (sequence & 1) {
+                continue;
+            }
+
+            std::uint32_t length = entry.length.load(std::memory_order_relaxed);
+            std::size_t size = length == 0 ? 0 : std::min<std::size_t>(length - 1, Capacity);
+            out.resize(size);
+            for (std::size_t offset = 0; offset < size; offset += sizeof(std::uint64_t)) {
+                std::uint64_t word = entry.words[offset / sizeof(word)].load(std::memory_order_relaxed);
+                std::memcpy(out.data() + offset, &word, std::min(sizeof(word), size - offset));
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (entry.sequence.load(std::memory_order_relaxed) == sequence) {
+                return length == 0 ? 0 : sequence + 1;
+            }
+        }
+        return 0;
+    }
+}
+
+SharedMemoryWriter::SharedMemoryWriter(const SharedMemoryOptions& options) : options_(options) {}
+
+SharedMemoryWriter::~SharedMemoryWriter() {
+    Close();
+}
+
+bool SharedMemoryWriter::IsOpen() const noexcept {
+    return header_ != nullptr;
+}
+
+std::size_t SharedMemoryWriter::Capacity() const noexcept {
+    return options_.capacity;
+}
+
+bool SharedMemoryWriter::Publish(std::size_t index, std::string_view name, std::string_view value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (header_ == nullptr || index >= options_.capacity) {
+        return false;
+    }
+
+    if (!names_[index] || *names_[index] != name) {
+        ClearEntry(values_[index]);
+        StoreEntry(directory_[index], name);
+        names_[index] = std::string(name);
+    }
+    StoreEntry(values_[index], value);
+
+    if (header_->used.load(std::memory_order_relaxed) <= index) {
+        header_->used.store(static_cast<std::uint32_t>(index + 1), std::memory_order_release);
+    }
+    return true;
+}
+
+void SharedMemoryWriter::Clear(std::size_t index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (header_ == nullptr || index >= options_.capacity || !names_[index]) {
+        return;
+    }
+
+    ClearEntry(values_[index]);
+    ClearEntry(directory_[index]);
+    names_[index].reset();
+}
+
+void SharedMemoryWriter::Commit() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (header_ == nullptr) {
+        return;
+    }
+
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    header_->update_time_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count(), std::memory_order_relaxed);
+    header_->generation.fetch_add(1, std::memory_order_release);
+}
+
+SharedMemoryReader::~SharedMemoryReader() {
+    Close();
+}
+
+bool SharedMemoryReader::IsOpen() const noexcept {
+    return header_ != nullptr;
+}
+
+void SharedMemoryReader::Read(std::vector<Entry>& out) const {
+    std::size_t count = 0;
+    if (header_ == nullptr) {
+        out.clear();
+        return;
+    }
+
+    std::size_t used = std::min<std::size_t>(header_->used.load(std::memory_order_acquire), header_->capacity);
+    for (std::size_t index = 0; index < used; ++index) {
+        if (count == out.size()) {
+            out.emplace_back();
+        }
+        Entry& entry = out[count];
+
+        // Re-checking the name after the value catches a slot handed to another metric
+        // between the two reads.
+        bool found = false;
+        for (int attempt = 0; attempt < kMaxReadAttempts && !found; ++attempt) {
+            std::uint32_t name_sequence = LoadEntry(directory_[index], entry.name);
+            if (name_sequence == 0 || LoadEntry(values_[index], entry.value) == 0) {
+                break;
+            }
+            found = directory_[index].sequence.load(std::memory_order_acquire) + 1 == name_sequence;
+        }
+
+        if (found) {
+            entry.index = index;
+            ++count;
+        }
+    }
+    out.resize(count);
+}
+
+std::uint64_t SharedMemoryReader::Generation() const noexcept {
+    return header_ == nullptr ? 0 : header_->generation.load(std::memory_order_acquire);
+}
+
+std::int64_t SharedMemoryReader::UpdateTimeNs() const noexcept {
+    return header_ == nullptr ? 0 : header_->update_time_ns.load(std::memory_order_relaxed);
+}
+
+#ifdef __linux__
+
+bool SharedMemoryWriter::Open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (header_ != nullptr) {
+        return true;
+    }
+
+    // Never takes over an existing segment: it may belong to a live writer.
+    int fd = shm_open(options_.name.c_str(), O_CREAT | O_EXCL | O_RDWR, static_cast<mode_t>(options_.mode));
+    if (fd == -1) {
+        std::cerr << "Failed to create shared memory segment " << options_.name << ": " << std::strerror(errno);
+        if (errno == EEXIST) {
+            std::cerr << " (remove a stale segment with SharedMemoryWriter::Unlink)";
+        }
+        std::cerr << std::endl;
+        return false;
+    }
+
+    std::size_t size = SegmentSize(options_.capacity);
+    void* memory = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+        memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (memory == MAP_FAILED) {
+        std::cerr << "Failed to map shared memory segment " << options_.name << ": " << std::strerror(errno) << std::endl;
+        shm_unlink(options_.name.c_str());
+        return false;
+    }
+
+    // The segment is zero-filled; the placement news only start the objects' lifetimes.
+    auto* bytes = static_cast<char*>(memory);
+    header_ = new (bytes) Header{};
+    directory_ = reinterpret_cast<DirectoryEntry*>(bytes + sizeof(Header));
+    values_ = reinterpret_cast<ValueSlot*>(bytes + sizeof(Header) + options_.capacity * sizeof(DirectoryEntry));
+    for (std::size_t i = 0; i < options_.capacity; ++i) {
+        new (directory_ + i) DirectoryEntry{};
+        new (values_ + i) ValueSlot{};
+    }
+    names_.assign(options_.capacity, std::nullopt);
+
+    header_->version = kVersion;
+    header_->capacity = static_cast<std::uint32_t>(options_.capacity);
+    header_->name_capacity = kNameCapacity;
+    header_->value_capacity = kValueCapacity;
+    // Readers check the magic last.
+    std::atomic_ref<std::uint32_t>(header_->magic).store(kMagic, std::memory_order_release);
+
+    return true;
+}
+
+void SharedMemoryWriter::Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (header_ == nullptr) {
+        return;
+    }
+
+    munmap(header_, SegmentSize(options_.capacity));
+    if (options_.unlink_on_close) {
+        shm_unlink(options_.name.c_str());
+    }
+    header_ = nullptr;
+    directory_ = nullptr;
+    values_ = nullptr;
+    names_.clear();
+}
+
+bool SharedMemoryWriter::Unlink(const std::string& name) {
+    return shm_unlink(name.c_str()) == 0;
+}
+
+bool SharedMemoryReader::Open(const std::string& name) {
+    Close();
+
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd == -1) {
+        return false;
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) == -1 || static_cast<std::size_t>(info.st_size) < sizeof(Header)) {
+        close(fd);
+        return false;
+    }
+
+    std::size_t size = static_cast<std::size_t>(info.st_size);
+    void* memory = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        return false;
+    }
+
+    const auto* header = static_cast<const Header*>(memory);
+    std::uint32_t magic = std::atomic_ref<std::uint32_t>(const_cast<std::uint32_t&>(header->magic)).load(std::memory_order_acquire);
+    if (magic != kMagic || header->version != kVersion
+        || header->name_capacity != kNameCapacity || header->value_capacity != kValueCapacity
+        || size < SegmentSize(header->capacity)) {
+        munmap(memory, size);
+        return false;
+    }
+
+    const auto* bytes = static_cast<const char*>(memory);
+    header_ = header;
+    directory_ = reinterpret_cast<const DirectoryEntry*>(bytes + sizeof(Header));
+    values_ = reinterpret_cast<const ValueSlot*>(bytes + sizeof(Header) + header->capacity * sizeof(DirectoryEntry));
+    mapped_size_ = size;
+
+    return true;
+}
+
+void SharedMemoryReader::Close() {
+    if (header_ == nullptr) {
+        return;
+    }
+
+    munmap(const_cast<Header*>(header_), mapped_size_);
+    header_ = nullptr;
+    directory_ = nullptr;
+    values_ = nullptr;
+    mapped_size_ = 0;
+}
+
+#else
+
+bool SharedMemoryWriter::Open() {
+    std::cerr << "Shared memory export is only supported on Linux." << std::endl;
+    return false;
+}
+
+void SharedMemoryWriter::Close() {}
+
+bool SharedMemoryWriter::Unlink(const std::string&) {
+    return false;
+}
+
+bool SharedMemoryReader::Open(const std::string&) {
+    return false;
+}
+
+void SharedMemoryReader::Close() {}
+
+#endif
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MetricsServer {
+
+// Layout of the shared-memory segment, version 1:
+//
+//   Header
+//   DirectoryEntry[capacity]    metric names, rewritten only when a slot changes owner
+//   ValueSlot[capacity]         latest values
+//
+// Slot i holds the metric registered at index i in the manager. Every entry is protected by its
+// own seqlock: the writer makes the sequence odd, stores the payload and makes it even again;
+// a reader retries until it sees the same even sequence before and after copying. Readers never
+// write to the segment, so any number of them can sample it without slowing the writer down.
+// All payload words are accessed atomically, which keeps the protocol free of data races.
+namespace SharedMemoryLayout {
+    inline constexpr std::uint32_t kMagic = 0x4D545243; // "MTRC"
+    inline constexpr std::uint32_t kVersion = 1;
+    inline constexpr std::size_t kNameCapacity = 128;
+    inline constexpr std::size_t kValueCapacity = 256;
+
+    struct alignas(64) Header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t capacity;
+        std::uint32_t name_capacity;
+        std::uint32_t value_capacity;
+        // Number of slots ever used; readers don't need to look past it.
+        std::atomic<std::uint32_t> used;
+        // Incremented after every publish round.
+        std::atomic<std::uint64_t> generation;
+        // system_clock time of the last publish round, in nanoseconds since the epoch.
+        std::atomic<std::int64_t> update_time_ns;
+    };
+
+    template <std::size_t Capacity>
+    struct alignas(64) Entry {
+        std::atomic<std::uint32_t> sequence;
+        // Text size + 1; 0 - the slot is empty.
+        std::atomic<std::uint32_t> length;
+        std::atomic<std::uint64_t> words[Capacity / sizeof(std::uint64_t)];
+    };
+
+    using DirectoryEntry = Entry<kNameCapacity>;
+    using ValueSlot = Entry<kValueCapacity>;
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared memory needs address-free atomics");
+
+    constexpr std::size_t SegmentSize(std::size_t capacity) {
+        return sizeof(Header) + capacity * (sizeof(DirectoryEntry) + sizeof(ValueSlot));
+    }
+}
+
+struct SharedMemoryOptions {
+    // POSIX shared memory object name, e.g. "/my_service_metrics".
+    std::string name;
+    // Metrics at indices >= capacity are not exported.
+    std::size_t capacity = 1024;
+    // Remove the segment when the writer closes it.
+    bool unlink_on_close = true;
+    // Permissions of the created segment; readers of other users need e.g. 0644.
+    unsigned int mode = 0600;
+};
+
+// Writer side of the table. Publishing is serialized by an internal mutex, so several threads
+// may publish into the same segment; readers are never blocked.
+class SharedMemoryWriter {
+public:
+    explicit SharedMemoryWriter(const SharedMemoryOptions& options);
+    ~SharedMemoryWriter();
+
+    SharedMemoryWriter(const SharedMemoryWriter& other) = delete;
+    SharedMemoryWriter& operator=(const SharedMemoryWriter& other) = delete;
+
+    // Creates an empty table. Fails if a segment with the same name exists, e.g. one left by a
+    // crashed writer: remove it with Unlink() first.
+    bool Open();
+    void Close();
+    bool IsOpen() const noexcept;
+
+    // Removes the segment name; readers that still map it keep seeing its last values.
+    static bool Unlink(const std::string& name);
+
+    std::size_t Capacity() const noexcept;
+
+    // Names and values longer than the slot capacity are truncated. Returns false if the index
+    // is outside the table.
+    bool Publish(std::size_t index, std::string_view name, std::string_view value);
+    void Clear(std::size_t index);
+
+    // Marks the end of a publish round: bumps the generation and the update time.
+    void Commit();
+
+private:
+    SharedMemoryLayout::Header* header_ = nullptr;
+    SharedMemoryLayout::DirectoryEntry* directory_ = nullptr;
+    SharedMemoryLayout::ValueSlot* values_ = nullptr;
+
+    SharedMemoryOptions options_;
+    // Names currently in the directory, to skip rewriting them on every publish.
+    std::vector<std::optional<std::string>> names_;
+    std::mutex mutex_;
+};
+
+// Reader side. After Open() reading is plain memory access: no syscalls and no locks.
+class SharedMemoryReader {
+public:
+    struct Entry {
+        std::size_t index;
+        std::string name;
+        std::string value;
+    };
+
+    SharedMemoryReader() = default;
+    ~SharedMemoryReader();
+
+    SharedMemoryReader(const SharedMemoryReader& other) = delete;
+    SharedMemoryReader& operator=(const SharedMemoryReader& other) = delete;
+
+    // Fails if the segment doesn't exist or has a different layout version.
+    bool Open(const std::string& name);
+    void Close();
+    bool IsOpen() const noexcept;
+
+    // Replaces out with a consistent copy of every non-empty slot. Reuses out's storage.
+    void Read(std::vector<Entry>& out) const;
+
+    std::uint64_t Generation() const noexcept;
+    std::int64_t UpdateTimeNs() const noexcept;
+
+private:
+    const SharedMemoryLayout::Header* header_ = nullptr;
+    const SharedMemoryLayout::DirectoryEntry* directory_ = nullptr;
+    const SharedMemoryLayout::ValueSlot* values_ = nullptr;
+    std::size_t mapped_size_ = 0;
+};
+
+}
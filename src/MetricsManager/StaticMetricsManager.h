@@ -0,0 +1,162 @@
+#pragma once
+
+#include "MultiThreadWriter/Writer.h"
+#include "MultiThreadWriter/WriterUtils.h"
+#include "MultiThreadWriter/WriterService.h"
+#include "IMetrics/IMetrics.h"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Metrics manager for a set of metrics known at compile time.
+//
+// Metrics are stored by value in a std::tuple, every call goes to the concrete type (no virtual
+// dispatch), and Log<Tag>() drops the metrics that don't match the tag at compile time.
+template <typename... Ms>
+requires (std::is_base_of_v<Metrics::IMetric, Ms> && ...)
+class StaticMetricsManager {
+private:
+    static inline std::atomic<unsigned long long> counter = 0;
+    static inline std::mutex counter_mutex_;
+    static std::string CreateLogDefaultName() {
+        std::lock_guard<std::mutex> lock(counter_mutex_);
+        return "static_metrics" + std::to_string(++counter) + ".log";
+    }
+
+    template <typename M>
+    struct Holder {
+        Holder() = default;
+
+        template <typename... Args>
+        explicit Holder(std::tuple<Args...> args)
+            : metric(std::make_from_tuple<M>(std::move(args)))
+        {}
+
+        M metric;
+    };
+
+    template <typename M>
+    static constexpr std::size_t CountOf = (std::size_t{std::is_same_v<M, Ms>} + ... + 0);
+
+    template <typename M, std::size_t... Is>
+    static constexpr std::size_t IndexOfImpl(std::index_sequence<Is...>) {
+        std::size_t index = 0;
+        ((std::is_same_v<M, Ms> ? (index = Is, true) : false) || ...);
+        return index;
+    }
+
+public:
+    static constexpr std::size_t kSize = sizeof...(Ms);
+
+    explicit StaticMetricsManager(const std::string& name=CreateLogDefaultName()) : async_writer_(name) {
+        async_writer_.Start();
+    }
+
+    explicit StaticMetricsManager(NonBlockingWriter::WriterService& writer_service,
+                                  const std::string& name=CreateLogDefaultName())
+        : async_writer_(writer_service, name)
+    {
+        async_writer_.Start();
+    }
+
+    // Every argument is a tuple of constructor arguments for the metric at the same position,
+    // e.g. StaticMetricsManager<IncrementMetric, HTTPIncomeMetric>("a.log", std::tuple("Requests", 0), std::tuple()).
+    template <typename... ArgsTuples>
+    requires (sizeof...(ArgsTuples) == sizeof...(Ms))
+    StaticMetricsManager(const std::string& name, ArgsTuples&&... args)
+        : async_writer_(name)
+        , metrics_(std::forward<ArgsTuples>(args)...)
+    {
+        async_writer_.Start();
+    }
+
+    template <typename... ArgsTuples>
+    requires (sizeof...(ArgsTuples) == sizeof...(Ms))
+    StaticMetricsManager(NonBlockingWriter::WriterService& writer_service, const std::string& name, ArgsTuples&&... args)
+        : async_writer_(writer_service, name)
+        , metrics_(std::forward<ArgsTuples>(args)...)
+    {
+        async_writer_.Start();
+    }
+
+    ~StaticMetricsManager() {
+        async_writer_.Stop();
+    }
+
+    StaticMetricsManager(const StaticMetricsManager& other) = delete;
+    StaticMetricsManager& operator=(const StaticMetricsManager& other) = delete;
+    StaticMetricsManager(StaticMetricsManager&& other) = delete;
+    StaticMetricsManager& operator=(StaticMetricsManager&& other) = delete;
+
+    template <std::size_t I>
+    requires (I < kSize)
+    auto& Get() noexcept {
+        return std::get<I>(metrics_).metric;
+    }
+
+    template <typename M>
+    requires (CountOf<M> == 1)
+    M& Get() noexcept {
+        return Get<IndexOfImpl<M>(std::index_sequence_for<Ms...>{})>();
+    }
+
+    template <typename T = MetricTags::DefaultMetricTag>
+    requires (std::is_base_of_v<MetricTags::DefaultMetricTag, T>)
+    void Log() {
+        NonBlockingWriter::ScrapeBatch batch(async_writer_);
+        std::apply([this, &batch](auto&... holders) {
+            (LogIfMatches<T>(batch, holders.metric), ...);
+        }, metrics_);
+        batch.Commit();
+    }
+
+    // Filter known at compile time, e.g. Log<MetricTags::NoneOf<MetricTags::ComputerMetricTag>()>().
+    template <MetricTags::TagFilter Filter>
+    void Log() {
+        NonBlockingWriter::ScrapeBatch batch(async_writer_);
+        std::apply([this, &batch](auto&... holders) {
+            (LogIfSelected<Filter>(batch, holders.metric), ...);
+        }, metrics_);
+        batch.Commit();
+    }
+
+    template <std::size_t I>
+    requires (I < kSize)
+    void Log() {
+        NonBlockingWriter::ScrapeBatch batch(async_writer_);
+        LogMetric(batch, Get<I>());
+        batch.Commit();
+    }
+
+private:
+    template <typename T, typename M>
+    void LogIfMatches(NonBlockingWriter::ScrapeBatch& batch, M& metric) {
+        if constexpr (std::is_base_of_v<T, M>) {
+            LogMetric(batch, metric);
+        }
+    }
+
+    template <MetricTags::TagFilter Filter, typename M>
+    void LogIfSelected(NonBlockingWriter::ScrapeBatch& batch, M& metric) {
+        if constexpr (Filter.Matches(MetricTags::kTagsOf<M>)) {
+            LogMetric(batch, metric);
+        }
+    }
+
+    // Qualified calls bypass the vtable even for metrics that are not final.
+    template <typename M>
+    void LogMetric(NonBlockingWriter::ScrapeBatch& batch, M& metric) {
+        metric.M::Evaluate();
+        batch.AddWith([&metric](std::string& out) { metric.M::AppendName(out); },
+                      [&metric](std::string& out) { metric.M::AppendValue(out); });
+        metric.M::Reset();
+    }
+
+    NonBlockingWriter::AsyncWriter async_writer_;
+    std::tuple<Holder<Ms>...> metrics_;
+};
@@ -0,0 +1,162 @@
+#include "WorkStealingPool.h"
+
+using namespace MetricsExecution;
+
+struct WorkStealingPool::Job {
+    const std::function<void(size_t)>* body;
+    std::atomic<size_t> remaining;
+
+    std::mutex mutex;
+    std::condition_variable done_condition;
+    // Set under the mutex by the task that finishes last; the caller only leaves once it sees
+    // it, so no task touches the job after the caller's stack frame is gone.
+    bool done = false;
+    std::exception_ptr error;
+};
+
+WorkStealingPool::WorkStealingPool(size_t threads) {
+    queues_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back(&WorkStealingPool::WorkerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stop_ = true;
+    }
+    sleep_condition_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+size_t WorkStealingPool::Size() const noexcept {
+    return workers_.size();
+}
+
+void WorkStealingPool::ParallelFor(size_t count, const std::function<void(size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+
+    if (workers_.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+
+    Job job;
+    job.body = &body;
+    job.remaining.store(count, std::memory_order_relaxed);
+
+    // Counted before the pushes so that a task can't be taken before it is counted.
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        pending_.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    // Contiguous ranges per queue: owners walk their range from one end, thieves from the other.
+    size_t queues = queues_.size();
+    for (size_t q = 0; q < queues; ++q) {
+        size_t begin = count * q / queues;
+        size_t end = count * (q + 1) / queues;
+        if (begin == end) {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+        for (size_t i = end; i > begin; --i) {
+            queues_[q]->tasks.push_back(Task{&job, i - 1});
+        }
+    }
+    sleep_condition_.notify_all();
+
+    Task task;
+    while (job.remaining.load(std::memory_order_acquire) != 0 && TrySteal(queues, task)) {
+        Run(task);
+    }
+
+    std::unique_lock<std::mutex> lock(job.mutex);
+    job.done_condition.wait(lock, [&job] { return job.done; });
+    if (job.error) {
+        std::rethrow_exception(job.error);
+    }
+}
+
+bool WorkStealingPool::TryPop(size_t queue, Task& task) {
+    std::lock_guard<std::mutex> lock(queues_[queue]->mutex);
+    auto& tasks = queues_[queue]->tasks;
+    if (tasks.empty()) {
+        return false;
+    }
+
+    task = tasks.back();
+    tasks.pop_back();
+    pending_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool WorkStealingPool::TrySteal(size_t thief, Task& task) {
+    size_t queues = queues_.size();
+    for (size_t offset = 1; offset <= queues; ++offset) {
+        size_t victim = (thief + offset) % queues;
+        if (victim == thief) {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(queues_[victim]->mutex);
+        auto& tasks = queues_[victim]->tasks;
+        if (!tasks.empty()) {
+            task = tasks.front();
+            tasks.pop_front();
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::Run(const Task& task) {
+    Job& job = *task.job;
+    try {
+        (*job.body)(task.index);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(job.mutex);
+        if (!job.error) {
+            job.error = std::current_exception();
+        }
+    }
+
+    if (job.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(job.mutex);
+        job.done = true;
+        job.done_condition.notify_all();
+    }
+}
+
+void WorkStealingPool::WorkerLoop(size_t id) {
+    Task task;
+    while (true) {
+        if (TryPop(id, task) || TrySteal(id, task)) {
+            Run(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleep_condition_.wait(lock, [this] {
+            return stop_ || pending_.load(std::memory_order_relaxed) != 0;
+        });
+        if (stop_) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MetricsExecution {
+
+// Small fork-join pool for splitting a scrape into independent pieces.
+//
+// Every worker owns a deque: it takes tasks from the back of its own deque and, when that runs
+// dry, steals from the front of the others, so a worker stuck on a slow task (a CPU collector
+// reading /proc) doesn't hold back the rest of the job. The thread calling ParallelFor() works
+// on the job too instead of sleeping, which also makes nested calls from inside a task safe.
+class WorkStealingPool {
+public:
+    // threads = 0 runs every job on the calling thread.
+    explicit WorkStealingPool(size_t threads = std::thread::hardware_concurrency());
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool& other) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool& other) = delete;
+
+    // Number of worker threads, not counting callers.
+    size_t Size() const noexcept;
+
+    // Calls body(i) for every i in [0, count) and returns when all calls have finished. Several
+    // threads may run jobs at once. If calls throw, the first exception is rethrown here after
+    // the remaining calls have run.
+    void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
+private:
+    struct Job;
+
+    struct Task {
+        Job* job;
+        size_t index;
+    };
+
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool TryPop(size_t queue, Task& task);
+    bool TrySteal(size_t thief, Task& task);
+    void Run(const Task& task);
+    void WorkerLoop(size_t id);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+
+    // Tasks pushed and not yet taken; idle workers sleep while it is zero.
+    std::atomic<size_t> pending_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_condition_;
+    bool stop_ = false;
+};
+
+}
@@ -0,0 +1,76 @@
+#include "LogDecoder.h"
+
+#include <charconv>
+#include <istream>
+#include <ostream>
+
+using namespace NonBlockingWriter;
+
+namespace {
+    // Splits off the text up to the next tab; the rest of the line if there is none.
+    std::string_view NextField(std::string_view& line) {
+        size_t tab = line.find('\t');
+        std::string_view field = line.substr(0, tab);
+        line.remove_prefix(tab == std::string_view::npos ? line.size() : tab + 1);
+        return field;
+    }
+
+    bool ParseId(std::string_view text, uint64_t& id) {
+        auto result = std::from_chars(text.data(), text.data() + text.size(), id);
+        return !text.empty() && result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+}
+
+bool LogDecoder::DecodeLine(std::string_view line, std::string& out) {
+    if (line.starts_with("T\t")) {
+        timestamp_.assign(line.substr(2));
+        return false;
+    }
+
+    uint64_t id = 0;
+    if (line.starts_with("M\t")) {
+        line.remove_prefix(2);
+        if (!ParseId(NextField(line), id)) {
+            return false;
+        }
+        MetricInfo& info = metrics_[id];
+        info.type.assign(NextField(line));
+        info.unit.assign(NextField(line));
+        info.tags.assign(NextField(line));
+        info.name.assign(line);
+        return false;
+    }
+
+    size_t tab = line.find('\t');
+    if (tab == std::string_view::npos || !ParseId(line.substr(0, tab), id)) {
+        out.assign(line);
+        return true;
+    }
+
+    out.assign(timestamp_);
+    out.push_back(' ');
+    if (const MetricInfo* info = Find(id)) {
+        out.append(info->name);
+    } else {
+        out.append(line.substr(0, tab));
+    }
+    out.append(": ");
+    out.append(line.substr(tab + 1));
+    return true;
+}
+
+const LogDecoder::MetricInfo* LogDecoder::Find(uint64_t id) const {
+    auto it = metrics_.find(id);
+    return it == metrics_.end() ? nullptr : &it->second;
+}
+
+void LogDecoder::Decode(std::istream& in, std::ostream& out) {
+    LogDecoder decoder;
+    std::string line;
+    std::string decoded;
+    while (std::getline(in, line)) {
+        if (decoder.DecodeLine(line, decoded)) {
+            out << decoded << '\n';
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace NonBlockingWriter {
+
+// Turns a log written with LogEncoding::Dictionary back into text lines
+// ("<timestamp> <name>: <value>"). Fields are separated by tabs, shown as "|" here:
+//
+//   T|2025-01-01 12:00:00.000                          ->  (nothing)
+//   M|0|Metrics::IncrementMetric|||"Requests"          ->  (nothing)
+//   0|42                                               ->  2025-01-01 12:00:00.000 "Requests": 42
+//
+// Lines in the text encoding are passed through, so files mixing both decode too.
+class LogDecoder {
+public:
+    struct MetricInfo {
+        std::string type;
+        std::string unit;
+        // Comma-separated tag names, e.g. "server".
+        std::string tags;
+        std::string name;
+    };
+
+    // Returns true and replaces out with the decoded line for samples and text lines. Timestamp
+    // and definition records only update the decoder and return false. Samples of an undefined
+    // id are named after the id.
+    bool DecodeLine(std::string_view line, std::string& out);
+
+    // nullptr if the id hasn't been defined yet.
+    const MetricInfo* Find(uint64_t id) const;
+
+    // Decodes a whole log, one line per sample.
+    static void Decode(std::istream& in, std::ostream& out);
+
+private:
+    std::unordered_map<uint64_t, MetricInfo> metrics_;
+    std::string timestamp_;
+};
+
+}
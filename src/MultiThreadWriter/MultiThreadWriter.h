@@ -1,4 +1,5 @@
 #pragma once
 
 #include "Writer.h"
+#include "WriterService.h"
 #include "WriterUtils.h"
\ No newline at end of file
@@ -6,7 +6,17 @@ namespace NonBlockingWriter {
 AsyncWriter::AsyncWriter(const std::string& filename)
     : filename_(filename)
     , running_(false)
-    , should_stop_(false) {
+    , should_stop_(false)
+    , service_(nullptr)
+    , sink_(nullptr) {
+}
+
+AsyncWriter::AsyncWriter(WriterService& service, const std::string& filename)
+    : filename_(filename)
+    , running_(false)
+    , should_stop_(false)
+    , service_(&service)
+    , sink_(nullptr) {
 }
 
 AsyncWriter::~AsyncWriter() {
@@ -20,6 +30,19 @@ bool AsyncWriter::Start() {
         return true;
     }
     
+    if (service_ != nullptr) {
+        if (!service_->Start()) {
+            return false;
+        }
+        sink_ = service_->OpenSink(filename_);
+        if (sink_ == nullptr) {
+            return false;
+        }
+        should_stop_ = false;
+        running_ = true;
+        return true;
+    }
+    
     file_.open(filename_, std::ios::out | std::ios::app);
     if (!file_.is_open()) {
         std::cerr << "Failed to open file: " << filename_ << std::endl;
@@ -42,6 +65,14 @@ bool AsyncWriter::Start() {
 
 void AsyncWriter::Stop() {
     should_stop_ = true;
+    
+    if (service_ != nullptr) {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        service_->CloseSink(sink_);
+        sink_ = nullptr;
+        running_ = false;
+        return;
+    }
 
     {
         std::lock_guard<std::mutex> lock(queue_mutex_);
@@ -64,6 +95,11 @@ bool AsyncWriter::Write(const std::string& text) {
         return false;
     }
     
+    if (service_ != nullptr) {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        return service_->Write(sink_, std::string(text));
+    }
+    
     {
         std::lock_guard<std::mutex> lock(queue_mutex_);
         text_queue_.push(text);
@@ -73,6 +109,40 @@ bool AsyncWriter::Write(const std::string& text) {
     return true;
 }
 
+bool AsyncWriter::Write(std::string&& text) {
+    if (!running_ || should_stop_) {
+        return false;
+    }
+    
+    if (service_ != nullptr) {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        return service_->Write(sink_, std::move(text));
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        text_queue_.push(std::move(text));
+    }
+    
+    queue_condition_.notify_one();
+    return true;
+}
+
+std::string AsyncWriter::AcquireBuffer() {
+    if (service_ != nullptr) {
+        return service_->AcquireBuffer();
+    }
+    
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    if (free_buffers_.empty()) {
+        return std::string();
+    }
+    
+    std::string buffer = std::move(free_buffers_.back());
+    free_buffers_.pop_back();
+    return buffer;
+}
+
 bool AsyncWriter::IsRunning() const noexcept {
     return running_;
 }
@@ -81,9 +151,11 @@ void AsyncWriter::WriterLoop() noexcept {
     while (!should_stop_) {
         std::unique_lock<std::mutex> lock(queue_mutex_);
         
-        if (text_queue_.empty()) {
-            queue_condition_.wait(lock);
-        }
+        // The predicate is checked under the lock, so a Stop() that lands between the loop
+        // condition and the wait is not lost.
+        queue_condition_.wait(lock, [this]() {
+            return !text_queue_.empty() || should_stop_;
+        });
         
         while (!text_queue_.empty() && !should_stop_) {
             std::string text = std::move(text_queue_.front());
@@ -97,6 +169,11 @@ void AsyncWriter::WriterLoop() noexcept {
             }
             
             lock.lock();
+            
+            if (free_buffers_.size() < kMaxFreeBuffers) {
+                text.clear();
+                free_buffers_.push_back(std::move(text));
+            }
         }
     }
     
@@ -7,12 +7,19 @@
 #include <thread>
 #include <atomic>
 #include <fstream>
+#include <vector>
+
+#include "WriterService.h"
 
 namespace NonBlockingWriter {
 
+// Writes to its file either from its own background thread or, when constructed with a
+// WriterService, through the service's shared I/O thread.
 class AsyncWriter {
 public:
     explicit AsyncWriter(const std::string& filename);
+    
+    AsyncWriter(WriterService& service, const std::string& filename);
 
     ~AsyncWriter();
     
@@ -21,20 +28,32 @@ public:
     void Stop();
     
     bool Write(const std::string& text);
+    
+    bool Write(std::string&& text);
+    
+    // Returns an empty string, reusing the storage of an already written entry when possible.
+    // Filling it and passing it back to Write(std::string&&) avoids allocations in steady state.
+    std::string AcquireBuffer();
 
     bool IsRunning() const noexcept;
 
 private:
+    static constexpr size_t kMaxFreeBuffers = 16;
+    
     std::string filename_;
     std::ofstream file_;
     
     mutable std::mutex queue_mutex_;
     std::queue<std::string> text_queue_;
+    std::vector<std::string> free_buffers_;
     std::condition_variable queue_condition_;
     
     std::atomic<bool> running_;
     std::atomic<bool> should_stop_;
     std::thread writer_thread_;
+    
+    WriterService* service_;
+    WriterService::Sink* sink_;
 
     void WriterLoop() noexcept;
     
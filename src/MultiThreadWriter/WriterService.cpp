@@ -0,0 +1,216 @@
+#include "WriterService.h"
+#include <algorithm>
+#include <iostream>
+
+namespace NonBlockingWriter {
+
+WriterService::Sink::Sink(const std::string& filename)
+    : filename_(filename)
+    , file_(filename, std::ios::out | std::ios::app) {
+}
+
+const std::string& WriterService::Sink::Filename() const noexcept {
+    return filename_;
+}
+
+WriterService::WriterService()
+    : running_(false)
+    , should_stop_(false) {
+}
+
+WriterService::~WriterService() {
+    Stop();
+}
+
+WriterService& WriterService::Default() {
+    static WriterService service;
+    service.Start();
+    return service;
+}
+
+bool WriterService::Start() {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    
+    if (running_) {
+        return true;
+    }
+    
+    should_stop_ = false;
+    running_ = true;
+    
+    // Sinks closed by Stop() stay attached; their writers keep writing after a restart.
+    for (auto& sink : sinks_) {
+        if (sink->stopped_ && !sink->closing_) {
+            sink->file_.open(sink->filename_, std::ios::out | std::ios::app);
+            sink->stopped_ = false;
+            sink->closed_ = false;
+        }
+    }
+    
+    try {
+        writer_thread_ = std::thread(&WriterService::WriterLoop, this);
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to start writer service thread: " << e.what() << std::endl;
+        running_ = false;
+        return false;
+    }
+}
+
+void WriterService::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        should_stop_ = true;
+        queue_condition_.notify_all();
+    }
+    
+    if (writer_thread_.joinable()) {
+        writer_thread_.join();
+    }
+    
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    running_ = false;
+    for (auto& sink : sinks_) {
+        if (sink->file_.is_open()) {
+            sink->file_.close();
+        }
+        sink->closed_ = true;
+        sink->stopped_ = true;
+    }
+    closed_condition_.notify_all();
+}
+
+bool WriterService::IsRunning() const noexcept {
+    return running_;
+}
+
+WriterService::Sink* WriterService::OpenSink(const std::string& filename) {
+    auto sink = std::make_unique<Sink>(filename);
+    if (!sink->file_.is_open()) {
+        std::cerr << "Failed to open file: " << filename << std::endl;
+        return nullptr;
+    }
+    
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    sinks_.push_back(std::move(sink));
+    return sinks_.back().get();
+}
+
+void WriterService::CloseSink(Sink* sink) {
+    if (sink == nullptr) {
+        return;
+    }
+    
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    sink->closing_ = true;
+    if (running_ && !should_stop_) {
+        queue_.push_back(Entry{sink, std::string(), true});
+        queue_condition_.notify_one();
+    }
+    closed_condition_.wait(lock, [this, sink] { return sink->closed_ || !running_; });
+    
+    auto it = std::find_if(sinks_.begin(), sinks_.end(), [sink](const auto& owned) {
+        return owned.get() == sink;
+    });
+    if (it != sinks_.end()) {
+        if ((*it)->file_.is_open()) {
+            (*it)->file_.close();
+        }
+        sinks_.erase(it);
+    }
+}
+
+bool WriterService::Write(Sink* sink, std::string&& text) {
+    if (sink == nullptr) {
+        return false;
+    }
+    
+    {
+        // Checked under the lock: Stop() sets should_stop_ under it and then drains the queue,
+        // so an entry queued here is either written or refused, never dropped.
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (!running_ || should_stop_ || sink->closing_) {
+            return false;
+        }
+        queue_.push_back(Entry{sink, std::move(text), false});
+    }
+    
+    queue_condition_.notify_one();
+    return true;
+}
+
+std::string WriterService::AcquireBuffer() {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    if (free_buffers_.empty()) {
+        return std::string();
+    }
+    
+    std::string buffer = std::move(free_buffers_.back());
+    free_buffers_.pop_back();
+    return buffer;
+}
+
+void WriterService::WriterLoop() noexcept {
+    std::vector<Entry> batch;
+    
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_condition_.wait(lock, [this] { return !queue_.empty() || should_stop_; });
+            
+            if (queue_.empty() && should_stop_) {
+                break;
+            }
+            batch.swap(queue_);
+        }
+        
+        ProcessBatch(batch);
+    }
+}
+
+void WriterService::ProcessBatch(std::vector<Entry>& batch) {
+    std::vector<Sink*> closed;
+    
+    for (auto& entry : batch) {
+        Sink* sink = entry.sink;
+        if (entry.close) {
+            if (sink->file_.is_open()) {
+                sink->file_.flush();
+                sink->file_.close();
+            }
+            closed.push_back(sink);
+            continue;
+        }
+        
+        if (sink->file_.is_open()) {
+            sink->file_ << entry.text << '\n';
+            sink->dirty_ = true;
+        }
+    }
+    
+    for (auto& entry : batch) {
+        Sink* sink = entry.sink;
+        if (sink->dirty_ && sink->file_.is_open()) {
+            sink->file_.flush();
+        }
+        sink->dirty_ = false;
+    }
+    
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    for (auto& entry : batch) {
+        if (!entry.close && free_buffers_.size() < kMaxFreeBuffers) {
+            entry.text.clear();
+            free_buffers_.push_back(std::move(entry.text));
+        }
+    }
+    batch.clear();
+    
+    if (!closed.empty()) {
+        for (Sink* sink : closed) {
+            sink->closed_ = true;
+        }
+        closed_condition_.notify_all();
+    }
+}
+
+}
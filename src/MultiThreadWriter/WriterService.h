@@ -0,0 +1,97 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <fstream>
+
+namespace NonBlockingWriter {
+
+// One background thread writing to any number of files.
+//
+// Writers attached to the service (see AsyncWriter(WriterService&, filename)) push their
+// entries into a single queue. The I/O thread drains the whole queue at once, writes every
+// entry to its file and flushes each touched file once per batch, so many managers share one
+// thread and one wake-up instead of each running its own loop.
+class WriterService {
+public:
+    class Sink;
+
+    WriterService();
+
+    ~WriterService();
+    
+    // Process-wide service. Managers in main() may use it freely; objects with static storage
+    // duration must not outlive it.
+    static WriterService& Default();
+    
+    bool Start();
+    
+    // Writes everything queued so far, closes all sinks and joins the I/O thread. A later
+    // Start() reopens the sinks that haven't been closed with CloseSink().
+    void Stop();
+    
+    bool IsRunning() const noexcept;
+    
+    // Opens filename for appending. Returns nullptr if the file can't be opened.
+    Sink* OpenSink(const std::string& filename);
+    
+    // Returns after every entry queued for the sink has been written and the file is closed.
+    void CloseSink(Sink* sink);
+    
+    bool Write(Sink* sink, std::string&& text);
+    
+    std::string AcquireBuffer();
+
+private:
+    static constexpr size_t kMaxFreeBuffers = 64;
+
+    struct Entry {
+        Sink* sink;
+        std::string text;
+        bool close;
+    };
+
+    void WriterLoop() noexcept;
+    void ProcessBatch(std::vector<Entry>& batch);
+
+    std::vector<std::unique_ptr<Sink>> sinks_;
+
+    mutable std::mutex queue_mutex_;
+    std::vector<Entry> queue_;
+    std::vector<std::string> free_buffers_;
+    std::condition_variable queue_condition_;
+    std::condition_variable closed_condition_;
+    
+    std::atomic<bool> running_;
+    std::atomic<bool> should_stop_;
+    std::thread writer_thread_;
+    
+    WriterService(const WriterService&) = delete;
+    WriterService& operator=(const WriterService&) = delete;
+};
+
+class WriterService::Sink {
+public:
+    explicit Sink(const std::string& filename);
+
+    const std::string& Filename() const noexcept;
+
+private:
+    friend class WriterService;
+
+    std::string filename_;
+    std::ofstream file_;
+    bool dirty_ = false;
+    bool closed_ = false;
+    // Closed by Stop(), reopened by the next Start().
+    bool stopped_ = false;
+    // CloseSink() was called; never reopened.
+    bool closing_ = false;
+};
+
+}
@@ -4,7 +4,13 @@
 #include <string>
 #include <sstream>
 #include <chrono>
+#include <concepts>
+#include <ctime>
+#include <charconv>
+#include <cstdint>
 #include <iomanip>
+#include <string_view>
+#include <vector>
 
 namespace NonBlockingWriter {
 
@@ -38,18 +44,34 @@ public:
         return writer.Write(oss.str());
     }
 
-private:
-    static std::string GetCurrentTimestamp() {
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
+    static constexpr size_t kTimestampBufferSize = 32;
+    
+    // Writes "YYYY-MM-DD HH:MM:SS.mmm" in local time, returns its length.
+    static size_t FormatTimestamp(std::chrono::system_clock::time_point time_point, char (&text)[kTimestampBufferSize]) {
+        auto time_t = std::chrono::system_clock::to_time_t(time_point);
         auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now.time_since_epoch()) % 1000;
+            time_point.time_since_epoch()) % 1000;
         
-        std::ostringstream oss;
-        oss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-        oss << '.' << std::setfill('0') << std::setw(3) << milliseconds.count();
-        
-        return oss.str();
+        std::tm local_time{};
+#ifdef _WIN32
+        localtime_s(&local_time, &time_t);
+#else
+        localtime_r(&time_t, &local_time);
+#endif
+        size_t length = std::strftime(text, sizeof(text) - 4, "%Y-%m-%d %H:%M:%S", &local_time);
+        int ms = static_cast<int>(milliseconds.count());
+        text[length++] = '.';
+        text[length++] = static_cast<char>('0' + ms / 100);
+        text[length++] = static_cast<char>('0' + ms / 10 % 10);
+        text[length++] = static_cast<char>('0' + ms % 10);
+        return length;
+    }
+
+private:
+    static std::string GetCurrentTimestamp() {
+        char text[kTimestampBufferSize];
+        size_t length = FormatTimestamp(std::chrono::system_clock::now(), text);
+        return std::string(text, length);
     }
     
     template<typename T>
@@ -74,4 +96,158 @@ private:
     }
 };
 
+// Line layouts a ScrapeBatch can produce.
+enum class LogEncoding {
+    // "<timestamp> <name>: <value>" for every metric.
+    Text,
+    // Records separated by tabs, see LogDecoder.h:
+    //   T <timestamp>                           start of a scrape, shared by the samples after it
+    //   M <id> <type> <unit> <tags> <name>      defines an id before its first sample in a file
+    //   <id> <value>                            sample
+    Dictionary,
+};
+
+// Collects every metric of one scrape into a single buffer with a single timestamp and hands
+// it to the writer in one Write(). Produces the same lines as WriteMetricWithTimestamp.
+class ScrapeBatch {
+public:
+    explicit ScrapeBatch(AsyncWriter& writer)
+        : ScrapeBatch(writer, std::chrono::system_clock::now())
+    {}
+    
+    // Stamps every line with the given time, e.g. the start of a scrape spread over several batches.
+    ScrapeBatch(AsyncWriter& writer, std::chrono::system_clock::time_point time_point,
+                LogEncoding encoding = LogEncoding::Text)
+        : writer_(writer)
+        , buffer_(writer.AcquireBuffer())
+        , time_point_(time_point)
+        , encoding_(encoding)
+    {}
+    
+    ScrapeBatch(const ScrapeBatch& other) = delete;
+    ScrapeBatch& operator=(const ScrapeBatch& other) = delete;
+    
+    // Text encoding.
+    void Add(std::string_view name, std::string_view value) {
+        AddWith([name](std::string& out) { out.append(name); },
+                [value](std::string& out) { out.append(value); });
+    }
+    
+    // Text encoding, with the name and the value appended straight into the batch buffer
+    // instead of being formatted into temporary strings first.
+    template <std::invocable<std::string&> AppendName, std::invocable<std::string&> AppendValue>
+    void AddWith(AppendName&& append_name, AppendValue&& append_value) {
+        if (timestamp_length_ == 0) {
+            timestamp_length_ = WriterUtils::FormatTimestamp(time_point_, timestamp_);
+        }
+        if (!buffer_.empty()) {
+            buffer_.push_back('\n');
+        }
+        buffer_.append(timestamp_, timestamp_length_);
+        buffer_.push_back(' ');
+        append_name(buffer_);
+        buffer_.append(": ");
+        append_value(buffer_);
+    }
+    
+    // Dictionary encoding: a sample of the metric defined under id.
+    void AddSample(uint64_t id, std::string_view value) {
+        StartRecord();
+        AppendId(id);
+        buffer_.push_back('\t');
+        buffer_.append(value);
+    }
+    
+    // Dictionary encoding: (re)defines id. Must come before the id's first sample in the file.
+    void AddMetadata(uint64_t id, std::string_view type, std::string_view unit,
+                     std::string_view tags, std::string_view name) {
+        StartRecord();
+        buffer_.append("M\t");
+        AppendId(id);
+        defined_ids_.push_back(id);
+        for (std::string_view field : {type, unit, tags, name}) {
+            buffer_.push_back('\t');
+            buffer_.append(field);
+        }
+    }
+    
+    // Appends the lines of another batch of the same scrape and leaves it empty. Lets parts
+    // of a scrape be formatted on different threads and joined in order.
+    void Merge(ScrapeBatch& other) {
+        if (other.Empty()) {
+            return;
+        }
+        defined_ids_.insert(defined_ids_.end(), other.defined_ids_.begin(), other.defined_ids_.end());
+        other.defined_ids_.clear();
+        if (Empty()) {
+            buffer_.swap(other.buffer_);
+            header_length_ = other.header_length_;
+            other.buffer_.clear();
+            return;
+        }
+        
+        // Both halves share the timestamp record; keep only ours.
+        std::string_view body = other.buffer_;
+        body.remove_prefix(other.header_length_);
+        buffer_.push_back('\n');
+        buffer_.append(body);
+        other.buffer_.clear();
+    }
+    
+    bool Empty() const noexcept {
+        return buffer_.empty();
+    }
+    
+    std::chrono::system_clock::time_point TimePoint() const noexcept {
+        return time_point_;
+    }
+    
+    LogEncoding Encoding() const noexcept {
+        return encoding_;
+    }
+    
+    // Dictionary encoding: ids defined by AddMetadata() in this batch and the merged ones.
+    const std::vector<uint64_t>& DefinedIds() const noexcept {
+        return defined_ids_;
+    }
+    
+    // Sends the collected lines. An empty batch writes nothing.
+    bool Commit() {
+        if (Empty()) {
+            return true;
+        }
+        return writer_.Write(std::move(buffer_));
+    }
+    
+private:
+    // Dictionary encoding: opens the batch with its timestamp record.
+    void StartRecord() {
+        if (!buffer_.empty()) {
+            buffer_.push_back('\n');
+            return;
+        }
+        timestamp_length_ = WriterUtils::FormatTimestamp(time_point_, timestamp_);
+        buffer_.append("T\t");
+        buffer_.append(timestamp_, timestamp_length_);
+        buffer_.push_back('\n');
+        header_length_ = buffer_.size();
+    }
+    
+    void AppendId(uint64_t id) {
+        char digits[20];
+        auto result = std::to_chars(digits, digits + sizeof(digits), id);
+        buffer_.append(digits, result.ptr);
+    }
+    
+    AsyncWriter& writer_;
+    std::string buffer_;
+    std::chrono::system_clock::time_point time_point_;
+    LogEncoding encoding_ = LogEncoding::Text;
+    char timestamp_[WriterUtils::kTimestampBufferSize];
+    size_t timestamp_length_ = 0;
+    // Dictionary encoding: size of the leading timestamp record with its newline.
+    size_t header_length_ = 0;
+    std::vector<uint64_t> defined_ids_;
+};
+
 }
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+// A file name for the running test. ctest starts every test in its own process and runs them in
+// parallel with -j, so a per-process counter isn't enough: the name has the test and the pid.
+// index tells apart several files of one test.
+inline std::string TestFileName(std::string_view prefix, std::string_view extension, int index = 0) {
+#ifdef _WIN32
+    int pid = _getpid();
+#else
+    int pid = getpid();
+#endif
+    const ::testing::TestInfo* test = ::testing::UnitTest::GetInstance()->current_test_info();
+    std::string name(prefix);
+    name += test->test_suite_name();
+    name += '_';
+    name += test->name();
+    name += '_' + std::to_string(pid) + '_' + std::to_string(index);
+    name += extension;
+    return name;
+}
@@ -0,0 +1,168 @@
+#include "IMetrics/IncrementMetric.h"
+#include "IMetrics/HTTPIncomeMetric.h"
+#include "IMetrics/LatencyMetric.h"
+#include "IMetrics/CodeTimeMetric.h"
+#include "IMetrics/CPUUsageMetric.h"
+#include "IMetrics/CPUUtilMetric.h"
+#include "IMetrics/OutputBuffer.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace Metrics;
+using namespace std::chrono_literals;
+
+namespace {
+    std::chrono::steady_clock::time_point manual_now{};
+
+    struct ManualClock {
+        static std::chrono::steady_clock::time_point now() noexcept {
+            return manual_now;
+        }
+    };
+
+    thread_local bool counting_allocations = false;
+    thread_local size_t allocation_count = 0;
+
+    class AllocationCounter {
+    public:
+        AllocationCounter() {
+            allocation_count = 0;
+            counting_allocations = true;
+        }
+        ~AllocationCounter() {
+            counting_allocations = false;
+        }
+        size_t Count() const {
+            return allocation_count;
+        }
+    };
+
+    // Formats the metric into a buffer that already has room for it and returns how many
+    // allocations that took.
+    size_t AppendAllocations(const IMetric& metric, OutputBuffer& out) {
+        out.clear();
+        out.reserve(4096);
+        AllocationCounter counter;
+        metric.AppendName(out);
+        out += ": ";
+        metric.AppendValue(out);
+        return counter.Count();
+    }
+
+    void ExpectSameText(const IMetric& metric) {
+        OutputBuffer out;
+        metric.AppendName(out);
+        EXPECT_EQ(out, metric.GetName());
+        out.clear();
+        metric.AppendValue(out);
+        EXPECT_EQ(out, metric.GetValueAsString());
+    }
+}
+
+void* operator new(std::size_t size) {
+    if (counting_allocations) {
+        ++allocation_count;
+    }
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+TEST(AppendValueTest, FormatMatchesStreams) {
+    for (double value : {0.0, 1.0, 0.005, 12.345, 1234567.891, 1e20, 5e-7}) {
+        std::ostringstream fixed;
+        fixed << std::fixed << std::setprecision(2) << value;
+        OutputBuffer out;
+        Format::AppendFixed(out, value, 2);
+        EXPECT_EQ(out, fixed.str()) << value;
+
+        std::ostringstream general;
+        general << value;
+        out.clear();
+        Format::AppendGeneral(out, value);
+        EXPECT_EQ(out, general.str()) << value;
+    }
+
+    OutputBuffer out;
+    Format::AppendInteger(out, 18446744073709551615ULL);
+    Format::AppendInteger(out, -42);
+    EXPECT_EQ(out, "18446744073709551615-42");
+}
+
+TEST(AppendValueTest, IncrementMetric) {
+    IncrementMetric metric("Requests", 12345);
+    ExpectSameText(metric);
+    OutputBuffer out;
+    EXPECT_EQ(AppendAllocations(metric, out), 0);
+    EXPECT_EQ(out, "Requests: 12345");
+}
+
+TEST(AppendValueTest, HTTPIncomeMetric) {
+    BasicHTTPIncomeMetric<ManualClock> metric;
+    ++metric;
+    manual_now += 1s;
+    metric.Evaluate();
+    ExpectSameText(metric);
+    OutputBuffer out;
+    EXPECT_EQ(AppendAllocations(metric, out), 0);
+    EXPECT_EQ(out, "\"HTTPS requests RPS\": 1.00");
+}
+
+TEST(AppendValueTest, LatencyMetric) {
+    LatencyMetric metric;
+    for (int i = 1; i <= 1000; ++i) {
+        metric.Observe(std::chrono::nanoseconds(i * 12345));
+    }
+    ExpectSameText(metric);
+    OutputBuffer out;
+    EXPECT_EQ(AppendAllocations(metric, out), 0);
+    EXPECT_NE(out.find("P999: "), std::string::npos);
+}
+
+TEST(AppendValueTest, CodeTimeMetric) {
+    CodeTimeMetric metric("\"Sorting\"");
+    metric.Start();
+    std::this_thread::sleep_for(2ms);
+    metric.Stop();
+    ExpectSameText(metric);
+    OutputBuffer out;
+    EXPECT_EQ(AppendAllocations(metric, out), 0);
+    EXPECT_NE(out.find(" ms"), std::string::npos);
+}
+
+TEST(AppendValueTest, CPUMetrics) {
+    CPUUsageMetric usage;
+    usage.Evaluate();
+    ExpectSameText(usage);
+    OutputBuffer out;
+    EXPECT_EQ(AppendAllocations(usage, out), 0);
+
+    CPUMetric util;
+    util.Evaluate();
+    ExpectSameText(util);
+    EXPECT_EQ(AppendAllocations(util, out), 0);
+}
+
+TEST(AppendValueTest, AppendsWithoutClearing) {
+    IncrementMetric metric("Errors", 3);
+    OutputBuffer out = "prefix ";
+    metric.AppendValue(out);
+    EXPECT_EQ(out, "prefix 3");
+}
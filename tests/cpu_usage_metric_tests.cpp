@@ -65,6 +65,12 @@ TEST_F(CPUUsageMetricTest, GetName) {
     EXPECT_EQ(metric->GetName(), "\"CPU Usage\"");
 }
 
+TEST_F(CPUUsageMetricTest, MinEvaluateInterval) {
+    EXPECT_EQ(metric->MinEvaluateInterval(), std::chrono::nanoseconds::zero());
+    Metrics::CPUUsageMetric cached(std::chrono::seconds(1));
+    EXPECT_EQ(cached.MinEvaluateInterval(), std::chrono::seconds(1));
+}
+
 TEST_F(CPUUsageMetricTest, InitialState) {
     std::string initial_value = metric->GetValueAsString();
     EXPECT_TRUE(isValidPercentageFormat(initial_value));
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include "MetricsManager/EpochReclaimer.h"
+#include "MetricsManager/MetricsArena.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace MetricsMemory;
+
+namespace {
+
+class CountedMetric final : public Metrics::IMetric {
+public:
+    explicit CountedMetric(std::atomic<int>* destroyed) : destroyed_(destroyed) {}
+    ~CountedMetric() override { destroyed_->fetch_add(1); }
+
+    std::string GetName() const override { return "Counted"; }
+    std::string GetValueAsString() const override { return std::to_string(value_.load()); }
+    void Evaluate() override {}
+    void Reset() override { value_ = 0; }
+
+    void Touch() { ++value_; }
+
+private:
+    std::atomic<int>* destroyed_;
+    std::atomic<int> value_{0};
+};
+
+}
+
+class EpochReclaimerTest : public ::testing::Test {
+protected:
+    MetricPtr Make() {
+        return arena_.Create<CountedMetric>(&destroyed_).second;
+    }
+
+    MetricsArena arena_;
+    EpochReclaimer reclaimer_;
+    std::atomic<int> destroyed_{0};
+};
+
+TEST_F(EpochReclaimerTest, ReclaimWithoutReadersDestroysImmediately) {
+    reclaimer_.Retire(Make());
+    EXPECT_EQ(reclaimer_.PendingCount(), 1);
+
+    EXPECT_EQ(reclaimer_.Reclaim(), 1);
+    EXPECT_EQ(destroyed_, 1);
+    EXPECT_EQ(reclaimer_.PendingCount(), 0);
+}
+
+TEST_F(EpochReclaimerTest, PinnedReaderDelaysReclamation) {
+    auto guard = reclaimer_.Pin();
+    reclaimer_.Retire(Make());
+
+    EXPECT_EQ(reclaimer_.Reclaim(), 0);
+    EXPECT_EQ(destroyed_, 0);
+
+    guard.Release();
+    EXPECT_EQ(reclaimer_.Reclaim(), 1);
+    EXPECT_EQ(destroyed_, 1);
+}
+
+TEST_F(EpochReclaimerTest, CallbackRunsAfterDestruction) {
+    int destroyed_before_callback = -1;
+    auto guard = reclaimer_.Pin();
+    reclaimer_.Retire(Make(), [&] { destroyed_before_callback = destroyed_; });
+
+    EXPECT_EQ(reclaimer_.Reclaim(), 0);
+    EXPECT_EQ(destroyed_before_callback, -1);
+
+    guard.Release();
+    EXPECT_EQ(reclaimer_.Reclaim(), 1);
+    EXPECT_EQ(destroyed_before_callback, 1);
+}
+
+TEST_F(EpochReclaimerTest, ReaderPinnedAfterRetireDoesNotDelay) {
+    reclaimer_.Retire(Make());
+    auto guard = reclaimer_.Pin();
+
+    EXPECT_EQ(reclaimer_.Reclaim(), 1);
+    EXPECT_EQ(destroyed_, 1);
+}
+
+TEST_F(EpochReclaimerTest, OnlyOlderRetirementsAreReclaimed) {
+    reclaimer_.Retire(Make());
+    auto guard = reclaimer_.Pin();
+    reclaimer_.Retire(Make());
+
+    EXPECT_EQ(reclaimer_.Reclaim(), 1);
+    EXPECT_EQ(reclaimer_.PendingCount(), 1);
+
+    guard.Release();
+    EXPECT_EQ(reclaimer_.Reclaim(), 1);
+    EXPECT_EQ(destroyed_, 2);
+}
+
+TEST_F(EpochReclaimerTest, MovedGuardKeepsPin) {
+    auto guard = reclaimer_.Pin();
+    reclaimer_.Retire(Make());
+
+    EpochReclaimer::Guard moved = std::move(guard);
+    guard.Release();
+    EXPECT_EQ(reclaimer_.Reclaim(), 0);
+
+    moved.Release();
+    EXPECT_EQ(reclaimer_.Reclaim(), 1);
+}
+
+TEST_F(EpochReclaimerTest, DestructorReclaimsPending) {
+    {
+        EpochReclaimer reclaimer;
+        auto guard = reclaimer.Pin();
+        reclaimer.Retire(Make());
+        guard.Release();
+    }
+    EXPECT_EQ(destroyed_, 1);
+}
+
+TEST_F(EpochReclaimerTest, ConcurrentReadersNeverSeeReclaimedMetric) {
+    constexpr int kRounds = 2000;
+    std::atomic<CountedMetric*> current{nullptr};
+    std::atomic<bool> stop{false};
+
+    auto [first, first_owner] = arena_.Create<CountedMetric>(&destroyed_);
+    current = first;
+    MetricPtr owner = std::move(first_owner);
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            while (!stop) {
+                auto guard = reclaimer_.Pin();
+                CountedMetric* metric = current.load();
+                metric->Touch();
+                EXPECT_FALSE(metric->GetValueAsString().empty());
+            }
+        });
+    }
+
+    for (int i = 0; i < kRounds; ++i) {
+        auto [next, next_owner] = arena_.Create<CountedMetric>(&destroyed_);
+        current.store(next);
+        reclaimer_.Retire(std::exchange(owner, std::move(next_owner)));
+        reclaimer_.Reclaim();
+    }
+
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    reclaimer_.Reclaim();
+    EXPECT_EQ(destroyed_, kRounds);
+}
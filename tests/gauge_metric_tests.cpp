@@ -0,0 +1,150 @@
+#include "IMetrics/GaugeMetric.h"
+#include "MetricsManager/MetricsManager.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+using namespace Metrics;
+using namespace std::chrono_literals;
+
+TEST(GaugeMetricTest, SetAddSub) {
+    GaugeMetric gauge("\"Queue\"", 5.0);
+    EXPECT_DOUBLE_EQ(gauge.Value(), 5.0);
+    gauge.Add(2.5);
+    EXPECT_DOUBLE_EQ(gauge.Value(), 7.5);
+    gauge.Sub(10.0);
+    EXPECT_DOUBLE_EQ(gauge.Value(), -2.5);
+    gauge.Set(3.0);
+    EXPECT_DOUBLE_EQ(gauge.Value(), 3.0);
+    EXPECT_EQ(gauge.GetName(), "\"Queue\"");
+}
+
+TEST(GaugeMetricTest, DefaultNamesAreUnique) {
+    GaugeMetric first;
+    GaugeMetric second;
+    EXPECT_NE(first.GetName(), second.GetName());
+    EXPECT_NE(first.GetName().find("GaugeMetric"), std::string::npos);
+}
+
+TEST(GaugeMetricTest, ReportsValueOfLastEvaluate) {
+    GaugeMetric gauge("\"Pool\"", 1.0);
+    EXPECT_EQ(gauge.GetValueAsString(), "1.00 (min: 1.00, max: 1.00, avg: 1.00)");
+    gauge.Set(4.0);
+    EXPECT_DOUBLE_EQ(std::get<Snapshot::Gauge>(gauge.GetSnapshot()).value, 1.0);
+    gauge.Evaluate();
+    EXPECT_DOUBLE_EQ(std::get<Snapshot::Gauge>(gauge.GetSnapshot()).value, 4.0);
+    EXPECT_TRUE(gauge.GetValueAsString().starts_with("4.00 (min: 1.00, max: 4.00, avg: "));
+}
+
+TEST(GaugeMetricTest, MinMaxPerInterval) {
+    GaugeMetric gauge("\"InFlight\"");
+    gauge.Add(10.0);
+    gauge.Sub(15.0);
+    gauge.Set(2.0);
+    gauge.Evaluate();
+    auto stats = gauge.LastInterval();
+    EXPECT_DOUBLE_EQ(stats.value, 2.0);
+    EXPECT_DOUBLE_EQ(stats.min, -5.0);
+    EXPECT_DOUBLE_EQ(stats.max, 10.0);
+
+    // The next interval starts from the current value.
+    gauge.Add(1.0);
+    gauge.Evaluate();
+    stats = gauge.LastInterval();
+    EXPECT_DOUBLE_EQ(stats.min, 2.0);
+    EXPECT_DOUBLE_EQ(stats.max, 3.0);
+
+    gauge.Evaluate();
+    stats = gauge.LastInterval();
+    EXPECT_DOUBLE_EQ(stats.min, 3.0);
+    EXPECT_DOUBLE_EQ(stats.max, 3.0);
+    EXPECT_DOUBLE_EQ(stats.average, 3.0);
+}
+
+TEST(GaugeMetricTest, TimeWeightedAverage) {
+    GaugeMetric gauge("\"Occupancy\"");
+    gauge.Evaluate();
+    std::this_thread::sleep_for(50ms);
+    gauge.Set(100.0);
+    std::this_thread::sleep_for(150ms);
+    gauge.Evaluate();
+    // 0 for ~1/4 of the interval and 100 for ~3/4; sleeps may overshoot.
+    double average = gauge.LastInterval().average;
+    EXPECT_GT(average, 40.0);
+    EXPECT_LT(average, 95.0);
+}
+
+TEST(GaugeMetricTest, ConcurrentAddSub) {
+    GaugeMetric gauge("\"Concurrent\"");
+    const int num_threads = 8;
+    const int operations_per_thread = 10000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&gauge, i] {
+            for (int j = 0; j < operations_per_thread; ++j) {
+                if (i % 2 == 0) {
+                    gauge.Add(1.0);
+                } else {
+                    gauge.Sub(1.0);
+                }
+            }
+        });
+    }
+    for (int i = 0; i < 50; ++i) {
+        gauge.Evaluate();
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_DOUBLE_EQ(gauge.Value(), 0.0);
+    gauge.Evaluate();
+    auto stats = gauge.LastInterval();
+    EXPECT_LE(stats.min, stats.value);
+    EXPECT_GE(stats.max, stats.value);
+}
+
+TEST(GaugeMetricTest, Reset) {
+    GaugeMetric gauge("\"Reset\"", 7.0);
+    gauge.Add(3.0);
+    gauge.Evaluate();
+    gauge.Reset();
+    // The value stays; the next interval starts at it.
+    EXPECT_DOUBLE_EQ(gauge.Value(), 10.0);
+    EXPECT_TRUE(gauge.GetValueAsString().starts_with("10.00 (min: 7.00, max: 10.00, avg: ")) << gauge.GetValueAsString();
+    gauge.Sub(4.0);
+    gauge.Evaluate();
+    auto stats = gauge.LastInterval();
+    EXPECT_DOUBLE_EQ(stats.value, 6.0);
+    EXPECT_DOUBLE_EQ(stats.min, 6.0);
+    EXPECT_DOUBLE_EQ(stats.max, 10.0);
+}
+
+TEST(GaugeMetricTest, LoggedByManager) {
+    std::string log_name = "test_gauge_metric.log";
+    {
+        MetricsManager manager(log_name);
+        auto* gauge = manager.CreateMetric<GaugeMetric>("\"Queue length\"");
+        gauge->Set(12.0);
+        manager.Log();
+        // The scrape between Add and Sub must not lose the added value.
+        gauge->Add(5.0);
+        manager.Log();
+        gauge->Sub(5.0);
+        manager.Log();
+    }
+    std::ifstream log(log_name);
+    std::string content((std::istreambuf_iterator<char>(log)), std::istreambuf_iterator<char>());
+    EXPECT_NE(content.find("\"Queue length\": 12.00 (min: 0.00, max: 12.00, avg: "), std::string::npos) << content;
+    EXPECT_NE(content.find("\"Queue length\": 17.00 (min: 12.00, max: 17.00, avg: "), std::string::npos) << content;
+    EXPECT_NE(content.find("\"Queue length\": 12.00 (min: 12.00, max: 17.00, avg: "), std::string::npos) << content;
+    EXPECT_EQ(content.find("-5.00"), std::string::npos) << content;
+    log.close();
+    std::filesystem::remove(log_name);
+}
@@ -1,28 +1,68 @@
 #include "IMetrics/HTTPIncomeMetric.h"
+#include "MetricsManager/MetricsManager.h"
 
 #include <gtest/gtest.h>
 #include <thread>
 #include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <memory>
 #include <sstream>
 #include <iomanip>
 #include <vector>
 #include <random>
 #include <atomic>
+#include <cmath>
 
 using namespace Metrics;
+using namespace std::chrono_literals;
+
+namespace {
+    // Tests move time by hand, so rates don't depend on how fast they run.
+    std::atomic<std::chrono::steady_clock::duration::rep> fake_now{std::chrono::steady_clock::duration(1000s).count()};
+
+    std::chrono::steady_clock::time_point FakeNow() noexcept {
+        return std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(fake_now.load()));
+    }
+
+    void AdvanceFakeClock(std::chrono::steady_clock::duration duration) {
+        fake_now += duration.count();
+    }
+
+    struct FakeClock {
+        static std::chrono::steady_clock::time_point now() noexcept {
+            return FakeNow();
+        }
+    };
+
+    using TestHTTPIncomeMetric = BasicHTTPIncomeMetric<FakeClock>;
+
+    // The start argument is deprecated; it must still be accepted and ignored.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    HTTPIncomeMetric WithIgnoredStart(unsigned long long start) {
+        return HTTPIncomeMetric(start);
+    }
+#pragma GCC diagnostic pop
+}
 
 class HTTPIncomeMetricTest : public ::testing::Test {
 protected:
     void SetUp() override {
-        metric = std::make_unique<HTTPIncomeMetric>();
+        metric = std::make_unique<TestHTTPIncomeMetric>();
+    }
+
+    // Ends the current second and scrapes.
+    void Tick() {
+        AdvanceFakeClock(1s);
+        metric->Evaluate();
     }
 
     void TearDown() override {
         metric->Reset();
     }
 
-    std::unique_ptr<HTTPIncomeMetric> metric;
+    std::unique_ptr<TestHTTPIncomeMetric> metric;
 
     bool isValidDoubleString(const std::string& str) {
         try {
@@ -42,7 +82,7 @@ protected:
         return decimal_part.length() == 2;
     }
 
-    void simulateHttpRequests(HTTPIncomeMetric& metric, int request_count, int delay_ms = 0) {
+    void simulateHttpRequests(TestHTTPIncomeMetric& metric, int request_count, int delay_ms = 0) {
         for (int i = 0; i < request_count; ++i) {
             ++metric;
             if (delay_ms > 0) {
@@ -51,7 +91,7 @@ protected:
         }
     }
 
-    void simulateHttpRequestsBurst(HTTPIncomeMetric& metric, int burst_count, int requests_per_burst, int burst_interval_ms) {
+    void simulateHttpRequestsBurst(TestHTTPIncomeMetric& metric, int burst_count, int requests_per_burst, int burst_interval_ms) {
         for (int i = 0; i < burst_count; ++i) {
             for (int j = 0; j < requests_per_burst; ++j) {
                 ++metric;
@@ -71,7 +111,7 @@ TEST_F(HTTPIncomeMetricTest, ConstructorDoesNotThrow) {
 
 TEST_F(HTTPIncomeMetricTest, ConstructorWithStartValueDoesNotThrow) {
     EXPECT_NO_THROW({
-        HTTPIncomeMetric test_metric(100);
+        auto test_metric = WithIgnoredStart(100);
     });
 }
 
@@ -83,7 +123,7 @@ TEST_F(HTTPIncomeMetricTest, ConstructorInitializesValidState) {
 }
 
 TEST_F(HTTPIncomeMetricTest, ConstructorWithStartValueInitializesCorrectly) {
-    HTTPIncomeMetric custom_metric(50);
+    auto custom_metric = WithIgnoredStart(50);
     std::string initial_value = custom_metric.GetValueAsString();
     EXPECT_TRUE(isValidDoubleString(initial_value));
     EXPECT_TRUE(hasCorrectPrecision(initial_value));
@@ -102,7 +142,7 @@ TEST_F(HTTPIncomeMetricTest, GetNameIsConsistent) {
 
 TEST_F(HTTPIncomeMetricTest, GetNameUnchangedAfterOperations) {
     ++(*metric);
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("\"HTTPS requests RPS\"", metric->GetName());
     
     metric->Reset();
@@ -127,7 +167,7 @@ TEST_F(HTTPIncomeMetricTest, GetValueAsStringReturnsNonNegative) {
 
 TEST_F(HTTPIncomeMetricTest, GetValueAsStringMatchesExpectedFormat) {
     ++(*metric);
-    metric->Evaluate();
+    Tick();
     
     std::string value_str = metric->GetValueAsString();
     double value = std::stod(value_str);
@@ -146,8 +186,8 @@ TEST_F(HTTPIncomeMetricTest, PostIncrementDoesNotThrow) {
 }
 
 TEST_F(HTTPIncomeMetricTest, IncrementReturnsReference) {
-    HTTPIncomeMetric& ref1 = ++(*metric);
-    HTTPIncomeMetric& ref2 = (*metric)++;
+    TestHTTPIncomeMetric& ref1 = ++(*metric);
+    TestHTTPIncomeMetric& ref2 = (*metric)++;
     
     EXPECT_EQ(&ref1, metric.get());
     EXPECT_EQ(&ref2, metric.get());
@@ -162,11 +202,11 @@ TEST_F(HTTPIncomeMetricTest, MultipleIncrementsWork) {
 }
 
 TEST_F(HTTPIncomeMetricTest, EvaluateDoesNotThrow) {
-    EXPECT_NO_THROW(metric->Evaluate());
+    EXPECT_NO_THROW(Tick());
 }
 
 TEST_F(HTTPIncomeMetricTest, EvaluateAfterNoRequestsReturnsZero) {
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("0.00", metric->GetValueAsString());
 }
 
@@ -175,7 +215,7 @@ TEST_F(HTTPIncomeMetricTest, EvaluateCalculatesCorrectRPS) {
         ++(*metric);
     }
     
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("5.00", metric->GetValueAsString());
 }
 
@@ -183,33 +223,33 @@ TEST_F(HTTPIncomeMetricTest, ConsecutiveEvaluatesWork) {
     for (int i = 0; i < 3; ++i) {
         ++(*metric);
     }
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("3.00", metric->GetValueAsString());
     
     for (int i = 0; i < 2; ++i) {
         ++(*metric);
     }
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("2.00", metric->GetValueAsString());
 }
 
 TEST_F(HTTPIncomeMetricTest, EvaluateCalculatesIncrementalRequests) {
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("0.00", metric->GetValueAsString());
     
     for (int i = 0; i < 10; ++i) {
         ++(*metric);
     }
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("10.00", metric->GetValueAsString());
     
     for (int i = 0; i < 5; ++i) {
         ++(*metric);
     }
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("5.00", metric->GetValueAsString());
     
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("0.00", metric->GetValueAsString());
 }
 
@@ -217,40 +257,43 @@ TEST_F(HTTPIncomeMetricTest, ResetDoesNotThrow) {
     EXPECT_NO_THROW(metric->Reset());
 }
 
-TEST_F(HTTPIncomeMetricTest, ResetSetsValueToZero) {
+TEST_F(HTTPIncomeMetricTest, ResetKeepsRate) {
     for (int i = 0; i < 10; ++i) {
         ++(*metric);
     }
-    metric->Evaluate();
+    Tick();
     
     metric->Reset();
-    EXPECT_EQ("0.00", metric->GetValueAsString());
+    EXPECT_EQ("10.00", metric->GetValueAsString());
+    metric->Evaluate();
+    EXPECT_EQ("10.00", metric->GetValueAsString());
 }
 
-TEST_F(HTTPIncomeMetricTest, ResetClearsInternalCounters) {
+TEST_F(HTTPIncomeMetricTest, ResetKeepsWindow) {
     for (int i = 0; i < 15; ++i) {
         ++(*metric);
     }
-    metric->Evaluate();
+    Tick();
     
     metric->Reset();
     
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("0.00", metric->GetValueAsString());
     
     for (int i = 0; i < 3; ++i) {
         ++(*metric);
     }
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("3.00", metric->GetValueAsString());
+    EXPECT_DOUBLE_EQ(metric->GetRates().last_10s, 6.0);
 }
 
 TEST_F(HTTPIncomeMetricTest, ConsecutiveResetsWork) {
     for (int i = 0; i < 3; ++i) {
         ++(*metric);
-        metric->Evaluate();
+        Tick();
         metric->Reset();
-        EXPECT_EQ("0.00", metric->GetValueAsString()) << "Reset " << (i + 1) << " failed";
+        EXPECT_EQ("1.00", metric->GetValueAsString()) << "Reset " << (i + 1) << " failed";
     }
 }
 
@@ -271,7 +314,7 @@ TEST_F(HTTPIncomeMetricTest, ConcurrentIncrementsAreThreadSafe) {
         t.join();
     }
     
-    metric->Evaluate();
+    Tick();
     double total_expected = num_threads * requests_per_thread;
     double actual = std::stod(metric->GetValueAsString());
     
@@ -290,7 +333,7 @@ TEST_F(HTTPIncomeMetricTest, ConcurrentEvaluatesAreThreadSafe) {
     for (int i = 0; i < num_threads; ++i) {
         threads.emplace_back([this, &completed_evaluations]() {
             for (int j = 0; j < 10; ++j) {
-                EXPECT_NO_THROW(metric->Evaluate());
+                EXPECT_NO_THROW(Tick());
                 std::string value = metric->GetValueAsString();
                 EXPECT_TRUE(isValidDoubleString(value));
                 ++completed_evaluations;
@@ -326,7 +369,7 @@ TEST_F(HTTPIncomeMetricTest, ConcurrentIncrementsAndEvaluates) {
     for (int i = 0; i < evaluate_threads; ++i) {
         threads.emplace_back([this, evaluations_per_thread, &should_stop]() {
             for (int j = 0; j < evaluations_per_thread && !should_stop; ++j) {
-                EXPECT_NO_THROW(metric->Evaluate());
+                EXPECT_NO_THROW(Tick());
                 std::string value = metric->GetValueAsString();
                 EXPECT_TRUE(isValidDoubleString(value));
                 std::this_thread::sleep_for(std::chrono::milliseconds(10));
@@ -340,7 +383,7 @@ TEST_F(HTTPIncomeMetricTest, ConcurrentIncrementsAndEvaluates) {
     
     should_stop = true;
     
-    metric->Evaluate();
+    Tick();
     std::string final_value = metric->GetValueAsString();
     EXPECT_TRUE(isValidDoubleString(final_value));
 }
@@ -358,7 +401,7 @@ TEST_F(HTTPIncomeMetricTest, ConcurrentResetAndOperations) {
     
     threads.emplace_back([this, &should_stop]() {
         for (int i = 0; i < 50 && !should_stop; ++i) {
-            EXPECT_NO_THROW(metric->Evaluate());
+            EXPECT_NO_THROW(Tick());
             std::this_thread::sleep_for(std::chrono::milliseconds(5));
         }
     });
@@ -379,8 +422,9 @@ TEST_F(HTTPIncomeMetricTest, ConcurrentResetAndOperations) {
     }
     
     metric->Reset();
+    Tick();
     ++(*metric);
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("1.00", metric->GetValueAsString());
 }
 
@@ -409,7 +453,7 @@ TEST_F(HTTPIncomeMetricTest, HighVolumeIncrementsPerformance) {
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
     EXPECT_LT(duration.count(), 1000) << "100k increments took too long: " << duration.count() << "ms";
     
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ(std::to_string(num_requests) + ".00", metric->GetValueAsString());
 }
 
@@ -419,7 +463,7 @@ TEST_F(HTTPIncomeMetricTest, EvaluateCompletesQuickly) {
     }
     
     auto start = std::chrono::high_resolution_clock::now();
-    metric->Evaluate();
+    Tick();
     auto end = std::chrono::high_resolution_clock::now();
     
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
@@ -431,10 +475,10 @@ TEST_F(HTTPIncomeMetricTest, SimulatedHttpRequestsBurst) {
         ++(*metric);
     }
     
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("50.00", metric->GetValueAsString());
     
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("0.00", metric->GetValueAsString());
 }
 
@@ -446,7 +490,7 @@ TEST_F(HTTPIncomeMetricTest, SimulatedSteadyTraffic) {
         for (int j = 0; j < request_intervals[i]; ++j) {
             ++(*metric);
         }
-        metric->Evaluate();
+        Tick();
         EXPECT_EQ(expected_values[i], metric->GetValueAsString()) 
             << "Interval " << i << " failed";
     }
@@ -468,7 +512,7 @@ TEST_F(HTTPIncomeMetricTest, SimulatedVariableLoad) {
             ++(*metric);
         }
         
-        metric->Evaluate();
+        Tick();
         actual_values.push_back(metric->GetValueAsString());
         
         std::ostringstream expected;
@@ -480,7 +524,7 @@ TEST_F(HTTPIncomeMetricTest, SimulatedVariableLoad) {
 
 TEST_F(HTTPIncomeMetricTest, ZeroRequestsConsistentBehavior) {
     for (int i = 0; i < 5; ++i) {
-        metric->Evaluate();
+        Tick();
         EXPECT_EQ("0.00", metric->GetValueAsString()) << "Evaluation " << i << " failed";
     }
 }
@@ -492,7 +536,7 @@ TEST_F(HTTPIncomeMetricTest, LargeNumberOfRequests) {
         ++(*metric);
     }
     
-    metric->Evaluate();
+    Tick();
     
     std::ostringstream expected;
     expected << std::fixed << std::setprecision(2) << static_cast<double>(large_number);
@@ -509,7 +553,7 @@ TEST_F(HTTPIncomeMetricTest, ValueStringFormatConsistency) {
             ++(*metric);
         }
         
-        metric->Evaluate();
+        Tick();
         std::string result = metric->GetValueAsString();
         
         EXPECT_TRUE(hasCorrectPrecision(result)) << "Value " << value << " has incorrect precision";
@@ -524,10 +568,16 @@ TEST_F(HTTPIncomeMetricTest, ValueStringFormatConsistency) {
 class HTTPIncomeMetricStressTest : public ::testing::Test {
 protected:
     void SetUp() override {
-        metric = std::make_unique<HTTPIncomeMetric>();
+        metric = std::make_unique<TestHTTPIncomeMetric>();
+    }
+
+    // Ends the current second and scrapes.
+    void Tick() {
+        AdvanceFakeClock(1s);
+        metric->Evaluate();
     }
 
-    std::unique_ptr<HTTPIncomeMetric> metric;
+    std::unique_ptr<TestHTTPIncomeMetric> metric;
 };
 
 TEST_F(HTTPIncomeMetricStressTest, HighFrequencyOperations) {
@@ -538,15 +588,15 @@ TEST_F(HTTPIncomeMetricStressTest, HighFrequencyOperations) {
             ++(*metric);
         }
         
-        metric->Evaluate();
+        Tick();
         EXPECT_EQ("1000.00", metric->GetValueAsString());
         
         metric->Reset();
-        EXPECT_EQ("0.00", metric->GetValueAsString());
+        EXPECT_EQ("1000.00", metric->GetValueAsString());
     }
     
     ++(*metric);
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("1.00", metric->GetValueAsString());
 }
 
@@ -563,7 +613,7 @@ TEST_F(HTTPIncomeMetricStressTest, ConcurrentStressTest) {
                 ++total_operations;
                 
                 if (j % 100 == 0) {
-                    metric->Evaluate();
+                    Tick();
                 }
                 
                 if (j % 200 == 0) {
@@ -582,7 +632,7 @@ TEST_F(HTTPIncomeMetricStressTest, ConcurrentStressTest) {
 }
 
 TEST_F(HTTPIncomeMetricTest, ConstructorWithMaxValue) {
-    HTTPIncomeMetric max_metric(ULLONG_MAX);
+    auto max_metric = WithIgnoredStart(ULLONG_MAX);
     EXPECT_EQ("0.00", max_metric.GetValueAsString());
     EXPECT_NO_THROW(max_metric.Evaluate());
 }
@@ -591,50 +641,50 @@ TEST_F(HTTPIncomeMetricTest, EvaluateAfterReset) {
     for (int i = 0; i < 10; ++i) {
         ++(*metric);
     }
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("10.00", metric->GetValueAsString());
     
     metric->Reset();
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("0.00", metric->GetValueAsString());
 }
 
 TEST_F(HTTPIncomeMetricTest, MultipleEvaluationsWithoutIncrements) {
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("0.00", metric->GetValueAsString());
     
     for (int i = 0; i < 5; ++i) {
-        metric->Evaluate();
+        Tick();
         EXPECT_EQ("0.00", metric->GetValueAsString()) << "Evaluation " << i << " failed";
     }
 }
 
 TEST_F(HTTPIncomeMetricTest, IncrementBetweenEvaluations) {
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("0.00", metric->GetValueAsString());
     
     ++(*metric);
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("1.00", metric->GetValueAsString());
     
     ++(*metric);
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("1.00", metric->GetValueAsString());
     
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("0.00", metric->GetValueAsString());
 }
 
 TEST_F(HTTPIncomeMetricTest, ChainedIncrements) {
-    HTTPIncomeMetric& ref1 = ++(*metric);
-    HTTPIncomeMetric& ref2 = ++ref1;
-    HTTPIncomeMetric& ref3 = ++ref2;
+    TestHTTPIncomeMetric& ref1 = ++(*metric);
+    TestHTTPIncomeMetric& ref2 = ++ref1;
+    TestHTTPIncomeMetric& ref3 = ++ref2;
     
     EXPECT_EQ(&ref1, metric.get());
     EXPECT_EQ(&ref2, metric.get());
     EXPECT_EQ(&ref3, metric.get());
     
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("3.00", metric->GetValueAsString());
 }
 
@@ -644,7 +694,7 @@ TEST_F(HTTPIncomeMetricTest, MixedIncrementTypes) {
     ++(*metric);
     (*metric)++;
     
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("4.00", metric->GetValueAsString());
 }
 
@@ -653,13 +703,13 @@ TEST_F(HTTPIncomeMetricTest, MemoryStability) {
         for (int i = 0; i < 1000; ++i) {
             ++(*metric);
         }
-        metric->Evaluate();
+        Tick();
         EXPECT_EQ("1000.00", metric->GetValueAsString());
         metric->Reset();
     }
     
     ++(*metric);
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("1.00", metric->GetValueAsString());
 }
 
@@ -670,10 +720,10 @@ TEST_F(HTTPIncomeMetricTest, AtomicOperationsConsistency) {
         ++(*metric);
     }
     
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ(std::to_string(num_operations) + ".00", metric->GetValueAsString());
     
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("0.00", metric->GetValueAsString());
 }
 
@@ -684,13 +734,13 @@ TEST_F(HTTPIncomeMetricTest, StateConsistencyAfterOperations) {
     ++(*metric);
     EXPECT_EQ("\"HTTPS requests RPS\"", metric->GetName());
     
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("\"HTTPS requests RPS\"", metric->GetName());
     EXPECT_NE("0.00", metric->GetValueAsString());
     
     metric->Reset();
     EXPECT_EQ("\"HTTPS requests RPS\"", metric->GetName());
-    EXPECT_EQ("0.00", metric->GetValueAsString());
+    EXPECT_EQ("1.00", metric->GetValueAsString());
 }
 
 TEST_F(HTTPIncomeMetricTest, ConcurrentReadOperations) {
@@ -701,7 +751,7 @@ TEST_F(HTTPIncomeMetricTest, ConcurrentReadOperations) {
     for (int i = 0; i < 50; ++i) {
         ++(*metric);
     }
-    metric->Evaluate();
+    Tick();
     
     for (int i = 0; i < num_threads; ++i) {
         threads.emplace_back([this, &successful_reads]() {
@@ -726,7 +776,7 @@ TEST_F(HTTPIncomeMetricTest, ConcurrentReadOperations) {
 }
 
 TEST_F(HTTPIncomeMetricTest, ExtremeValueHandling) {
-    HTTPIncomeMetric large_metric(ULLONG_MAX - 1000);
+    auto large_metric = WithIgnoredStart(ULLONG_MAX - 1000);
     
     for (int i = 0; i < 100; ++i) {
         EXPECT_NO_THROW(++large_metric);
@@ -741,9 +791,9 @@ TEST_F(HTTPIncomeMetricTest, ExtremeValueHandling) {
 TEST_F(HTTPIncomeMetricTest, RapidResetOperations) {
     for (int i = 0; i < 1000; ++i) {
         ++(*metric);
-        metric->Evaluate();
+        Tick();
         metric->Reset();
-        EXPECT_EQ("0.00", metric->GetValueAsString());
+        EXPECT_EQ("1.00", metric->GetValueAsString());
     }
 }
 
@@ -761,7 +811,7 @@ TEST_F(HTTPIncomeMetricTest, ComplexWorkloadSimulation) {
             ++(*metric);
         }
         
-        metric->Evaluate();
+        Tick();
         std::string expected = std::to_string(requests) + ".00";
         EXPECT_EQ(expected, metric->GetValueAsString()) 
             << "Phase " << phase << " with " << requests << " requests failed";
@@ -774,19 +824,19 @@ TEST_F(HTTPIncomeMetricTest, InterleavedOperations) {
             ++(*metric);
         }
         
-        metric->Evaluate();
+        Tick();
         EXPECT_EQ("5.00", metric->GetValueAsString());
         
         for (int i = 0; i < 3; ++i) {
             ++(*metric);
         }
         
-        metric->Evaluate();
+        Tick();
         EXPECT_EQ("3.00", metric->GetValueAsString());
         
         if (cycle % 3 == 0) {
             metric->Reset();
-            EXPECT_EQ("0.00", metric->GetValueAsString());
+            EXPECT_EQ("3.00", metric->GetValueAsString());
         }
     }
 }
@@ -808,7 +858,7 @@ TEST_F(HTTPIncomeMetricTest, AtomicIncrementConsistency) {
         t.join();
     }
     
-    metric->Evaluate();
+    Tick();
     int expected_total = num_threads * increments_per_thread;
     EXPECT_EQ(std::to_string(expected_total) + ".00", metric->GetValueAsString());
 }
@@ -833,7 +883,7 @@ TEST_F(HTTPIncomeMetricTest, ConcurrentEvaluateAndIncrement) {
                 std::this_thread::yield();
             }
             for (int j = 0; j < 100; ++j) {
-                metric->Evaluate();
+                Tick();
                 ++evaluation_count;
                 std::this_thread::sleep_for(std::chrono::microseconds(10));
             }
@@ -848,13 +898,13 @@ TEST_F(HTTPIncomeMetricTest, ConcurrentEvaluateAndIncrement) {
     
     EXPECT_EQ(evaluation_count.load(), 400);
     
-    metric->Evaluate();
+    Tick();
     std::string value = metric->GetValueAsString();
     EXPECT_TRUE(isValidDoubleString(value));
 }
 
 TEST_F(HTTPIncomeMetricTest, OverflowHandling) {
-    HTTPIncomeMetric overflow_metric(ULLONG_MAX - 10);
+    auto overflow_metric = WithIgnoredStart(ULLONG_MAX - 10);
     
     for (int i = 0; i < 5; ++i) {
         EXPECT_NO_THROW(++overflow_metric);
@@ -868,15 +918,15 @@ TEST_F(HTTPIncomeMetricTest, OverflowHandling) {
 
 TEST_F(HTTPIncomeMetricTest, ZeroToNonZeroTransition) {
     for (int i = 0; i < 10; ++i) {
-        metric->Evaluate();
+        Tick();
         EXPECT_EQ("0.00", metric->GetValueAsString());
     }
     
     ++(*metric);
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("1.00", metric->GetValueAsString());
     
-    metric->Evaluate();
+    Tick();
     EXPECT_EQ("0.00", metric->GetValueAsString());
 }
 
@@ -890,7 +940,7 @@ TEST_F(HTTPIncomeMetricTest, DecimalPrecisionEdgeCases) {
             ++(*metric);
         }
         
-        metric->Evaluate();
+        Tick();
         std::string result = metric->GetValueAsString();
         
         EXPECT_TRUE(hasCorrectPrecision(result)) << "Value " << value << " precision test failed";
@@ -902,9 +952,9 @@ TEST_F(HTTPIncomeMetricTest, DecimalPrecisionEdgeCases) {
 }
 
 TEST_F(HTTPIncomeMetricTest, MultipleInstancesIndependence) {
-    HTTPIncomeMetric metric1;
-    HTTPIncomeMetric metric2(100);
-    HTTPIncomeMetric metric3(50);
+    TestHTTPIncomeMetric metric1;
+    TestHTTPIncomeMetric metric2;
+    TestHTTPIncomeMetric metric3;
     
     ++metric1;
     for (int i = 0; i < 5; ++i) {
@@ -914,6 +964,7 @@ TEST_F(HTTPIncomeMetricTest, MultipleInstancesIndependence) {
         ++metric3;
     }
     
+    AdvanceFakeClock(1s);
     metric1.Evaluate();
     metric2.Evaluate();
     metric3.Evaluate();
@@ -924,7 +975,7 @@ TEST_F(HTTPIncomeMetricTest, MultipleInstancesIndependence) {
     
     metric2.Reset();
     EXPECT_EQ("1.00", metric1.GetValueAsString());
-    EXPECT_EQ("0.00", metric2.GetValueAsString());
+    EXPECT_EQ("5.00", metric2.GetValueAsString());
     EXPECT_EQ("3.00", metric3.GetValueAsString());
 }
 
@@ -948,23 +999,149 @@ TEST_F(HTTPIncomeMetricTest, ComprehensiveIntegrationTest) {
             ++(*metric);
         }
         
-        metric->Evaluate();
+        Tick();
         EXPECT_EQ(std::to_string(operations_per_phase) + ".00", metric->GetValueAsString());
         
         for (int i = 0; i < operations_per_phase / 2; ++i) {
             ++(*metric);
         }
         
-        metric->Evaluate();
+        Tick();
         EXPECT_EQ(std::to_string(operations_per_phase / 2) + ".00", metric->GetValueAsString());
         
         if (phase % 3 == 0) {
             metric->Reset();
-            EXPECT_EQ("0.00", metric->GetValueAsString());
+            EXPECT_EQ("50.00", metric->GetValueAsString());
         }
     }
     
     ++(*metric);
+    Tick();
+    EXPECT_EQ("1.00", metric->GetValueAsString());
+}
+
+TEST_F(HTTPIncomeMetricTest, RateDoesNotDependOnScrapeInterval) {
+    // 20 requests per second, scraped every 5 seconds.
+    for (int second = 0; second < 5; ++second) {
+        for (int i = 0; i < 20; ++i) {
+            ++(*metric);
+        }
+        AdvanceFakeClock(1s);
+    }
+    metric->Evaluate();
+    EXPECT_EQ("20.00", metric->GetValueAsString());
+    EXPECT_DOUBLE_EQ(metric->GetRates().last_10s, 20.0);
+}
+
+TEST_F(HTTPIncomeMetricTest, CurrentSecondIsNotCounted) {
+    ++(*metric);
+    metric->Evaluate();
+    EXPECT_EQ("0.00", metric->GetValueAsString());
+    AdvanceFakeClock(500ms);
+    metric->Evaluate();
+    AdvanceFakeClock(600ms);
     metric->Evaluate();
     EXPECT_EQ("1.00", metric->GetValueAsString());
-}
\ No newline at end of file
+}
+
+TEST_F(HTTPIncomeMetricTest, SlidingWindows) {
+    // 60 seconds at 10 rps, then 10 seconds at 70 rps.
+    for (int second = 0; second < 70; ++second) {
+        int requests = second < 60 ? 10 : 70;
+        for (int i = 0; i < requests; ++i) {
+            ++(*metric);
+        }
+        AdvanceFakeClock(1s);
+        if (second % 30 == 0) {
+            metric->Evaluate();
+        }
+    }
+    metric->Evaluate();
+    Rates rates = metric->GetRates();
+    EXPECT_DOUBLE_EQ(rates.last_1s, 70.0);
+    EXPECT_DOUBLE_EQ(rates.last_10s, 70.0);
+    EXPECT_DOUBLE_EQ(rates.last_60s, (50 * 10 + 10 * 70) / 60.0);
+}
+
+TEST_F(HTTPIncomeMetricTest, WindowsShorterBeforeTheyFill) {
+    for (int second = 0; second < 3; ++second) {
+        for (int i = 0; i < 6; ++i) {
+            ++(*metric);
+        }
+        AdvanceFakeClock(1s);
+    }
+    metric->Evaluate();
+    Rates rates = metric->GetRates();
+    EXPECT_DOUBLE_EQ(rates.last_10s, 6.0);
+    EXPECT_DOUBLE_EQ(rates.last_60s, 6.0);
+}
+
+TEST_F(HTTPIncomeMetricTest, ExponentialAveragesConverge) {
+    // 15 minutes at 100 rps.
+    for (int second = 0; second < 900; ++second) {
+        for (int i = 0; i < 100; ++i) {
+            ++(*metric);
+        }
+        AdvanceFakeClock(1s);
+        if (second % 20 == 0) {
+            metric->Evaluate();
+        }
+    }
+    metric->Evaluate();
+    Rates rates = metric->GetRates();
+    EXPECT_NEAR(rates.ewma_1m, 100.0, 0.1);
+    EXPECT_NEAR(rates.ewma_5m, 100.0 * (1 - std::exp(-3.0)), 0.5);
+    EXPECT_NEAR(rates.ewma_15m, 100.0 * (1 - std::exp(-1.0)), 0.5);
+    EXPECT_LT(rates.ewma_15m, rates.ewma_5m);
+}
+
+TEST_F(HTTPIncomeMetricTest, ExponentialAveragesDecayOverLongGaps) {
+    for (int second = 0; second < 120; ++second) {
+        for (int i = 0; i < 50; ++i) {
+            ++(*metric);
+        }
+        AdvanceFakeClock(1s);
+        metric->Evaluate();
+    }
+    double before = metric->GetRates().ewma_1m;
+    EXPECT_GT(before, 40.0);
+
+    // No scrapes and no requests for 5 minutes: older seconds left the ring and count as idle.
+    AdvanceFakeClock(300s);
+    metric->Evaluate();
+    Rates rates = metric->GetRates();
+    EXPECT_NEAR(rates.ewma_1m, before * std::exp(-5.0), 0.01);
+    EXPECT_DOUBLE_EQ(rates.last_60s, 0.0);
+}
+
+TEST_F(HTTPIncomeMetricTest, ScrapesByManagerKeepTheRate) {
+    std::string log_name = "test_http_income_scrapes.log";
+    Rates rates;
+    {
+        MetricsManager manager(log_name);
+        auto* http = manager.CreateMetric<TestHTTPIncomeMetric>();
+        for (int second = 0; second < 30; ++second) {
+            for (int i = 0; i < 100; ++i) {
+                ++(*http);
+            }
+            AdvanceFakeClock(1s);
+            manager.Log();
+            // Scrapes within one second log the same rate.
+            manager.Log();
+        }
+        rates = http->GetRates();
+    }
+    EXPECT_DOUBLE_EQ(rates.last_10s, 100.0);
+    EXPECT_NEAR(rates.ewma_1m, 100.0 * (1 - std::exp(-0.5)), 0.5);
+
+    std::ifstream log(log_name);
+    std::string line;
+    int lines = 0;
+    while (std::getline(log, line)) {
+        EXPECT_NE(line.find("\"HTTPS requests RPS\": 100.00"), std::string::npos) << line;
+        ++lines;
+    }
+    EXPECT_EQ(lines, 60);
+    log.close();
+    std::filesystem::remove(log_name);
+}
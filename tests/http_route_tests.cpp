@@ -0,0 +1,256 @@
+#include "IMetrics/HTTPRouteMetric.h"
+#include "MetricsManager/MetricsManager.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+using namespace Metrics;
+using namespace std::chrono_literals;
+
+namespace {
+    std::chrono::steady_clock::time_point manual_now{};
+
+    std::chrono::steady_clock::time_point ManualNow() noexcept {
+        return manual_now;
+    }
+}
+
+TEST(RouteTableTest, RegisterAssignsDenseIds) {
+    RouteTable routes;
+    EXPECT_EQ(routes.Register("/users"), 0u);
+    EXPECT_EQ(routes.Register("/orders"), 1u);
+    EXPECT_EQ(routes.Register("/users"), 0u);
+    EXPECT_EQ(routes.Size(), 2u);
+    EXPECT_EQ(routes.Find("/orders"), 1u);
+    EXPECT_EQ(routes.Name(0), "/users");
+    EXPECT_THROW(routes.Find("/missing"), std::out_of_range);
+    EXPECT_THROW(routes.Name(2), std::out_of_range);
+}
+
+TEST(RouteTableTest, InitializerList) {
+    RouteTable routes{"/a", "/b", "/a"};
+    EXPECT_EQ(routes.Size(), 2u);
+    EXPECT_EQ(routes.Find("/b"), 1u);
+}
+
+TEST(HTTPRouteMetricTest, StatusClasses) {
+    EXPECT_EQ(ClassOf(100), StatusClass::Informational);
+    EXPECT_EQ(ClassOf(200), StatusClass::Success);
+    EXPECT_EQ(ClassOf(204), StatusClass::Success);
+    EXPECT_EQ(ClassOf(301), StatusClass::Redirection);
+    EXPECT_EQ(ClassOf(404), StatusClass::ClientError);
+    EXPECT_EQ(ClassOf(599), StatusClass::ServerError);
+    EXPECT_EQ(ClassOf(99), StatusClass::Other);
+    EXPECT_EQ(ClassOf(600), StatusClass::Other);
+    EXPECT_EQ(ClassOf(-1), StatusClass::Other);
+}
+
+TEST(HTTPRouteMetricTest, CountsPerCell) {
+    RouteTable routes{"/users", "/orders"};
+    HTTPRouteMetric metric(routes, "\"Routes\"", &ManualNow);
+    RouteId users = routes.Find("/users");
+    RouteId orders = routes.Find("/orders");
+
+    for (int i = 0; i < 6; ++i) {
+        metric.Increment(users, 200);
+    }
+    metric.Increment(users, 503);
+    metric.Increment(orders, 404);
+    metric.Increment(orders, 404);
+
+    manual_now += 2s;
+    metric.Evaluate();
+    auto ok = metric.GetRates(users, StatusClass::Success);
+    EXPECT_EQ(ok.total, 6u);
+    EXPECT_DOUBLE_EQ(ok.rps, 3.0);
+    EXPECT_EQ(metric.GetRates(users, StatusClass::ServerError).total, 1u);
+    EXPECT_EQ(metric.GetRates(orders, StatusClass::ClientError).total, 2u);
+    EXPECT_EQ(metric.GetRates(orders, StatusClass::Success).total, 0u);
+    EXPECT_EQ(metric.GetValueAsString(), "/users 2xx: 3.00, /users 5xx: 0.50, /orders 4xx: 1.00");
+    EXPECT_EQ(metric.GetName(), "\"Routes\"");
+}
+
+TEST(HTTPRouteMetricTest, RateCoversOnlyTheLastInterval) {
+    RouteTable routes{"/"};
+    HTTPRouteMetric metric(routes, "\"Root\"", &ManualNow);
+    for (int i = 0; i < 10; ++i) {
+        metric.Increment(0, 200);
+    }
+    manual_now += 1s;
+    metric.Evaluate();
+    EXPECT_DOUBLE_EQ(metric.GetRates(0, StatusClass::Success).rps, 10.0);
+
+    metric.Increment(0, 200);
+    manual_now += 4s;
+    metric.Evaluate();
+    auto rates = metric.GetRates(0, StatusClass::Success);
+    EXPECT_EQ(rates.total, 11u);
+    EXPECT_DOUBLE_EQ(rates.rps, 0.25);
+    EXPECT_GT(rates.ewma_1m, 0.0);
+    EXPECT_LT(rates.ewma_1m, 10.0);
+}
+
+TEST(HTTPRouteMetricTest, UnknownRouteIsIgnored) {
+    RouteTable routes{"/"};
+    HTTPRouteMetric metric(routes, "\"Root\"", &ManualNow);
+    metric.Increment(1, 200);
+    metric.Increment(1000, 200);
+    manual_now += 1s;
+    metric.Evaluate();
+    EXPECT_EQ(metric.GetValueAsString(), "no requests");
+    EXPECT_THROW(metric.GetRates(1, StatusClass::Success), std::out_of_range);
+}
+
+TEST(HTTPRouteMetricTest, Reset) {
+    RouteTable routes{"/"};
+    HTTPRouteMetric metric(routes, "\"Root\"", &ManualNow);
+    metric.Increment(0, 500);
+    manual_now += 1s;
+    metric.Evaluate();
+    metric.Reset();
+    manual_now += 1s;
+    metric.Evaluate();
+    EXPECT_EQ(metric.GetRates(0, StatusClass::ServerError).total, 0u);
+}
+
+TEST(HTTPRouteMetricTest, IdleCellIsLoggedUntilAveragesDecay) {
+    RouteTable routes{"/"};
+    HTTPRouteMetric metric(routes, "\"Root\"", &ManualNow);
+    metric.Increment(0, 500);
+    manual_now += 1s;
+    metric.Evaluate();
+    metric.Reset();
+    manual_now += 1s;
+    metric.Evaluate();
+    // No requests in the interval, but the averages still remember the one before.
+    EXPECT_EQ(metric.GetValueAsString(), "/ 5xx: 0.00");
+
+    manual_now += std::chrono::hours(24 * 365);
+    metric.Evaluate();
+    EXPECT_EQ(metric.GetValueAsString(), "no requests");
+}
+
+TEST(HTTPRouteMetricTest, SnapshotHasEveryLoggedCell) {
+    RouteTable routes{"/users", "/orders"};
+    HTTPRouteMetric metric(routes, "\"Routes\"", &ManualNow);
+    EXPECT_TRUE(std::get<Snapshot::Breakdown>(metric.GetSnapshot()).cells.empty());
+
+    metric.Increment(0, 200);
+    metric.Increment(0, 200);
+    metric.Increment(1, 404);
+    manual_now += 2s;
+    metric.Evaluate();
+    auto cells = std::get<Snapshot::Breakdown>(metric.GetSnapshot()).cells;
+    ASSERT_EQ(cells.size(), 2u);
+    EXPECT_EQ(cells[0].label, "/users 2xx");
+    EXPECT_EQ(cells[0].total, 2u);
+    EXPECT_DOUBLE_EQ(cells[0].rate, 1.0);
+    EXPECT_EQ(cells[1].label, "/orders 4xx");
+    EXPECT_EQ(cells[1].total, 1u);
+    EXPECT_DOUBLE_EQ(cells[1].rate, 0.5);
+    auto rates = metric.GetRates(1, StatusClass::ClientError);
+    EXPECT_DOUBLE_EQ(cells[1].ewma_1m, rates.ewma_1m);
+    EXPECT_DOUBLE_EQ(cells[1].ewma_5m, rates.ewma_5m);
+    EXPECT_DOUBLE_EQ(cells[1].ewma_15m, rates.ewma_15m);
+
+    // The idle /users cell stays while its averages are non-zero, with a zero total.
+    metric.Reset();
+    manual_now += 1s;
+    metric.Evaluate();
+    cells = std::get<Snapshot::Breakdown>(metric.GetSnapshot()).cells;
+    ASSERT_EQ(cells.size(), 2u);
+    EXPECT_EQ(cells[0].total, 0u);
+    EXPECT_DOUBLE_EQ(cells[0].rate, 0.0);
+    EXPECT_GT(cells[0].ewma_1m, 0.0);
+}
+
+TEST(HTTPRouteMetricTest, ResetKeepsAveragesAndLaterRequests) {
+    RouteTable routes{"/"};
+    HTTPRouteMetric metric(routes, "\"Root\"", &ManualNow);
+    for (int second = 0; second < 30; ++second) {
+        for (int i = 0; i < 10; ++i) {
+            metric.Increment(0, 200);
+        }
+        manual_now += 1s;
+        metric.Evaluate();
+        // Requests between the scan and Reset() go into the next interval.
+        metric.Increment(0, 200);
+        metric.Reset();
+    }
+    auto rates = metric.GetRates(0, StatusClass::Success);
+    EXPECT_EQ(rates.total, 0u);
+    EXPECT_GT(rates.ewma_1m, 11.0 * (1 - std::exp(-0.5)) - 0.5);
+
+    manual_now += 1s;
+    metric.Evaluate();
+    rates = metric.GetRates(0, StatusClass::Success);
+    EXPECT_EQ(rates.total, 1u);
+    EXPECT_DOUBLE_EQ(rates.rps, 1.0);
+}
+
+TEST(HTTPRouteMetricTest, ManyRoutesSpanSeveralLines) {
+    RouteTable routes;
+    for (int i = 0; i < 50; ++i) {
+        routes.Register("/route" + std::to_string(i));
+    }
+    HTTPRouteMetric metric(routes, "\"Many\"", &ManualNow);
+    for (RouteId route = 0; route < routes.Size(); ++route) {
+        for (RouteId i = 0; i <= route; ++i) {
+            metric.Increment(route, 302);
+        }
+    }
+    manual_now += 1s;
+    metric.Evaluate();
+    for (RouteId route = 0; route < routes.Size(); ++route) {
+        EXPECT_EQ(metric.GetRates(route, StatusClass::Redirection).total, route + 1);
+        EXPECT_EQ(metric.GetRates(route, StatusClass::Success).total, 0u);
+    }
+}
+
+TEST(HTTPRouteMetricTest, ConcurrentIncrements) {
+    RouteTable routes{"/a", "/b"};
+    HTTPRouteMetric metric(routes, "\"Concurrent\"", &ManualNow);
+    constexpr int kThreads = 8;
+    constexpr int kIncrements = 10000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&metric, t] {
+            for (int i = 0; i < kIncrements; ++i) {
+                metric.Increment(t % 2, i % 2 == 0 ? 200 : 500);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    manual_now += 1s;
+    metric.Evaluate();
+    for (RouteId route = 0; route < 2; ++route) {
+        EXPECT_EQ(metric.GetRates(route, StatusClass::Success).total, kThreads / 2 * kIncrements / 2);
+        EXPECT_EQ(metric.GetRates(route, StatusClass::ServerError).total, kThreads / 2 * kIncrements / 2);
+    }
+}
+
+TEST(HTTPRouteMetricTest, LoggedByManager) {
+    std::string log_name = "test_http_route_metric.log";
+    {
+        MetricsManager manager(log_name);
+        auto* metric = manager.CreateMetric<HTTPRouteMetric>(RouteTable{"/health"}, "\"Requests by route\"");
+        metric->Increment(0, 200);
+        manager.Log();
+    }
+    std::ifstream log(log_name);
+    std::string content((std::istreambuf_iterator<char>(log)), std::istreambuf_iterator<char>());
+    EXPECT_NE(content.find("\"Requests by route\": /health 2xx: "), std::string::npos) << content;
+    log.close();
+    std::filesystem::remove(log_name);
+}
@@ -0,0 +1,239 @@
+#include <gtest/gtest.h>
+#include "MetricsManager/HttpServer.h"
+#include "MetricsManager/MetricsManager.h"
+#include "IMetrics/IncrementMetric.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace MetricsServer;
+using namespace std::chrono_literals;
+
+namespace {
+
+int ConnectTcp(std::uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int ConnectUnix(const std::string& path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Sends the raw request and reads until the server closes the connection.
+std::string Exchange(int fd, const std::string& request) {
+    if (fd == -1) {
+        return "";
+    }
+    timeval timeout{5, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+
+    std::string response;
+    char buffer[4096];
+    ssize_t received;
+    while ((received = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, static_cast<size_t>(received));
+    }
+    close(fd);
+    return response;
+}
+
+std::string Get(std::uint16_t port, const std::string& path = "/metrics") {
+    return Exchange(ConnectTcp(port), "GET " + path + " HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n");
+}
+
+std::string Body(const std::string& response) {
+    size_t end = response.find("\r\n\r\n");
+    return end == std::string::npos ? "" : response.substr(end + 4);
+}
+
+}
+
+TEST(HttpServerTest, ServesMetricsOnLoopback) {
+    HttpServer server([](std::string& body) { body += "Requests: 42\n"; });
+    ASSERT_TRUE(server.Start());
+    EXPECT_TRUE(server.IsRunning());
+    EXPECT_NE(server.Port(), 0);
+
+    std::string response = Get(server.Port());
+    EXPECT_EQ(response.rfind("HTTP/1.1 200 OK\r\n", 0), 0);
+    EXPECT_NE(response.find("Content-Length: 13\r\n"), std::string::npos);
+    EXPECT_EQ(Body(response), "Requests: 42\n");
+}
+
+TEST(HttpServerTest, UnknownPathAndMethod) {
+    HttpServer server([](std::string& body) { body += "x: 1\n"; });
+    ASSERT_TRUE(server.Start());
+
+    EXPECT_EQ(Get(server.Port(), "/other").rfind("HTTP/1.1 404 Not Found", 0), 0);
+    EXPECT_EQ(Get(server.Port(), "/metrics?format=text").rfind("HTTP/1.1 200 OK", 0), 0);
+
+    std::string response = Exchange(ConnectTcp(server.Port()), "POST /metrics HTTP/1.1\r\nContent-Length: 0\r\n\r\n");
+    EXPECT_EQ(response.rfind("HTTP/1.1 405 Method Not Allowed", 0), 0);
+
+    response = Exchange(ConnectTcp(server.Port()), "garbage\r\n\r\n");
+    EXPECT_EQ(response.rfind("HTTP/1.1 400 Bad Request", 0), 0);
+}
+
+TEST(HttpServerTest, HeadReturnsHeadersOnly) {
+    HttpServer server([](std::string& body) { body += "x: 1\n"; });
+    ASSERT_TRUE(server.Start());
+
+    std::string response = Exchange(ConnectTcp(server.Port()), "HEAD /metrics HTTP/1.1\r\nConnection: close\r\n\r\n");
+    EXPECT_EQ(response.rfind("HTTP/1.1 200 OK", 0), 0);
+    EXPECT_NE(response.find("Content-Length: 5\r\n"), std::string::npos);
+    EXPECT_EQ(Body(response), "");
+}
+
+TEST(HttpServerTest, CachedResponseIsReusedWithinTtl) {
+    std::atomic<int> value{0};
+    HttpServerOptions options;
+    options.cache_ttl = 1h;
+    HttpServer server([&value](std::string& body) { body += "value: " + std::to_string(++value) + "\n"; }, options);
+    ASSERT_TRUE(server.Start());
+
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(Body(Get(server.Port())), "value: 1\n");
+    }
+    EXPECT_EQ(server.RenderCount(), 1);
+}
+
+TEST(HttpServerTest, ZeroTtlRendersEveryScrape) {
+    std::atomic<int> value{0};
+    HttpServerOptions options;
+    options.cache_ttl = 0ms;
+    HttpServer server([&value](std::string& body) { body += "value: " + std::to_string(++value) + "\n"; }, options);
+    ASSERT_TRUE(server.Start());
+
+    EXPECT_EQ(Body(Get(server.Port())), "value: 1\n");
+    EXPECT_EQ(Body(Get(server.Port())), "value: 2\n");
+    EXPECT_EQ(server.RenderCount(), 2);
+}
+
+TEST(HttpServerTest, KeepAliveServesPipelinedRequests) {
+    HttpServer server([](std::string& body) { body += "x: 1\n"; });
+    ASSERT_TRUE(server.Start());
+
+    std::string response = Exchange(ConnectTcp(server.Port()),
+        "GET /metrics HTTP/1.1\r\n\r\n"
+        "GET /missing HTTP/1.1\r\n\r\n"
+        "GET /metrics HTTP/1.1\r\nConnection: close\r\n\r\n");
+
+    size_t ok_count = 0;
+    for (size_t pos = response.find("200 OK"); pos != std::string::npos; pos = response.find("200 OK", pos + 1)) {
+        ++ok_count;
+    }
+    EXPECT_EQ(ok_count, 2);
+    EXPECT_NE(response.find("404 Not Found"), std::string::npos);
+    EXPECT_LT(response.find("404 Not Found"), response.rfind("200 OK"));
+}
+
+TEST(HttpServerTest, ServesOverUnixSocket) {
+    HttpServerOptions options;
+    options.unix_socket_path = (std::filesystem::temp_directory_path() / "metrics_http_server_test.sock").string();
+    HttpServer server([](std::string& body) { body += "unix: 1\n"; }, options);
+    ASSERT_TRUE(server.Start());
+    EXPECT_EQ(server.Port(), 0);
+
+    std::string response = Exchange(ConnectUnix(options.unix_socket_path), "GET /metrics HTTP/1.1\r\nConnection: close\r\n\r\n");
+    EXPECT_EQ(Body(response), "unix: 1\n");
+
+    server.Stop();
+    EXPECT_FALSE(std::filesystem::exists(options.unix_socket_path));
+}
+
+TEST(HttpServerTest, ConcurrentScrapes) {
+    HttpServer server([](std::string& body) { body += "x: 1\n"; });
+    ASSERT_TRUE(server.Start());
+
+    std::atomic<int> successful{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 50; ++i) {
+                if (Body(Get(server.Port())) == "x: 1\n") {
+                    ++successful;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(successful, 400);
+}
+
+TEST(HttpServerTest, StopClosesListener) {
+    HttpServer server([](std::string& body) { body += "x: 1\n"; });
+    ASSERT_TRUE(server.Start());
+    std::uint16_t port = server.Port();
+
+    server.Stop();
+    EXPECT_FALSE(server.IsRunning());
+    EXPECT_EQ(ConnectTcp(port), -1);
+
+    ASSERT_TRUE(server.Start());
+    EXPECT_EQ(Body(Get(server.Port())), "x: 1\n");
+}
+
+TEST(HttpServerTest, BusyPortFailsToStart) {
+    HttpServer first([](std::string&) {});
+    ASSERT_TRUE(first.Start());
+
+    HttpServerOptions options;
+    options.port = first.Port();
+    HttpServer second([](std::string&) {}, options);
+    EXPECT_FALSE(second.Start());
+    EXPECT_FALSE(second.IsRunning());
+}
+
+TEST(HttpServerTest, ManagerServeDoesNotReset) {
+    std::string log_name = "test_http_server_manager.log";
+    {
+        MetricsManager manager(log_name);
+        auto* counter = manager.CreateMetric<Metrics::IncrementMetric>("\"Served counter\"", 5);
+
+        HttpServerOptions options;
+        options.cache_ttl = 0ms;
+        ASSERT_TRUE(manager.Serve(options));
+        ASSERT_NE(manager.ServerPort(), 0);
+
+        EXPECT_EQ(Body(Get(manager.ServerPort())), "\"Served counter\": 5\n");
+        EXPECT_EQ(Body(Get(manager.ServerPort())), "\"Served counter\": 5\n");
+
+        ++(*counter);
+        EXPECT_EQ(Body(Get(manager.ServerPort())), "\"Served counter\": 6\n");
+
+        manager.StopServing();
+        EXPECT_EQ(manager.ServerPort(), 0);
+    }
+    std::filesystem::remove(log_name);
+}
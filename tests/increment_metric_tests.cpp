@@ -6,6 +6,8 @@
 #include <set>
 #include <memory>
 #include <algorithm>
+#include <condition_variable>
+#include <mutex>
 #include "../src/IMetrics/IncrementMetric.h"
 
 class IncrementMetricTest : public ::testing::Test {
@@ -382,4 +384,130 @@ TEST_F(IncrementMetricStressTest, MassiveConcurrentOperations) {
     
     std::string final_value = metric->GetValueAsString();
     EXPECT_TRUE(std::all_of(final_value.begin(), final_value.end(), ::isdigit));
-}
\ No newline at end of file
+}
+
+TEST(StripedIncrementMetricTest, StartValueAndReset) {
+    Metrics::StripedIncrementMetric metric("Striped", 100);
+    ++metric;
+    metric++;
+    EXPECT_EQ(metric.GetValueAsString(), "102");
+    metric.Reset();
+    EXPECT_EQ(metric.GetValueAsString(), "0");
+    EXPECT_EQ(metric.GetName(), "Striped");
+}
+
+TEST(StripedIncrementMetricTest, DefaultNamesSharedWithIncrementMetric) {
+    Metrics::IncrementMetric plain;
+    Metrics::StripedIncrementMetric striped;
+    EXPECT_NE(plain.GetName(), striped.GetName());
+    EXPECT_TRUE(striped.GetName().find("IncrementMetric") != std::string::npos);
+}
+
+TEST(StripedIncrementMetricTest, ConcurrentIncrementsAreSummed) {
+    Metrics::StripedIncrementMetric metric;
+    const int num_threads = 16;
+    const int operations_per_thread = 10000;
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&]() {
+            for (int j = 0; j < operations_per_thread; ++j) {
+                ++metric;
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(metric.GetValueAsString(), std::to_string(num_threads * operations_per_thread));
+}
+
+TEST(StripedIncrementMetricTest, StripesAreCacheLines) {
+    Metrics::StripedCounter counter;
+    EXPECT_GE(counter.Stripes(), 1);
+    EXPECT_LE(counter.Stripes(), Metrics::StripedCounter::kMaxStripes);
+    EXPECT_EQ(counter.Stripes() & (counter.Stripes() - 1), 0);
+    counter.Add(5);
+    counter.Add(7);
+    EXPECT_EQ(counter.Load(), 12);
+}
+
+TEST(PerThreadIncrementMetricTest, LoadSeesEveryIncrement) {
+    Metrics::PerThreadIncrementMetric metric("PerThread", 10);
+    ++metric;
+    ++metric;
+    EXPECT_EQ(metric.GetValueAsString(), "12");
+    metric.Reset();
+    EXPECT_EQ(metric.GetValueAsString(), "0");
+    ++metric;
+    EXPECT_EQ(metric.GetValueAsString(), "1");
+}
+
+TEST(PerThreadIncrementMetricTest, IdleThreadCountsAreVisible) {
+    Metrics::PerThreadIncrementMetric metric("PerThread");
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool counted = false;
+    bool done = false;
+    // Increments a few times and then stays alive without incrementing again.
+    std::thread idle([&]() {
+        for (int i = 0; i < 5; ++i) {
+            ++metric;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        counted = true;
+        condition.notify_all();
+        condition.wait(lock, [&] { return done; });
+    });
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&] { return counted; });
+    }
+    metric.Evaluate();
+    EXPECT_EQ(metric.GetValueAsString(), "5");
+    metric.Reset();
+    EXPECT_EQ(metric.GetValueAsString(), "0");
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+    }
+    condition.notify_all();
+    idle.join();
+    // The exited thread's count moved into the base without undoing the Reset().
+    EXPECT_EQ(metric.GetValueAsString(), "0");
+}
+
+TEST(PerThreadIncrementMetricTest, ThreadExitKeepsCounts) {
+    Metrics::PerThreadIncrementMetric metric("PerThread");
+    const int num_threads = 8;
+    const int operations_per_thread = 10007;
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&]() {
+            for (int j = 0; j < operations_per_thread; ++j) {
+                metric++;
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(metric.GetValueAsString(), std::to_string(num_threads * operations_per_thread));
+}
+
+TEST(PerThreadIncrementMetricTest, ReusedCounterSlotStartsClean) {
+    auto first = std::make_unique<Metrics::PerThreadIncrementMetric>("First");
+    ++(*first);
+    first.reset();
+
+    Metrics::PerThreadIncrementMetric second("Second");
+    ++second;
+    second.Evaluate();
+    ++second;
+    EXPECT_EQ(second.GetValueAsString(), "2");
+}
@@ -8,6 +8,7 @@
 #include <vector>
 #include <random>
 #include <atomic>
+#include <variant>
 
 #include <regex>
 
@@ -715,3 +716,155 @@ TEST_F(LatencyMetricTest, ComprehensiveIntegrationTest) {
     std::string final_value = metric->GetValueAsString();
     EXPECT_TRUE(hasValidFormat(final_value));
 }
+
+// Every thread records into its own shard; scrapes merge the shards of live and exited threads.
+TEST(LatencyMetricShardsTest, MergesShardsOfLiveThreads) {
+    LatencyMetric metric;
+    constexpr int kThreads = 8;
+    constexpr int kObservations = 1000;
+    std::atomic<int> recorded{0};
+    std::atomic<bool> done{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&metric, &recorded, &done, t] {
+            for (int i = 0; i < kObservations; ++i) {
+                metric.Observe(std::chrono::nanoseconds(1000 * (t + 1)));
+            }
+            ++recorded;
+            while (!done) {
+                std::this_thread::yield();
+            }
+        });
+    }
+    while (recorded != kThreads) {
+        std::this_thread::yield();
+    }
+    auto percentiles = std::get<Snapshot::Percentiles>(metric.GetSnapshot());
+    done = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(percentiles.count, static_cast<std::uint64_t>(kThreads * kObservations));
+    EXPECT_NEAR(percentiles.points[0].value, 8000.0, 8.0);
+}
+
+TEST(LatencyMetricShardsTest, KeepsSamplesOfExitedThreads) {
+    LatencyMetric metric;
+    for (int round = 0; round < 3; ++round) {
+        std::thread([&metric] {
+            for (int i = 0; i < 100; ++i) {
+                metric.Observe(500ns);
+            }
+        }).join();
+    }
+    metric.Observe(500ns);
+    auto percentiles = std::get<Snapshot::Percentiles>(metric.GetSnapshot());
+    EXPECT_EQ(percentiles.count, 301u);
+    EXPECT_NEAR(percentiles.points[3].value, 500.0, 1.0);
+}
+
+TEST(LatencyMetricShardsTest, ResetClearsAllShards) {
+    LatencyMetric metric;
+    std::thread([&metric] { metric.Observe(1ms); }).join();
+    metric.Observe(2ms);
+    metric.Reset();
+    EXPECT_EQ(std::get<Snapshot::Percentiles>(metric.GetSnapshot()).count, 0u);
+    metric.Observe(3ms);
+    EXPECT_EQ(std::get<Snapshot::Percentiles>(metric.GetSnapshot()).count, 1u);
+}
+
+TEST(LatencyMetricShardsTest, MetricsDontShareShards) {
+    auto first = std::make_unique<LatencyMetric>();
+    first->Observe(1us);
+    first.reset();
+    // Likely gets the destroyed metric's thread-local slot.
+    LatencyMetric second;
+    second.Observe(2us);
+    auto percentiles = std::get<Snapshot::Percentiles>(second.GetSnapshot());
+    EXPECT_EQ(percentiles.count, 1u);
+    EXPECT_NEAR(percentiles.points[0].value, 2000.0, 2.0);
+}
+
+TEST(LatencyMetricShardsTest, ThreadOutlivesMetric) {
+    std::atomic<bool> observed{false};
+    std::atomic<bool> destroyed{false};
+    auto metric = std::make_unique<LatencyMetric>();
+    std::thread thread([&] {
+        metric->Observe(1us);
+        observed = true;
+        while (!destroyed) {
+            std::this_thread::yield();
+        }
+    });
+    while (!observed) {
+        std::this_thread::yield();
+    }
+    metric.reset();
+    destroyed = true;
+    thread.join();
+}
+
+TEST(LatencyMetricShardsTest, ScrapesDuringObserve) {
+    LatencyMetric metric;
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> observed{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&metric, &stop, &observed] {
+            std::uint64_t count = 0;
+            while (!stop) {
+                metric.Observe(10us);
+                ++count;
+            }
+            observed += count;
+        });
+    }
+    std::uint64_t last = 0;
+    for (int i = 0; i < 50; ++i) {
+        auto percentiles = std::get<Snapshot::Percentiles>(metric.GetSnapshot());
+        EXPECT_GE(percentiles.count, last);
+        last = percentiles.count;
+    }
+    stop = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    // Scrapes swap shards out from under the threads without losing a sample.
+    EXPECT_EQ(std::get<Snapshot::Percentiles>(metric.GetSnapshot()).count, observed.load());
+}
+
+TEST(LatencyMetricShardsTest, ResetsDuringObserve) {
+    LatencyMetric metric;
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&metric, &stop] {
+            while (!stop) {
+                metric.Observe(10us);
+            }
+        });
+    }
+    for (int i = 0; i < 50; ++i) {
+        metric.Reset();
+        metric.GetSnapshot();
+    }
+    stop = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    metric.Reset();
+    metric.Observe(20us);
+    auto percentiles = std::get<Snapshot::Percentiles>(metric.GetSnapshot());
+    EXPECT_EQ(percentiles.count, 1u);
+    EXPECT_NEAR(percentiles.points[0].value, 20000.0, 20.0);
+}
+
+TEST(LatencyMetricShardsTest, LowerPrecisionOnRequest) {
+    LatencyMetric metric(2);
+    std::thread([&metric] { metric.Observe(8000ns); }).join();
+    metric.Observe(8000ns);
+    auto percentiles = std::get<Snapshot::Percentiles>(metric.GetSnapshot());
+    EXPECT_EQ(percentiles.count, 2u);
+    EXPECT_NEAR(percentiles.points[0].value, 8000.0, 80.0);
+    EXPECT_THROW(LatencyMetric(0), std::runtime_error);
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include "MultiThreadWriter/LogDecoder.h"
+
+#include <sstream>
+#include <string>
+
+using namespace NonBlockingWriter;
+
+TEST(LogDecoderTest, DecodesSamples) {
+    LogDecoder decoder;
+    std::string out;
+
+    EXPECT_FALSE(decoder.DecodeLine("T\t2025-01-01 12:00:00.000", out));
+    EXPECT_FALSE(decoder.DecodeLine("M\t3\tMetrics::HTTPIncomeMetric\trps\tserver\t\"HTTPS requests RPS\"", out));
+    ASSERT_TRUE(decoder.DecodeLine("3\t12.00", out));
+    EXPECT_EQ(out, "2025-01-01 12:00:00.000 \"HTTPS requests RPS\": 12.00");
+
+    const auto* info = decoder.Find(3);
+    ASSERT_NE(info, nullptr);
+    EXPECT_EQ(info->type, "Metrics::HTTPIncomeMetric");
+    EXPECT_EQ(info->unit, "rps");
+    EXPECT_EQ(info->tags, "server");
+    EXPECT_EQ(decoder.Find(4), nullptr);
+
+    EXPECT_FALSE(decoder.DecodeLine("T\t2025-01-01 12:00:01.000", out));
+    ASSERT_TRUE(decoder.DecodeLine("3\t7.00", out));
+    EXPECT_EQ(out, "2025-01-01 12:00:01.000 \"HTTPS requests RPS\": 7.00");
+}
+
+TEST(LogDecoderTest, RedefinitionAndUnknownIds) {
+    LogDecoder decoder;
+    std::string out;
+
+    decoder.DecodeLine("T\t2025-01-01 12:00:00.000", out);
+    ASSERT_TRUE(decoder.DecodeLine("5\t1", out));
+    EXPECT_EQ(out, "2025-01-01 12:00:00.000 5: 1");
+
+    decoder.DecodeLine("M\t5\tMetrics::IncrementMetric\t\t\tOld", out);
+    decoder.DecodeLine("M\t5\tMetrics::IncrementMetric\t\t\tNew name: with colon", out);
+    ASSERT_TRUE(decoder.DecodeLine("5\t\tvalue with tab", out));
+    EXPECT_EQ(out, "2025-01-01 12:00:00.000 New name: with colon: \tvalue with tab");
+
+    EXPECT_FALSE(decoder.DecodeLine("M\tbroken", out));
+}
+
+TEST(LogDecoderTest, PassesTextLinesThrough) {
+    std::istringstream in(
+        "2025-01-01 12:00:00.000 Requests: 1\n"
+        "T\t2025-01-01 12:00:01.000\n"
+        "M\t0\tMetrics::IncrementMetric\t\t\tRequests\n"
+        "0\t2\n"
+        "2025-01-01 12:00:02.000 Requests: 3\n");
+    std::ostringstream out;
+    LogDecoder::Decode(in, out);
+
+    EXPECT_EQ(out.str(),
+        "2025-01-01 12:00:00.000 Requests: 1\n"
+        "2025-01-01 12:00:01.000 Requests: 2\n"
+        "2025-01-01 12:00:02.000 Requests: 3\n");
+}
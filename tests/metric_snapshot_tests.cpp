@@ -0,0 +1,156 @@
+#include "IMetrics/IncrementMetric.h"
+#include "IMetrics/HTTPIncomeMetric.h"
+#include "IMetrics/LatencyMetric.h"
+#include "IMetrics/CodeTimeMetric.h"
+#include "IMetrics/CPUUsageMetric.h"
+#include "IMetrics/CardinalityMetricType.h"
+#include "IMetrics/CardinalityMetricValue.h"
+#include "IMetrics/MetricSnapshot.h"
+#include "MetricsManager/MetricsManager.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+using namespace Metrics;
+using namespace std::chrono_literals;
+
+namespace {
+    std::chrono::steady_clock::time_point manual_now{};
+
+    struct ManualClock {
+        static std::chrono::steady_clock::time_point now() noexcept {
+            return manual_now;
+        }
+    };
+
+    class TextOnlyMetric : public IMetric {
+    public:
+        std::string GetName() const override { return "TextOnly"; }
+        std::string GetValueAsString() const override { return "ok"; }
+        void Evaluate() override {}
+        void Reset() override {}
+    };
+
+    std::string KindOf(const MetricSnapshot& snapshot) {
+        return std::visit(SnapshotVisitor{
+            [](const Snapshot::Counter&) { return std::string("counter"); },
+            [](const Snapshot::Gauge&) { return std::string("gauge"); },
+            [](const Snapshot::Percentiles&) { return std::string("percentiles"); },
+            [](const Snapshot::TopN&) { return std::string("top"); },
+            [](const Snapshot::Breakdown&) { return std::string("breakdown"); },
+            [](const Snapshot::Duration&) { return std::string("duration"); },
+            [](const Snapshot::Text&) { return std::string("text"); },
+        }, snapshot);
+    }
+}
+
+TEST(MetricSnapshotTest, Counter) {
+    IncrementMetric metric("Requests", 41);
+    ++metric;
+    auto snapshot = metric.GetSnapshot();
+    ASSERT_TRUE(std::holds_alternative<Snapshot::Counter>(snapshot));
+    EXPECT_EQ(std::get<Snapshot::Counter>(snapshot).value, 42);
+}
+
+TEST(MetricSnapshotTest, Gauge) {
+    BasicHTTPIncomeMetric<ManualClock> rps;
+    for (int i = 0; i < 5; ++i) {
+        ++rps;
+    }
+    manual_now += 1s;
+    rps.Evaluate();
+    auto snapshot = rps.GetSnapshot();
+    ASSERT_TRUE(std::holds_alternative<Snapshot::Gauge>(snapshot));
+    EXPECT_DOUBLE_EQ(std::get<Snapshot::Gauge>(snapshot).value, 5.0);
+
+    CPUUsageMetric cpu;
+    cpu.Evaluate();
+    EXPECT_EQ(KindOf(cpu.GetSnapshot()), "gauge");
+}
+
+TEST(MetricSnapshotTest, PercentilesMatchText) {
+    LatencyMetric metric;
+    for (int i = 1; i <= 1000; ++i) {
+        metric.Observe(std::chrono::nanoseconds(i * 1000));
+    }
+    auto snapshot = std::get<Snapshot::Percentiles>(metric.GetSnapshot());
+    EXPECT_EQ(snapshot.count, 1000);
+    for (size_t i = 0; i < snapshot.points.size(); ++i) {
+        EXPECT_DOUBLE_EQ(snapshot.points[i].percentile, Snapshot::Percentiles::kPercentiles[i]);
+    }
+    EXPECT_NEAR(snapshot.points[0].value, 900'000, 900'000 * 0.01);
+    EXPECT_LE(snapshot.points[0].value, snapshot.points[1].value);
+    EXPECT_LE(snapshot.points[2].value, snapshot.points[3].value);
+
+    OutputBuffer text;
+    Format::AppendPercentiles(text, snapshot, "ns");
+    EXPECT_EQ(text, metric.GetValueAsString());
+}
+
+TEST(MetricSnapshotTest, Duration) {
+    CodeTimeMetric metric("\"Task\"");
+    metric.Start();
+    std::this_thread::sleep_for(2ms);
+    metric.Stop();
+    auto snapshot = std::get<Snapshot::Duration>(metric.GetSnapshot());
+    EXPECT_GE(snapshot.value, 2ms);
+}
+
+TEST(MetricSnapshotTest, TopN) {
+    CardinalityMetricType types(2);
+    types.Observe(1, 5);
+    types.Observe(std::string("a"), 3);
+    types.Observe(2.0, 1);
+    auto top = std::get<Snapshot::TopN>(types.GetSnapshot());
+    EXPECT_EQ(top.unique, 3);
+    ASSERT_EQ(top.items.size(), 2);
+    EXPECT_EQ(top.items[0].label, "int");
+    EXPECT_EQ(top.items[0].count, 5);
+    EXPECT_EQ(top.items[1].count, 3);
+
+    CardinalityMetricValue<int, std::string> values(5);
+    values.Observe(7, 2);
+    values.Observe(std::string("x"), 1);
+    auto value_top = std::get<Snapshot::TopN>(values.GetSnapshot());
+    EXPECT_EQ(value_top.unique, 2);
+    ASSERT_EQ(value_top.items.size(), 2);
+    EXPECT_EQ(value_top.items[0].label, "int 7");
+    EXPECT_EQ(value_top.items[0].count, 2);
+    EXPECT_NE(values.GetValueAsString().find("int 7 (quantity: 2)"), std::string::npos);
+}
+
+TEST(MetricSnapshotTest, DefaultIsText) {
+    TextOnlyMetric metric;
+    auto snapshot = metric.GetSnapshot();
+    ASSERT_TRUE(std::holds_alternative<Snapshot::Text>(snapshot));
+    EXPECT_EQ(std::get<Snapshot::Text>(snapshot).value, "ok");
+}
+
+TEST(MetricSnapshotTest, ManagerCollectsWithoutReset) {
+    std::string log_name = "test_metric_snapshot.log";
+    {
+        MetricsManager manager(log_name);
+        manager.CreateMetric<IncrementMetric>("Requests", 3);
+        manager.CreateMetric<LatencyMetric>()->Observe(100ns);
+        manager.CreateMetric<TextOnlyMetric>();
+
+        std::vector<NamedSnapshot> snapshots;
+        manager.CollectSnapshots(snapshots);
+        ASSERT_EQ(snapshots.size(), 3);
+        EXPECT_EQ(snapshots[0].name, "Requests");
+        EXPECT_EQ(std::get<Snapshot::Counter>(snapshots[0].value).value, 3);
+        EXPECT_EQ(KindOf(snapshots[1].value), "percentiles");
+        EXPECT_EQ(KindOf(snapshots[2].value), "text");
+
+        snapshots.clear();
+        manager.CollectSnapshots(snapshots);
+        EXPECT_EQ(std::get<Snapshot::Counter>(snapshots[0].value).value, 3);
+    }
+    std::filesystem::remove(log_name);
+}
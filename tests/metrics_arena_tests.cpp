@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include "MetricsManager/MetricsArena.h"
+#include "MetricsManager/MetricsManager.h"
+#include "IMetrics/HTTPIncomeMetric.h"
+#include "IMetrics/IncrementMetric.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+using namespace MetricsMemory;
+
+namespace {
+
+class TrackedMetric final : public Metrics::IMetric {
+public:
+    explicit TrackedMetric(int* destroyed, bool fail=false) : destroyed_(destroyed) {
+        if (fail) {
+            throw std::runtime_error("TrackedMetric construction failed");
+        }
+    }
+    ~TrackedMetric() override { ++(*destroyed_); }
+
+    std::string GetName() const override { return "Tracked"; }
+    std::string GetValueAsString() const override { return "0"; }
+    void Evaluate() override {}
+    void Reset() override {}
+
+private:
+    int* destroyed_;
+};
+
+std::uintptr_t Address(const void* p) {
+    return reinterpret_cast<std::uintptr_t>(p);
+}
+
+}
+
+TEST(MetricsArenaTest, SameTypeMetricsAreContiguous) {
+    MetricsArena arena;
+    std::vector<MetricPtr> owners;
+    std::vector<Metrics::IncrementMetric*> counters;
+
+    for (int i = 0; i < 16; ++i) {
+        auto [counter, counter_owner] = arena.Create<Metrics::IncrementMetric>("Counter", i);
+        auto [http, http_owner] = arena.Create<Metrics::HTTPIncomeMetric>();
+        counters.push_back(counter);
+        owners.push_back(std::move(counter_owner));
+        owners.push_back(std::move(http_owner));
+    }
+
+    for (size_t i = 1; i < counters.size(); ++i) {
+        EXPECT_EQ(Address(counters[i]) - Address(counters[i - 1]), sizeof(Metrics::IncrementMetric));
+    }
+}
+
+TEST(MetricsArenaTest, ConstructorArgumentsAreForwarded) {
+    MetricsArena arena;
+    auto [counter, owner] = arena.Create<Metrics::IncrementMetric>("ArenaCounter", 7);
+
+    EXPECT_EQ(counter->GetName(), "ArenaCounter");
+    EXPECT_EQ(counter->GetValueAsString(), "7");
+    EXPECT_EQ(owner.get(), counter);
+}
+
+TEST(MetricsArenaTest, ReleasingMetricRunsDestructor) {
+    MetricsArena arena;
+    int destroyed = 0;
+    {
+        auto [metric, owner] = arena.Create<TrackedMetric>(&destroyed);
+        EXPECT_EQ(destroyed, 0);
+    }
+    EXPECT_EQ(destroyed, 1);
+}
+
+TEST(MetricsArenaTest, ReleasedSlotIsReused) {
+    MetricsArena arena;
+    int destroyed = 0;
+
+    auto [first, first_owner] = arena.Create<TrackedMetric>(&destroyed);
+    const void* first_address = first;
+    first_owner.reset();
+
+    auto [second, second_owner] = arena.Create<TrackedMetric>(&destroyed);
+    EXPECT_EQ(static_cast<const void*>(second), first_address);
+}
+
+TEST(MetricsArenaTest, ThrowingConstructorReturnsSlot) {
+    MetricsArena arena;
+    int destroyed = 0;
+
+    EXPECT_THROW(arena.Create<TrackedMetric>(&destroyed, true), std::runtime_error);
+
+    auto [metric, owner] = arena.Create<TrackedMetric>(&destroyed);
+    auto [next, next_owner] = arena.Create<TrackedMetric>(&destroyed);
+    EXPECT_EQ(Address(next) - Address(metric), sizeof(TrackedMetric));
+    EXPECT_EQ(destroyed, 0);
+}
+
+TEST(MetricsArenaTest, HugePageArenaAllocates) {
+    MetricsArena arena({.use_huge_pages = true});
+    EXPECT_TRUE(arena.UsesHugePages());
+
+    std::vector<MetricPtr> owners;
+    for (int i = 0; i < 1000; ++i) {
+        auto [counter, owner] = arena.Create<Metrics::IncrementMetric>("HugeCounter", i);
+        ++(*counter);
+        owners.push_back(std::move(owner));
+    }
+    EXPECT_EQ(owners.back()->GetValueAsString(), "1000");
+}
+
+TEST(MetricsArenaTest, ManagerWithHugePageArena) {
+    const std::string file_name = "test_metrics_arena_huge_pages.log";
+    {
+        MetricsManager<> manager(file_name, {.use_huge_pages = true});
+        auto* counter = manager.CreateMetric<Metrics::IncrementMetric>("ManagerCounter", 3);
+        EXPECT_EQ(manager.GetMetric<Metrics::IncrementMetric>(0), counter);
+        EXPECT_NO_THROW(manager.Log());
+        EXPECT_EQ(counter->GetValueAsString(), "0");
+    }
+    std::filesystem::remove(file_name);
+}
@@ -8,6 +8,8 @@
 #include "IMetrics/IncrementMetric.h"
 #include "IMetrics/CardinalityMetricType.h"
 #include "IMetrics/CardinalityMetricValue.h"
+#include "MultiThreadWriter/LogDecoder.h"
+#include "TestFileName.h"
 #include <thread>
 #include <chrono>
 #include <vector>
@@ -16,11 +18,105 @@
 #include <fstream>
 #include <random>
 #include <regex>
+#include <set>
+#include <sstream>
+
+namespace {
+
+std::chrono::steady_clock::time_point manual_now{};
+
+struct ManualClock {
+    static std::chrono::steady_clock::time_point now() noexcept {
+        return manual_now;
+    }
+};
+
+class SlowCollector final : public Metrics::IMetric {
+public:
+    SlowCollector(std::string name, std::chrono::nanoseconds interval, std::chrono::milliseconds delay = {})
+        : name_(std::move(name)), interval_(interval), delay_(delay) {}
+
+    std::string GetName() const override { return name_; }
+    std::string GetValueAsString() const override { return std::to_string(evaluations_.load()); }
+    void Evaluate() override {
+        std::this_thread::sleep_for(delay_);
+        ++evaluations_;
+    }
+    void Reset() override { ++resets_; }
+    std::chrono::nanoseconds MinEvaluateInterval() const noexcept override { return interval_; }
+
+    std::atomic<int> evaluations_{0};
+    std::atomic<int> resets_{0};
+
+private:
+    std::string name_;
+    std::chrono::nanoseconds interval_;
+    std::chrono::milliseconds delay_;
+};
+
+// Records its destruction, to check when removed metrics are reclaimed.
+class DestructionProbe final : public Metrics::IMetric {
+public:
+    explicit DestructionProbe(std::atomic<bool>& destroyed) : destroyed_(destroyed) {}
+    ~DestructionProbe() override { destroyed_ = true; }
+
+    std::string GetName() const override { return "Probe"; }
+    std::string GetValueAsString() const override { return "0"; }
+    void Evaluate() override {}
+    void Reset() override {}
+
+private:
+    std::atomic<bool>& destroyed_;
+};
+
+using QueueMetricTag = MetricTags::UserTag<0>;
+
+class QueueDepth final : public Metrics::IMetric, public QueueMetricTag, public MetricTags::ServerMetricTag {
+public:
+    std::string GetName() const override { return "QueueDepth"; }
+    std::string GetValueAsString() const override { return "3"; }
+    void Evaluate() override {}
+    void Reset() override {}
+};
+
+static_assert(MetricTags::kTagsOf<QueueDepth> == MetricTags::MaskOf<QueueMetricTag, MetricTags::ServerMetricTag>());
+static_assert(MetricTags::kTagsOf<Metrics::IncrementMetric> == 0);
+
+// Without a bit of their own these would select every metric, or every server metric.
+struct NoBitTag : MetricTags::DefaultMetricTag {};
+struct DerivedServerTag : MetricTags::ServerMetricTag {};
+struct DerivedQueueTag : QueueMetricTag {};
+struct UnregisteredBitTag : MetricTags::DefaultMetricTag {
+    static constexpr MetricTags::TagMask kTagMask = MetricTags::TagMask{1} << 63;
+};
+static_assert(MetricTags::Tag<MetricTags::ServerMetricTag> && MetricTags::Tag<QueueMetricTag>);
+static_assert(!MetricTags::Tag<MetricTags::DefaultMetricTag> && !MetricTags::Tag<NoBitTag>);
+static_assert(!MetricTags::Tag<DerivedServerTag> && !MetricTags::Tag<DerivedQueueTag>);
+static_assert(!MetricTags::Tag<UnregisteredBitTag>);
+
+class BaseCounter : public Metrics::IMetric {
+public:
+    explicit BaseCounter(std::string name) : name_(std::move(name)) {}
+    std::string GetName() const override { return name_; }
+    std::string GetValueAsString() const override { return "1"; }
+    void Evaluate() override {}
+    void Reset() override {}
+
+private:
+    std::string name_;
+};
+
+class DerivedCounter final : public BaseCounter {
+public:
+    DerivedCounter() : BaseCounter("DerivedCounter") {}
+};
+
+}
 
 class MetricsManagerTest : public ::testing::Test {
 protected:
     void SetUp() override {
-        test_file_name_ = "test_metrics_" + std::to_string(test_counter_++) + ".log";
+        test_file_name_ = TestFileName("test_metrics_", ".log");
         manager_ = std::make_unique<MetricsManager<>>(test_file_name_);
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
@@ -53,7 +149,6 @@ protected:
 
     std::unique_ptr<MetricsManager<>> manager_;
     std::string test_file_name_;
-    static inline std::atomic<int> test_counter_{0};
 };
 
 TEST_F(MetricsManagerTest, CreateIncrementMetricWithObject) {
@@ -89,11 +184,12 @@ TEST_F(MetricsManagerTest, CreateCPUUtilMetric) {
 }
 
 TEST_F(MetricsManagerTest, CreateHTTPIncomeMetric) {
-    auto* ptr = manager_->CreateMetric<Metrics::HTTPIncomeMetric>(50);
+    auto* ptr = manager_->CreateMetric<Metrics::BasicHTTPIncomeMetric<ManualClock>>();
     ASSERT_NE(ptr, nullptr);
     EXPECT_EQ(ptr->GetName(), "\"HTTPS requests RPS\"");
     ++(*ptr);
     ++(*ptr);
+    manual_now += std::chrono::seconds(1);
     ptr->Evaluate();
     EXPECT_EQ(ptr->GetValueAsString(), "2.00");
 }
@@ -153,7 +249,7 @@ TEST_F(MetricsManagerTest, CreateCardinalityMetricValue) {
 TEST_F(MetricsManagerTest, GetMetricValidIndex) {
     manager_->CreateMetric<Metrics::IncrementMetric>("Counter1", 10);
     manager_->CreateMetric<Metrics::CPUUsageMetric>();
-    manager_->CreateMetric<Metrics::HTTPIncomeMetric>(5);
+    manager_->CreateMetric<Metrics::HTTPIncomeMetric>();
     
     auto* metric1 = manager_->GetMetric<Metrics::IncrementMetric>(0);
     auto* metric2 = manager_->GetMetric<Metrics::CPUUsageMetric>(1);
@@ -178,7 +274,7 @@ TEST_F(MetricsManagerTest, GetMetricInvalidIndex) {
 TEST_F(MetricsManagerTest, GetMetricWrongType) {
     manager_->CreateMetric<Metrics::IncrementMetric>("Counter", 5);
     manager_->CreateMetric<Metrics::CPUUsageMetric>();
-    manager_->CreateMetric<Metrics::HTTPIncomeMetric>(10);
+    manager_->CreateMetric<Metrics::HTTPIncomeMetric>();
     
     EXPECT_THROW(manager_->GetMetric<Metrics::CPUUsageMetric>(0), std::runtime_error);
     EXPECT_THROW(manager_->GetMetric<Metrics::IncrementMetric>(1), std::runtime_error);
@@ -215,7 +311,7 @@ TEST_F(MetricsManagerTest, IncrementMetricFunctionality) {
 }
 
 // TEST_F(MetricsManagerTest, HTTPIncomeMetricFunctionality) {
-//     auto* metric = manager_->CreateMetric<Metrics::HTTPIncomeMetric>(0);
+//     auto* metric = manager_->CreateMetric<Metrics::HTTPIncomeMetric>();
     
 //     for (int i = 0; i < 25; ++i) {
 //         ++(*metric);
@@ -327,7 +423,7 @@ TEST_F(MetricsManagerTest, LogAllMetricsDefault) {
     manager_->CreateMetric<Metrics::IncrementMetric>("Counter1", 10);
     manager_->CreateMetric<Metrics::IncrementMetric>("Counter2", 20);
     manager_->CreateMetric<Metrics::CPUUsageMetric>();
-    manager_->CreateMetric<Metrics::HTTPIncomeMetric>(30);
+    manager_->CreateMetric<Metrics::HTTPIncomeMetric>();
     
     manager_->Log();
     
@@ -341,7 +437,7 @@ TEST_F(MetricsManagerTest, LogAllMetricsDefault) {
 TEST_F(MetricsManagerTest, LogMetricsByDefaultTag) {
     manager_->CreateMetric<Metrics::IncrementMetric>("DefaultCounter", 10);
     manager_->CreateMetric<Metrics::CPUUsageMetric>();
-    manager_->CreateMetric<Metrics::HTTPIncomeMetric>(5);
+    manager_->CreateMetric<Metrics::HTTPIncomeMetric>();
     manager_->CreateMetric<Metrics::CodeTimeMetric>("TestAlgo");
     manager_->CreateMetric<Metrics::CardinalityMetricType>(3);
     
@@ -359,7 +455,7 @@ TEST_F(MetricsManagerTest, LogMetricsByComputerTag) {
     manager_->CreateMetric<Metrics::CPUUsageMetric>();
     manager_->CreateMetric<Metrics::CPUMetric>();
     manager_->CreateMetric<Metrics::LatencyMetric>();
-    manager_->CreateMetric<Metrics::HTTPIncomeMetric>(50);
+    manager_->CreateMetric<Metrics::HTTPIncomeMetric>();
     manager_->CreateMetric<Metrics::CodeTimeMetric>("Algorithm1");
     manager_->CreateMetric<Metrics::IncrementMetric>("Counter", 5);
     
@@ -375,7 +471,7 @@ TEST_F(MetricsManagerTest, LogMetricsByComputerTag) {
 }
 
 TEST_F(MetricsManagerTest, LogMetricsByServerTag) {
-    manager_->CreateMetric<Metrics::HTTPIncomeMetric>(100);
+    manager_->CreateMetric<Metrics::HTTPIncomeMetric>();
     manager_->CreateMetric<Metrics::CPUUsageMetric>();
     manager_->CreateMetric<Metrics::IncrementMetric>("General", 5);
     manager_->CreateMetric<Metrics::CodeTimeMetric>("TestAlgo");
@@ -392,7 +488,7 @@ TEST_F(MetricsManagerTest, LogMetricsByServerTag) {
 TEST_F(MetricsManagerTest, LogMetricsByAlgoTag) {
     manager_->CreateMetric<Metrics::CodeTimeMetric>("TestAlgorithm");
     manager_->CreateMetric<Metrics::CPUUsageMetric>();
-    manager_->CreateMetric<Metrics::HTTPIncomeMetric>(25);
+    manager_->CreateMetric<Metrics::HTTPIncomeMetric>();
     manager_->CreateMetric<Metrics::IncrementMetric>("Counter", 10);
     
     manager_->Log<MetricTags::AlgoMetricTag>();
@@ -404,9 +500,103 @@ TEST_F(MetricsManagerTest, LogMetricsByAlgoTag) {
     EXPECT_FALSE(log_content.find("Counter") != std::string::npos);
 }
 
+TEST_F(MetricsManagerTest, LogWithCombinedTagFilters) {
+    manager_->CreateMetric<Metrics::HTTPIncomeMetric>();
+    manager_->CreateMetric<Metrics::CPUUsageMetric>();
+    manager_->CreateMetric<Metrics::CodeTimeMetric>("\"Sorting\"");
+    manager_->CreateMetric<Metrics::IncrementMetric>("Plain", 1);
+    manager_->CreateMetric<QueueDepth>();
+    
+    using namespace MetricTags;
+    manager_->Log(AnyOf<ServerMetricTag, AlgoMetricTag>() & NoneOf<QueueMetricTag>());
+    manager_->Log(AllOf<ServerMetricTag, QueueMetricTag>());
+    manager_->Log<QueueMetricTag>();
+    manager_->Log(NoneOf<ServerMetricTag, ComputerMetricTag, AlgoMetricTag>());
+    
+    std::string log_content = ReadLogFile();
+    auto count = [&log_content](const std::string& text) {
+        size_t found = 0;
+        for (size_t pos = log_content.find(text); pos != std::string::npos; pos = log_content.find(text, pos + 1)) {
+            ++found;
+        }
+        return found;
+    };
+    EXPECT_EQ(count("HTTPS"), 1);
+    EXPECT_EQ(count("Sorting"), 1);
+    EXPECT_EQ(count("QueueDepth: 3"), 2);
+    EXPECT_EQ(count("Plain: 1"), 1);
+    EXPECT_EQ(count("CPU Usage"), 0);
+}
+
+TEST_F(MetricsManagerTest, AnyOfGroupsMustAllMatch) {
+    using namespace MetricTags;
+    constexpr TagFilter filter = AnyOf<ServerMetricTag>() & AnyOf<AlgoMetricTag, QueueMetricTag>();
+    static_assert(!filter.Matches(kTagsOf<Metrics::HTTPIncomeMetric>));
+    static_assert(filter.Matches(kTagsOf<QueueDepth>));
+    EXPECT_FALSE((AnyOf<ServerMetricTag>() & AnyOf<AlgoMetricTag>()).Matches(ServerMetricTag::kTagMask));
+    // A wider group adds nothing to a narrower one.
+    TagFilter narrowed = AnyOf<ServerMetricTag, AlgoMetricTag>() & AnyOf<ServerMetricTag>();
+    EXPECT_TRUE(narrowed.Matches(ServerMetricTag::kTagMask));
+    EXPECT_FALSE(narrowed.Matches(AlgoMetricTag::kTagMask));
+    EXPECT_THROW(AnyOf<UserTag<1>>() & AnyOf<UserTag<2>>() & AnyOf<UserTag<3>>() & AnyOf<UserTag<4>>() & AnyOf<UserTag<5>>(),
+                 std::length_error);
+
+    manager_->CreateMetric<Metrics::HTTPIncomeMetric>();
+    manager_->CreateMetric<Metrics::CodeTimeMetric>("\"Sorting\"");
+    manager_->CreateMetric<QueueDepth>();
+    manager_->Log(AnyOf<ServerMetricTag>() & AnyOf<AlgoMetricTag, QueueMetricTag>());
+
+    std::string log_content = ReadLogFile();
+    EXPECT_EQ(log_content.find("HTTPS"), std::string::npos) << log_content;
+    EXPECT_EQ(log_content.find("Sorting"), std::string::npos) << log_content;
+    EXPECT_NE(log_content.find("QueueDepth: 3"), std::string::npos) << log_content;
+}
+
+TEST_F(MetricsManagerTest, LogByMetricClass) {
+    manager_->CreateMetric<Metrics::HTTPIncomeMetric>();
+    manager_->CreateMetric<Metrics::IncrementMetric>("Counter", 2);
+    
+    manager_->Log<Metrics::IncrementMetric>();
+    EXPECT_TRUE(manager_->LogChunk<Metrics::IncrementMetric>(10));
+    
+    std::string log_content = ReadLogFile();
+    EXPECT_NE(log_content.find("Counter: 2"), std::string::npos);
+    EXPECT_EQ(log_content.find("HTTPS"), std::string::npos);
+}
+
+TEST_F(MetricsManagerTest, LogByMetricClassIncludesSubclasses) {
+    manager_->CreateMetric<BaseCounter>("BaseCounter");
+    manager_->CreateMetric<DerivedCounter>();
+    manager_->CreateMetric<Metrics::IncrementMetric>("Plain", 1);
+    
+    manager_->Log<BaseCounter>();
+    manager_->Log<DerivedCounter>();
+    
+    std::string log_content = ReadLogFile();
+    auto count = [&log_content](const std::string& text) {
+        size_t found = 0;
+        for (size_t pos = log_content.find(text); pos != std::string::npos; pos = log_content.find(text, pos + 1)) {
+            ++found;
+        }
+        return found;
+    };
+    EXPECT_EQ(count("BaseCounter: 1"), 1);
+    EXPECT_EQ(count("DerivedCounter: 1"), 2);
+    EXPECT_EQ(count("Plain"), 0);
+}
+
+TEST_F(MetricsManagerTest, UserTagsInDictionaryMetadata) {
+    manager_->SetLogEncoding(NonBlockingWriter::LogEncoding::Dictionary);
+    manager_->CreateMetric<QueueDepth>();
+    manager_->Log();
+    
+    std::string log_content = ReadLogFile();
+    EXPECT_NE(log_content.find("::QueueDepth\t\tserver,user0\tQueueDepth"), std::string::npos) << log_content;
+}
+
 TEST_F(MetricsManagerTest, MetricResetAfterLog) {
     auto* counter = manager_->CreateMetric<Metrics::IncrementMetric>("ResetTest", 5);
-    auto* http_metric = manager_->CreateMetric<Metrics::HTTPIncomeMetric>(0);
+    auto* http_metric = manager_->CreateMetric<Metrics::BasicHTTPIncomeMetric<ManualClock>>();
     auto* cardinality = manager_->CreateMetric<Metrics::CardinalityMetricType>(3);
     
     ++(*counter);
@@ -418,6 +608,7 @@ TEST_F(MetricsManagerTest, MetricResetAfterLog) {
     cardinality->Observe(3.14);
     
     EXPECT_EQ(counter->GetValueAsString(), "7");
+    manual_now += std::chrono::seconds(1);
     http_metric->Evaluate();
     EXPECT_EQ(http_metric->GetValueAsString(), "3.00");
     EXPECT_TRUE(cardinality->GetValueAsString().find("unique elements: 2") != std::string::npos);
@@ -425,7 +616,8 @@ TEST_F(MetricsManagerTest, MetricResetAfterLog) {
     manager_->Log();
     
     EXPECT_EQ(counter->GetValueAsString(), "0");
-    EXPECT_EQ(http_metric->GetValueAsString(), "0.00");
+    // The rate is over the last second of the clock, not since the previous scrape.
+    EXPECT_EQ(http_metric->GetValueAsString(), "3.00");
     EXPECT_TRUE(cardinality->GetValueAsString().find("unique elements: 0") != std::string::npos);
 }
 
@@ -532,7 +724,7 @@ TEST_F(MetricsManagerTest, ConcurrentLoggingWithIncrementMetrics) {
 
 TEST_F(MetricsManagerTest, ConcurrentMixedMetricsOperation) {
     auto* increment_metric = manager_->CreateMetric<Metrics::IncrementMetric>("SharedCounter", 0);
-    auto* http_metric = manager_->CreateMetric<Metrics::HTTPIncomeMetric>(0);
+    auto* http_metric = manager_->CreateMetric<Metrics::BasicHTTPIncomeMetric<ManualClock>>();
     auto* latency_metric = manager_->CreateMetric<Metrics::LatencyMetric>();
     auto* code_timer = manager_->CreateMetric<Metrics::CodeTimeMetric>("SharedTimer");
     
@@ -566,6 +758,7 @@ TEST_F(MetricsManagerTest, ConcurrentMixedMetricsOperation) {
     int final_increment_value = std::stoi(increment_metric->GetValueAsString());
     EXPECT_EQ(final_increment_value, num_threads * 100);
     
+    manual_now += std::chrono::seconds(1);
     http_metric->Evaluate();
     EXPECT_EQ(http_metric->GetValueAsString(), "1000.00");
 }
@@ -620,7 +813,7 @@ TEST_F(MetricsManagerTest, AllMetricTypesIntegration) {
     auto* increment_metric = manager_->CreateMetric<Metrics::IncrementMetric>("IntegrationCounter", 0);
     auto* cpu_usage_metric = manager_->CreateMetric<Metrics::CPUUsageMetric>();
     auto* cpu_util_metric = manager_->CreateMetric<Metrics::CPUMetric>();
-    auto* http_metric = manager_->CreateMetric<Metrics::HTTPIncomeMetric>(0);
+    auto* http_metric = manager_->CreateMetric<Metrics::HTTPIncomeMetric>();
     auto* latency_metric = manager_->CreateMetric<Metrics::LatencyMetric>();
     auto* code_timer = manager_->CreateMetric<Metrics::CodeTimeMetric>("IntegrationAlgorithm");
     auto* cardinality_type = manager_->CreateMetric<Metrics::CardinalityMetricType>(3);
@@ -655,7 +848,6 @@ TEST_F(MetricsManagerTest, AllMetricTypesIntegration) {
     EXPECT_TRUE(log_content.find("CardinalityValue") != std::string::npos);
     
     EXPECT_EQ(increment_metric->GetValueAsString(), "0");
-    EXPECT_EQ(http_metric->GetValueAsString(), "0.00");
     EXPECT_GE(CountLinesInLog(), 8);
 }
 
@@ -695,4 +887,447 @@ TEST_F(MetricsManagerTest, SingleMetricMultipleLogging) {
     EXPECT_EQ(CountLinesInLog(), 2);
     EXPECT_TRUE(log_content.find("2") != std::string::npos);
     EXPECT_TRUE(log_content.find("3") != std::string::npos);
-}
\ No newline at end of file
+}
+
+TEST_F(MetricsManagerTest, RemoveMetricByIndex) {
+    manager_->CreateMetric<Metrics::IncrementMetric>("RemovedCounter", 1);
+    manager_->CreateMetric<Metrics::IncrementMetric>("KeptCounter", 2);
+    
+    EXPECT_TRUE(manager_->Remove(0));
+    EXPECT_FALSE(manager_->Remove(0));
+    EXPECT_THROW(manager_->GetMetric<Metrics::IncrementMetric>(0), std::out_of_range);
+    EXPECT_THROW(manager_->Remove(5), std::out_of_range);
+    
+    manager_->Log();
+    std::string log_content = ReadLogFile();
+    EXPECT_EQ(log_content.find("RemovedCounter"), std::string::npos);
+    EXPECT_NE(log_content.find("KeptCounter"), std::string::npos);
+}
+
+TEST_F(MetricsManagerTest, RemoveMetricByPointer) {
+    auto* metric = manager_->CreateMetric<Metrics::HTTPIncomeMetric>();
+    auto* other = manager_->CreateMetric<Metrics::IncrementMetric>("Other", 0);
+    
+    EXPECT_TRUE(manager_->Remove(metric));
+    EXPECT_FALSE(manager_->Remove(metric));
+    EXPECT_EQ(manager_->GetMetric<Metrics::IncrementMetric>(1), other);
+}
+
+TEST_F(MetricsManagerTest, RemovedIndexIsReused) {
+    manager_->CreateMetric<Metrics::IncrementMetric>("First", 0);
+    manager_->CreateMetric<Metrics::IncrementMetric>("Second", 0);
+    manager_->Remove(0);
+    
+    auto* reused = manager_->CreateMetric<Metrics::IncrementMetric>("Third", 0);
+    EXPECT_EQ(manager_->GetMetric<Metrics::IncrementMetric>(0), reused);
+    EXPECT_EQ(manager_->GetMetric<Metrics::IncrementMetric>(0)->GetName(), "Third");
+}
+
+TEST_F(MetricsManagerTest, PinKeepsRemovedMetricAlive) {
+    std::atomic<bool> destroyed{false};
+    auto* metric = manager_->CreateMetric<DestructionProbe>(destroyed);
+    
+    {
+        auto guard = manager_->Pin();
+        EXPECT_TRUE(manager_->Remove(metric));
+        EXPECT_FALSE(destroyed);
+        EXPECT_EQ(metric->GetName(), "Probe");
+    }
+    manager_->Log();
+    EXPECT_TRUE(destroyed);
+}
+
+TEST_F(MetricsManagerTest, PinnedRemovedIndexIsNotReused) {
+    manager_->CreateMetric<Metrics::IncrementMetric>("Removed", 0);
+    
+    {
+        auto guard = manager_->Pin();
+        manager_->Remove(0);
+        // A scrape pinned before Remove may still write slot 0.
+        manager_->CreateMetric<Metrics::IncrementMetric>("New", 0);
+        EXPECT_THROW(manager_->GetMetric<Metrics::IncrementMetric>(0), std::out_of_range);
+        EXPECT_EQ(manager_->GetMetric<Metrics::IncrementMetric>(1)->GetName(), "New");
+    }
+    manager_->Log();
+    
+    auto* reused = manager_->CreateMetric<Metrics::IncrementMetric>("Reused", 0);
+    EXPECT_EQ(manager_->GetMetric<Metrics::IncrementMetric>(0), reused);
+}
+
+TEST_F(MetricsManagerTest, ConcurrentRemoveAndLog) {
+    std::atomic<bool> stop{false};
+    
+    std::thread logger([&]() {
+        while (!stop) {
+            manager_->Log();
+        }
+    });
+    
+    for (int i = 0; i < 200; ++i) {
+        auto* metric = manager_->CreateMetric<Metrics::IncrementMetric>("Churn" + std::to_string(i), i);
+        ++(*metric);
+        EXPECT_TRUE(manager_->Remove(metric));
+    }
+    
+    stop = true;
+    logger.join();
+    EXPECT_THROW(manager_->Log(0), std::out_of_range);
+}
+
+TEST_F(MetricsManagerTest, LogSharesOneTimestampPerScrape) {
+    for (int i = 0; i < 50; ++i) {
+        manager_->CreateMetric<Metrics::IncrementMetric>("BatchCounter" + std::to_string(i), i);
+    }
+    
+    manager_->Log();
+    
+    std::istringstream content(ReadLogFile());
+    std::string line;
+    std::set<std::string> timestamps;
+    int lines = 0;
+    while (std::getline(content, line)) {
+        timestamps.insert(line.substr(0, 23));
+        ++lines;
+    }
+    EXPECT_EQ(lines, 50);
+    EXPECT_EQ(timestamps.size(), 1);
+}
+
+TEST_F(MetricsManagerTest, ManagersShareWriterService) {
+    NonBlockingWriter::WriterService service;
+    std::vector<std::string> file_names;
+    {
+        std::vector<std::unique_ptr<MetricsManager<>>> managers;
+        for (int i = 0; i < 4; ++i) {
+            file_names.push_back("test_shared_service_" + std::to_string(i) + ".log");
+            managers.push_back(std::make_unique<MetricsManager<>>(service, file_names.back()));
+            managers.back()->CreateMetric<Metrics::IncrementMetric>("SharedServiceCounter" + std::to_string(i), i);
+        }
+        for (auto& manager : managers) {
+            manager->Log();
+        }
+    }
+    
+    for (int i = 0; i < 4; ++i) {
+        std::ifstream file(file_names[i]);
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        EXPECT_NE(content.find("SharedServiceCounter" + std::to_string(i) + ": " + std::to_string(i)), std::string::npos);
+        std::filesystem::remove(file_names[i]);
+    }
+}
+
+TEST_F(MetricsManagerTest, LogChunkCoversPeriodOnce) {
+    for (int i = 0; i < 10; ++i) {
+        manager_->CreateMetric<Metrics::IncrementMetric>("ChunkCounter" + std::to_string(i), i);
+    }
+    
+    EXPECT_FALSE(manager_->LogChunk(4));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    // Created mid-period past its end: left for the next one.
+    manager_->CreateMetric<Metrics::IncrementMetric>("LateCounter", 100);
+    manager_->Remove(size_t{4});
+    EXPECT_FALSE(manager_->LogChunk(4));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_TRUE(manager_->LogChunk(4));
+    
+    std::istringstream content(ReadLogFile());
+    std::string line;
+    std::set<std::string> timestamps;
+    std::set<std::string> names;
+    int lines = 0;
+    while (std::getline(content, line)) {
+        timestamps.insert(line.substr(0, 23));
+        names.insert(line.substr(24, line.find(':', 24) - 24));
+        ++lines;
+    }
+    EXPECT_EQ(lines, 9);
+    EXPECT_EQ(names.size(), 9);
+    EXPECT_EQ(names.count("ChunkCounter4"), 0);
+    EXPECT_EQ(names.count("LateCounter"), 0);
+    EXPECT_EQ(timestamps.size(), 1);
+    
+    // The next period starts over and includes the new metric.
+    while (!manager_->LogChunk(4)) {}
+    EXPECT_TRUE(LogContains("LateCounter: 100"));
+    EXPECT_EQ(CountLinesInLog(), 19);
+}
+
+TEST_F(MetricsManagerTest, LogChunkFiltersByTag) {
+    manager_->CreateMetric<Metrics::IncrementMetric>("ChunkRequests", 3);
+    manager_->CreateMetric<Metrics::CPUUsageMetric>();
+    
+    EXPECT_FALSE(manager_->LogChunk<MetricTags::ComputerMetricTag>(1));
+    EXPECT_TRUE(manager_->LogChunk<MetricTags::ComputerMetricTag>(1));
+    
+    EXPECT_EQ(CountLinesInLog(), 1);
+    EXPECT_FALSE(LogContains("ChunkRequests"));
+}
+
+TEST_F(MetricsManagerTest, LogChunkEmptyManager) {
+    EXPECT_TRUE(manager_->LogChunk(0));
+    EXPECT_EQ(manager_->ChunkBudget(std::chrono::seconds(1), std::chrono::milliseconds(10)), 1);
+}
+
+TEST_F(MetricsManagerTest, ChunkBudgetSpreadsPeriod) {
+    for (int i = 0; i < 1000; ++i) {
+        manager_->CreateMetric<Metrics::IncrementMetric>("BudgetCounter" + std::to_string(i), 0);
+    }
+    
+    EXPECT_EQ(manager_->ChunkBudget(std::chrono::seconds(1), std::chrono::milliseconds(10)), 10);
+    EXPECT_EQ(manager_->ChunkBudget(std::chrono::seconds(1), std::chrono::milliseconds(300)), 334);
+    EXPECT_EQ(manager_->ChunkBudget(std::chrono::seconds(1), std::chrono::seconds(2)), 1000);
+    EXPECT_EQ(manager_->ChunkBudget(std::chrono::seconds(1), std::chrono::nanoseconds(0)), 1);
+    
+    size_t budget = manager_->ChunkBudget(std::chrono::seconds(1), std::chrono::milliseconds(100));
+    int calls = 1;
+    while (!manager_->LogChunk(budget)) {
+        ++calls;
+    }
+    EXPECT_EQ(calls, 10);
+    EXPECT_EQ(CountLinesInLog(), 1000);
+}
+
+TEST_F(MetricsManagerTest, ParallelLogKeepsRegistryOrder) {
+    MetricsExecution::WorkStealingPool pool(4);
+    manager_->SetExecutor(&pool, 7);
+    
+    for (int i = 0; i < 100; ++i) {
+        manager_->CreateMetric<Metrics::IncrementMetric>("ParallelCounter" + std::to_string(i), i);
+    }
+    manager_->CreateMetric<Metrics::CPUUsageMetric>();
+    manager_->Remove(size_t{50});
+    
+    manager_->Log();
+    EXPECT_EQ(manager_->GetMetric<Metrics::IncrementMetric>(3)->GetValueAsString(), "0");
+    manager_->Log<MetricTags::ComputerMetricTag>();
+    
+    std::istringstream content(ReadLogFile());
+    std::string line;
+    std::vector<std::string> names;
+    std::set<std::string> timestamps;
+    while (std::getline(content, line)) {
+        if (names.size() < 100) {
+            timestamps.insert(line.substr(0, 23));
+        }
+        names.push_back(line.substr(24, line.find(':', 24) - 24));
+    }
+    
+    ASSERT_EQ(names.size(), 101);
+    for (int i = 0, line_index = 0; i < 100; ++i) {
+        if (i == 50) continue;
+        EXPECT_EQ(names[line_index++], "ParallelCounter" + std::to_string(i));
+    }
+    EXPECT_EQ(names[100], names[99]);
+    EXPECT_EQ(timestamps.size(), 1);
+    
+    manager_->SetExecutor(nullptr);
+}
+
+TEST_F(MetricsManagerTest, ChangeOnlyLoggingWithKeyframes) {
+    manager_->SetChangeOnlyLogging(3);
+    auto* busy = manager_->CreateMetric<Metrics::IncrementMetric>("BusyCounter", 0);
+    manager_->CreateMetric<Metrics::IncrementMetric>("IdleCounter", 0);
+    
+    ++(*busy);
+    manager_->Log();    // keyframe: 2 lines
+    ++(*busy);
+    manager_->Log();    // busy: "1" again, unchanged
+    ++(*busy);
+    ++(*busy);
+    manager_->Log();    // busy: "2"
+    manager_->Log();    // keyframe: 2 lines
+    manager_->CreateMetric<Metrics::IncrementMetric>("NewCounter", 0);
+    manager_->Log();    // only the new counter
+    manager_->Log(1);   // explicit: always written
+    
+    std::istringstream content(ReadLogFile());
+    std::string line;
+    std::vector<std::string> lines;
+    while (std::getline(content, line)) {
+        lines.push_back(line.substr(24));
+    }
+    std::vector<std::string> expected = {
+        "BusyCounter: 1", "IdleCounter: 0",
+        "BusyCounter: 2",
+        "BusyCounter: 0", "IdleCounter: 0",
+        "NewCounter: 0",
+        "IdleCounter: 0",
+    };
+    EXPECT_EQ(lines, expected);
+}
+
+TEST_F(MetricsManagerTest, ChangeOnlyLoggingReusedSlot) {
+    manager_->SetChangeOnlyLogging(100);
+    manager_->CreateMetric<Metrics::IncrementMetric>("OldCounter", 5);
+    manager_->Log();
+    manager_->Remove(size_t{0});
+    manager_->CreateMetric<Metrics::IncrementMetric>("ReplacementCounter", 0);
+    manager_->Log();
+    manager_->Log();
+    
+    EXPECT_EQ(CountLinesInLog(), 2);
+    EXPECT_TRUE(LogContains("ReplacementCounter: 0"));
+    
+    manager_->SetChangeOnlyLogging(0);
+    manager_->Log();
+    EXPECT_EQ(CountLinesInLog(), 3);
+}
+
+TEST_F(MetricsManagerTest, EvaluateCachedWithinInterval) {
+    auto* cached = manager_->CreateMetric<SlowCollector>("CachedCollector", std::chrono::hours(1));
+    auto* plain = manager_->CreateMetric<SlowCollector>("PlainCollector", std::chrono::nanoseconds::zero());
+    
+    manager_->Log();
+    manager_->Log(0);
+    manager_->Log<MetricTags::DefaultMetricTag>();
+    
+    EXPECT_EQ(cached->evaluations_.load(), 1);
+    EXPECT_EQ(cached->resets_.load(), 1);
+    EXPECT_EQ(plain->evaluations_.load(), 2);
+    
+    std::string log_content = ReadLogFile();
+    size_t cached_lines = 0;
+    for (size_t pos = log_content.find("CachedCollector: 1"); pos != std::string::npos;
+         pos = log_content.find("CachedCollector: 1", pos + 1)) {
+        ++cached_lines;
+    }
+    EXPECT_EQ(cached_lines, 3);
+}
+
+TEST_F(MetricsManagerTest, LogPastDeadlineMarksStale) {
+    auto* collector = manager_->CreateMetric<SlowCollector>("DeadlineCollector", std::chrono::nanoseconds::zero());
+    
+    manager_->Log(std::chrono::steady_clock::now());
+    manager_->Log();
+    manager_->Log(std::chrono::steady_clock::now());
+    manager_->Log(std::chrono::steady_clock::now() + std::chrono::hours(1));
+    
+    EXPECT_EQ(collector->evaluations_.load(), 2);
+    EXPECT_EQ(collector->resets_.load(), 2);
+    
+    std::istringstream content(ReadLogFile());
+    std::string line;
+    std::vector<std::string> lines;
+    while (std::getline(content, line)) {
+        lines.push_back(line.substr(24));
+    }
+    std::vector<std::string> expected = {
+        "DeadlineCollector: (stale)",
+        "DeadlineCollector: 1",
+        "DeadlineCollector: 1 (stale)",
+        "DeadlineCollector: 2",
+    };
+    EXPECT_EQ(lines, expected);
+}
+
+TEST_F(MetricsManagerTest, DeadlineScrapeSkipsBusyCollector) {
+    auto* slow = manager_->CreateMetric<SlowCollector>("BusyCollector", std::chrono::nanoseconds::zero(),
+                                                       std::chrono::milliseconds(300));
+    manager_->CreateMetric<Metrics::IncrementMetric>("QuickCounter", 7);
+    
+    // The first scrape holds the collector for 300 ms.
+    std::thread blocking([&]() { manager_->Log(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    
+    auto start = std::chrono::steady_clock::now();
+    manager_->Log(std::chrono::steady_clock::now() + std::chrono::milliseconds(100));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    blocking.join();
+    
+    EXPECT_LT(elapsed, std::chrono::milliseconds(200));
+    EXPECT_EQ(slow->evaluations_.load(), 1);
+    EXPECT_TRUE(LogContains("BusyCollector: (stale)"));
+    EXPECT_TRUE(LogContains("BusyCollector: 1"));
+}
+
+TEST_F(MetricsManagerTest, DictionaryEncodingDecodesToText) {
+    manager_->SetLogEncoding(NonBlockingWriter::LogEncoding::Dictionary);
+    auto* requests = manager_->CreateMetric<Metrics::IncrementMetric>("\"HTTPS requests\"", 0);
+    manager_->CreateMetric<Metrics::HTTPIncomeMetric>();
+    
+    ++(*requests);
+    manager_->Log();
+    ++(*requests);
+    manager_->Log();
+    manager_->SetLogEncoding(NonBlockingWriter::LogEncoding::Dictionary);
+    manager_->Log(0);
+    
+    std::string raw = ReadLogFile();
+    size_t definitions = 0;
+    for (size_t pos = raw.find("M\t0\t"); pos != std::string::npos; pos = raw.find("M\t0\t", pos + 1)) {
+        ++definitions;
+    }
+    EXPECT_EQ(definitions, 2);
+    EXPECT_NE(raw.find("M\t1\tMetrics::HTTPIncomeMetric\trps\tserver\t"), std::string::npos);
+    
+    std::istringstream in(raw);
+    std::ostringstream out;
+    NonBlockingWriter::LogDecoder::Decode(in, out);
+    std::istringstream decoded(out.str());
+    std::string line;
+    std::vector<std::string> lines;
+    while (std::getline(decoded, line)) {
+        lines.push_back(line.substr(24));
+    }
+    std::vector<std::string> expected = {
+        "\"HTTPS requests\": 1", "\"HTTPS requests RPS\": 0.00",
+        "\"HTTPS requests\": 1", "\"HTTPS requests RPS\": 0.00",
+        "\"HTTPS requests\": 0",
+    };
+    EXPECT_EQ(lines, expected);
+}
+
+TEST(MetricsManagerDictionaryTest, FailedWriteDefinesMetricAgain) {
+    std::string log_name = "test_dictionary_failed_write.log";
+    NonBlockingWriter::WriterService service;
+    {
+        MetricsManager manager(service, log_name);
+        manager.SetLogEncoding(NonBlockingWriter::LogEncoding::Dictionary);
+        manager.CreateMetric<Metrics::IncrementMetric>("\"Requests\"", 7);
+        
+        // The writer refuses the batch carrying the definition.
+        service.Stop();
+        manager.Log();
+        ASSERT_TRUE(service.Start());
+        manager.Log();
+    }
+    service.Stop();
+    
+    std::ifstream file(log_name);
+    std::string raw((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::filesystem::remove(log_name);
+    EXPECT_NE(raw.find("M\t0\tMetrics::IncrementMetric\t"), std::string::npos) << raw;
+    std::istringstream in(raw);
+    std::ostringstream out;
+    NonBlockingWriter::LogDecoder::Decode(in, out);
+    EXPECT_NE(out.str().find("\"Requests\": 0"), std::string::npos) << raw;
+}
+
+TEST_F(MetricsManagerTest, DictionaryEncodingWithExecutor) {
+    MetricsExecution::WorkStealingPool pool(2);
+    manager_->SetExecutor(&pool, 4);
+    manager_->SetLogEncoding(NonBlockingWriter::LogEncoding::Dictionary);
+    for (int i = 0; i < 20; ++i) {
+        manager_->CreateMetric<Metrics::IncrementMetric>("EncodedCounter" + std::to_string(i), i);
+    }
+    manager_->Log();
+    manager_->SetExecutor(nullptr);
+    
+    std::string raw = ReadLogFile();
+    EXPECT_EQ(raw.find("T\t"), 0);
+    EXPECT_EQ(raw.find("T\t", 1), std::string::npos);
+    
+    std::istringstream in(raw);
+    NonBlockingWriter::LogDecoder decoder;
+    std::string line;
+    std::string decoded;
+    int index = 0;
+    while (std::getline(in, line)) {
+        if (decoder.DecodeLine(line, decoded)) {
+            EXPECT_EQ(decoded.substr(24), "EncodedCounter" + std::to_string(index) + ": " + std::to_string(index));
+            ++index;
+        }
+    }
+    EXPECT_EQ(index, 20);
+}
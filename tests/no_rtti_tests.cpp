@@ -0,0 +1,98 @@
+// Built with -fno-rtti: tag filtering, metric lookup and logging must not need RTTI.
+#include <gtest/gtest.h>
+#include "MetricsManager/MetricsManager.h"
+#include "MetricsManager/StaticMetricsManager.h"
+#include "IMetrics/HTTPIncomeMetric.h"
+#include "IMetrics/IncrementMetric.h"
+#include "IMetrics/LatencyMetric.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+static_assert(!METRICS_HAS_RTTI, "this test has to be built with -fno-rtti");
+
+namespace {
+    std::string ReadFile(const std::string& name) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        std::ifstream file(name);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+}
+
+TEST(NoRttiTest, ManagerFiltersAndLooksUpMetrics) {
+    std::string log_name = "test_no_rtti_manager.log";
+    {
+        MetricsManager<> manager(log_name);
+        auto* counter = manager.CreateMetric<Metrics::IncrementMetric>("Counter", 4);
+        manager.CreateMetric<Metrics::HTTPIncomeMetric>();
+        manager.CreateMetric<Metrics::LatencyMetric>();
+
+        EXPECT_EQ(manager.GetMetric<Metrics::IncrementMetric>(0), counter);
+        EXPECT_THROW(manager.GetMetric<Metrics::IncrementMetric>(1), std::runtime_error);
+
+        manager.Log<MetricTags::ServerMetricTag>();
+        manager.Log(MetricTags::NoneOf<MetricTags::ServerMetricTag, MetricTags::ComputerMetricTag>());
+        manager.SetLogEncoding(NonBlockingWriter::LogEncoding::Dictionary);
+        manager.Log<MetricTags::ComputerMetricTag>();
+    }
+
+    std::string content = ReadFile(log_name);
+    EXPECT_NE(content.find("\"HTTPS requests RPS\": 0.00"), std::string::npos);
+    EXPECT_NE(content.find("Counter: 4"), std::string::npos);
+    EXPECT_NE(content.find("Metrics::LatencyMetric\tns\tcomputer\t\"Percentile Latency\""), std::string::npos);
+    std::filesystem::remove(log_name);
+}
+
+namespace {
+    class BaseCounter : public Metrics::IMetric {
+    public:
+        explicit BaseCounter(std::string name) : name_(std::move(name)) {}
+        std::string GetName() const override { return name_; }
+        std::string GetValueAsString() const override { return "1"; }
+        void Evaluate() override {}
+        void Reset() override {}
+
+    private:
+        std::string name_;
+    };
+
+    class DerivedCounter final : public BaseCounter {
+    public:
+        DerivedCounter() : BaseCounter("DerivedCounter") {}
+    };
+}
+
+// Subclass matching needs dynamic_cast: without RTTI a class selects only metrics created as it.
+TEST(NoRttiTest, LogByMetricClassIsExact) {
+    std::string log_name = "test_no_rtti_class.log";
+    {
+        MetricsManager<> manager(log_name);
+        manager.CreateMetric<BaseCounter>("BaseCounter");
+        manager.CreateMetric<DerivedCounter>();
+        manager.Log<BaseCounter>();
+    }
+
+    std::string content = ReadFile(log_name);
+    EXPECT_NE(content.find("BaseCounter: 1"), std::string::npos);
+    EXPECT_EQ(content.find("DerivedCounter"), std::string::npos);
+    std::filesystem::remove(log_name);
+}
+
+TEST(NoRttiTest, StaticManagerFilters) {
+    std::string log_name = "test_no_rtti_static.log";
+    {
+        StaticMetricsManager<Metrics::IncrementMetric, Metrics::HTTPIncomeMetric> manager(
+            log_name, std::tuple("Counter", 1ull), std::tuple());
+        manager.Log<MetricTags::AllOf<MetricTags::ServerMetricTag>()>();
+    }
+
+    std::string content = ReadFile(log_name);
+    EXPECT_NE(content.find("HTTPS"), std::string::npos);
+    EXPECT_EQ(content.find("Counter"), std::string::npos);
+    std::filesystem::remove(log_name);
+}
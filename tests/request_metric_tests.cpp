@@ -0,0 +1,196 @@
+#include "IMetrics/RequestMetric.h"
+#include "MetricsManager/MetricsManager.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Metrics;
+using namespace std::chrono_literals;
+
+namespace {
+    std::chrono::steady_clock::time_point manual_now{};
+
+    std::chrono::steady_clock::time_point ManualNow() noexcept {
+        return manual_now;
+    }
+
+    std::size_t Index(StatusClass status) {
+        return static_cast<std::size_t>(status);
+    }
+}
+
+TEST(RequestMetricTest, TrackerCountsInFlight) {
+    RequestMetric metric("\"Requests\"", &ManualNow);
+    {
+        auto first = metric.Track();
+        auto second = metric.Track();
+        metric.Evaluate();
+        EXPECT_EQ(metric.LastInterval().in_flight, 2);
+        first.SetStatus(200);
+        second.SetStatus(200);
+    }
+    metric.Evaluate();
+    auto stats = metric.LastInterval();
+    EXPECT_EQ(stats.in_flight, 0);
+    EXPECT_EQ(stats.statuses[Index(StatusClass::Success)], 2u);
+    EXPECT_EQ(stats.latency.count, 2u);
+    EXPECT_EQ(metric.GetName(), "\"Requests\"");
+}
+
+TEST(RequestMetricTest, RecordsLatencyAndStatus) {
+    RequestMetric metric("\"Requests\"", &ManualNow);
+    for (int i = 0; i < 10; ++i) {
+        auto tracker = metric.Track();
+        manual_now += 1ms;
+        tracker.SetStatus(i < 9 ? 200 : 503);
+    }
+    metric.Evaluate();
+    auto stats = metric.LastInterval();
+    EXPECT_EQ(stats.statuses[Index(StatusClass::Success)], 9u);
+    EXPECT_EQ(stats.statuses[Index(StatusClass::ServerError)], 1u);
+    EXPECT_EQ(stats.latency.count, 10u);
+    // Log-linear buckets are within 1/64 of the value.
+    for (const auto& point : stats.latency.points) {
+        EXPECT_NEAR(point.value, 1e6, 1e6 / 64);
+    }
+}
+
+TEST(RequestMetricTest, MissingStatusCountsAsOther) {
+    RequestMetric metric("\"Requests\"", &ManualNow);
+    try {
+        auto tracker = metric.Track();
+        throw std::runtime_error("handler failed");
+    } catch (const std::runtime_error&) {
+    }
+    metric.Evaluate();
+    EXPECT_EQ(metric.LastInterval().statuses[Index(StatusClass::Other)], 1u);
+}
+
+TEST(RequestMetricTest, MovedTrackerCountsOnce) {
+    RequestMetric metric("\"Requests\"", &ManualNow);
+    {
+        std::optional<RequestMetric::Tracker> holder;
+        auto tracker = metric.Track();
+        tracker.SetStatus(404);
+        holder.emplace(std::move(tracker));
+    }
+    metric.Evaluate();
+    auto stats = metric.LastInterval();
+    EXPECT_EQ(stats.in_flight, 0);
+    EXPECT_EQ(stats.statuses[Index(StatusClass::ClientError)], 1u);
+    EXPECT_EQ(stats.latency.count, 1u);
+}
+
+TEST(RequestMetricTest, RateOfStartedRequests) {
+    RequestMetric metric("\"Requests\"", &ManualNow);
+    for (int i = 0; i < 20; ++i) {
+        metric.Track().SetStatus(200);
+    }
+    manual_now += 2s;
+    metric.Evaluate();
+    EXPECT_DOUBLE_EQ(metric.LastInterval().rps, 10.0);
+
+    manual_now += 1s;
+    metric.Evaluate();
+    EXPECT_DOUBLE_EQ(metric.LastInterval().rps, 0.0);
+    EXPECT_EQ(metric.LastInterval().statuses[Index(StatusClass::Success)], 20u);
+}
+
+TEST(RequestMetricTest, ValueString) {
+    RequestMetric metric("\"Requests\"", &ManualNow);
+    {
+        auto tracker = metric.Track();
+        manual_now += 1s;
+        tracker.SetStatus(201);
+    }
+    auto open = metric.Track();
+    metric.Evaluate();
+    std::string value = metric.GetValueAsString();
+    EXPECT_TRUE(value.starts_with("rps: 2.00, in flight: 1, 2xx: 1, P90: ")) << value;
+    EXPECT_EQ(value.find("5xx"), std::string::npos) << value;
+    open.SetStatus(200);
+}
+
+TEST(RequestMetricTest, ResetKeepsInFlight) {
+    RequestMetric metric("\"Requests\"", &ManualNow);
+    auto open = metric.Track();
+    metric.Track().SetStatus(500);
+    metric.Evaluate();
+    metric.Reset();
+    // The last stats stay until the next Evaluate().
+    auto stats = metric.LastInterval();
+    EXPECT_EQ(stats.in_flight, 1);
+    EXPECT_EQ(stats.statuses[Index(StatusClass::ServerError)], 1u);
+    EXPECT_EQ(stats.latency.count, 1u);
+
+    metric.Evaluate();
+    stats = metric.LastInterval();
+    EXPECT_EQ(stats.in_flight, 1);
+    EXPECT_EQ(stats.statuses[Index(StatusClass::ServerError)], 0u);
+    EXPECT_EQ(stats.latency.count, 0u);
+    open.SetStatus(200);
+}
+
+TEST(RequestMetricTest, RequestsFinishedDuringScrapeAreKept) {
+    RequestMetric metric("\"Requests\"", &ManualNow);
+    metric.Track().SetStatus(200);
+    manual_now += 1s;
+    metric.Evaluate();
+    // Finishes between the logged value and Reset().
+    metric.Track().SetStatus(200);
+    metric.Reset();
+    manual_now += 1s;
+    metric.Evaluate();
+    auto stats = metric.LastInterval();
+    EXPECT_DOUBLE_EQ(stats.rps, 1.0);
+    EXPECT_EQ(stats.statuses[Index(StatusClass::Success)], 1u);
+    EXPECT_EQ(stats.latency.count, 1u);
+}
+
+TEST(RequestMetricTest, ConcurrentTrackers) {
+    RequestMetric metric("\"Concurrent\"", &ManualNow);
+    constexpr int kThreads = 8;
+    constexpr int kRequests = 5000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&metric] {
+            for (int i = 0; i < kRequests; ++i) {
+                auto tracker = metric.Track();
+                tracker.SetStatus(i % 10 == 0 ? 500 : 200);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    metric.Evaluate();
+    auto stats = metric.LastInterval();
+    EXPECT_EQ(stats.in_flight, 0);
+    EXPECT_EQ(stats.latency.count, static_cast<std::uint64_t>(kThreads * kRequests));
+    EXPECT_EQ(stats.statuses[Index(StatusClass::ServerError)], static_cast<unsigned long long>(kThreads * kRequests / 10));
+    EXPECT_EQ(stats.statuses[Index(StatusClass::Success)], static_cast<unsigned long long>(kThreads * kRequests / 10 * 9));
+}
+
+TEST(RequestMetricTest, LoggedByManager) {
+    std::string log_name = "test_request_metric.log";
+    {
+        MetricsManager manager(log_name);
+        auto* metric = manager.CreateMetric<RequestMetric>("\"API requests\"");
+        metric->Track().SetStatus(200);
+        manager.Log();
+    }
+    std::ifstream log(log_name);
+    std::string content((std::istreambuf_iterator<char>(log)), std::istreambuf_iterator<char>());
+    EXPECT_NE(content.find("\"API requests\": rps: "), std::string::npos) << content;
+    EXPECT_NE(content.find("2xx: 1"), std::string::npos) << content;
+    log.close();
+    std::filesystem::remove(log_name);
+}
@@ -0,0 +1,272 @@
+#include <gtest/gtest.h>
+#include "MetricsManager/SharedArena.h"
+#include "MetricsManager/MetricsManager.h"
+#include "IMetrics/SharedMetrics.h"
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+using namespace MetricsMemory;
+using namespace Metrics;
+using namespace std::chrono_literals;
+
+namespace {
+    std::chrono::steady_clock::time_point manual_now{};
+
+    std::chrono::steady_clock::time_point ManualNow() noexcept {
+        return manual_now;
+    }
+}
+
+class SharedArenaTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        options_.name = "/metrics_arena_test_" + std::to_string(getpid()) + "_" + std::to_string(test_counter_++);
+    }
+
+    void TearDown() override {
+        SharedArena::Unlink(options_.name);
+    }
+
+    // Runs body in `count` forked children and waits for all of them.
+    template <typename Body>
+    void RunInChildren(int count, Body body) {
+        std::vector<pid_t> children;
+        for (int i = 0; i < count; ++i) {
+            pid_t pid = fork();
+            ASSERT_NE(pid, -1);
+            if (pid == 0) {
+                body(i);
+                _exit(0);
+            }
+            children.push_back(pid);
+        }
+        for (pid_t pid : children) {
+            int status = 0;
+            waitpid(pid, &status, 0);
+            EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        }
+    }
+
+    SharedArenaOptions options_;
+    static inline int test_counter_ = 0;
+};
+
+TEST_F(SharedArenaTest, FindReturnsSameObjectForKey) {
+    SharedArena arena(options_);
+    auto& first = arena.Find<SharedCounterState>("requests");
+    auto& again = arena.Find<SharedCounterState>("requests");
+    auto& other = arena.Find<SharedCounterState>("errors");
+
+    EXPECT_EQ(&first, &again);
+    EXPECT_NE(&first, &other);
+    EXPECT_EQ(first.value.load(), 0);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&other) % 64, 0);
+}
+
+TEST_F(SharedArenaTest, SecondArenaAttachesToSameSegment) {
+    SharedArena creator(options_);
+    creator.Find<SharedCounterState>("requests").value = 5;
+
+    SharedArena attached(options_);
+    EXPECT_EQ(attached.Find<SharedCounterState>("requests").value.load(), 5);
+}
+
+TEST_F(SharedArenaTest, InvalidUse) {
+    SharedArena arena(options_);
+    arena.Find<SharedCounterState>("counter");
+
+    EXPECT_THROW(arena.Find<SharedHistogramState>("counter"), std::runtime_error);
+    EXPECT_THROW(arena.Find<SharedCounterState>(""), std::runtime_error);
+    EXPECT_THROW(arena.Find<SharedCounterState>(std::string(SharedArena::kMaxKeySize + 1, 'k')), std::runtime_error);
+
+    SharedArenaOptions small = options_;
+    small.name += "_small";
+    small.size = 48 * 1024;
+    SharedArena small_arena(small);
+    EXPECT_NO_THROW(small_arena.Find<SharedHistogramState>("fits"));
+    EXPECT_THROW(small_arena.Find<SharedHistogramState>("does_not_fit"), std::runtime_error);
+    SharedArena::Unlink(small.name);
+}
+
+TEST_F(SharedArenaTest, ForkedWorkersShareCounters) {
+    SharedArena arena(options_);
+    SharedIncrementMetric requests(arena, "\"Requests\"");
+    SharedHTTPIncomeMetric http(arena, "http_income", &ManualNow);
+
+    RunInChildren(4, [&](int) {
+        for (int i = 0; i < 10000; ++i) {
+            ++requests;
+            http++;
+        }
+    });
+
+    requests.Evaluate();
+    EXPECT_EQ(requests.GetValueAsString(), "40000");
+    manual_now += 2s;
+    http.Evaluate();
+    EXPECT_EQ(http.GetValueAsString(), "20000.00");
+
+    requests.Reset();
+    EXPECT_EQ(requests.GetValueAsString(), "0");
+}
+
+TEST_F(SharedArenaTest, HTTPIncomeRateSurvivesScrapes) {
+    SharedArena arena(options_);
+    SharedHTTPIncomeMetric http(arena, "http_income", &ManualNow);
+    SharedHTTPIncomeMetric worker(arena, "http_income", &ManualNow);
+
+    for (int second = 0; second < 3; ++second) {
+        for (int i = 0; i < 100; ++i) {
+            ++worker;
+        }
+        manual_now += 1s;
+        http.Evaluate();
+        http.Reset();
+        EXPECT_EQ(http.GetValueAsString(), "100.00");
+        // A second scrape within the same second keeps the rate.
+        http.Evaluate();
+        http.Reset();
+        EXPECT_EQ(http.GetValueAsString(), "100.00");
+    }
+}
+
+TEST_F(SharedArenaTest, WorkersAttachingByName) {
+    {
+        SharedArena arena(options_);
+        SharedIncrementMetric requests(arena, "\"Requests\"");
+        ++requests;
+    }
+
+    RunInChildren(3, [&](int) {
+        SharedArena arena(options_);
+        SharedIncrementMetric requests(arena, "\"Requests\"");
+        for (int i = 0; i < 1000; ++i) {
+            ++requests;
+        }
+    });
+
+    SharedArena arena(options_);
+    SharedIncrementMetric requests(arena, "\"Requests\"");
+    requests.Evaluate();
+    EXPECT_EQ(requests.GetValueAsString(), "3001");
+}
+
+TEST_F(SharedArenaTest, IncrementsDuringScrapeAreKept) {
+    SharedArena arena(options_);
+    SharedIncrementMetric requests(arena, "\"Requests\"");
+    ++requests;
+    requests.Evaluate();
+    // Lands between the logged value and Reset().
+    ++requests;
+    EXPECT_EQ(requests.GetValueAsString(), "1");
+    requests.Reset();
+    EXPECT_EQ(requests.GetValueAsString(), "0");
+    requests.Evaluate();
+    EXPECT_EQ(requests.GetValueAsString(), "1");
+}
+
+TEST_F(SharedArenaTest, LookupSurvivesProcessKilledInside) {
+    SharedArena arena(options_);
+    for (int round = 0; round < 20; ++round) {
+        pid_t pid = fork();
+        ASSERT_NE(pid, -1);
+        if (pid == 0) {
+            SharedArena child_arena(options_);
+            while (true) {
+                child_arena.Find<SharedCounterState>("requests");
+            }
+        }
+        usleep(2000);
+        kill(pid, SIGKILL);
+        waitpid(pid, nullptr, 0);
+        // Would hang if the child died holding the lookup lock.
+        arena.Find<SharedCounterState>("requests").value++;
+    }
+    EXPECT_EQ(arena.Find<SharedCounterState>("requests").value.load(), 20);
+}
+
+TEST_F(SharedArenaTest, HistogramBuckets) {
+    EXPECT_EQ(SharedHistogramState::BucketIndex(0), 0);
+    EXPECT_EQ(SharedHistogramState::BucketIndex(63), 63);
+    EXPECT_EQ(SharedHistogramState::BucketIndex(-5), 0);
+    EXPECT_EQ(SharedHistogramState::BucketIndex(SharedHistogramState::kMaxValue + 1000), SharedHistogramState::kBuckets - 1);
+
+    for (std::int64_t value : {64LL, 100LL, 1000LL, 123456LL, 999999999LL, 3600000000000LL}) {
+        std::int64_t upper = SharedHistogramState::BucketUpperBound(SharedHistogramState::BucketIndex(value));
+        EXPECT_GE(upper, value);
+        EXPECT_LE(upper - value, value / 64);
+    }
+}
+
+TEST_F(SharedArenaTest, SamplesDuringScrapeAreKept) {
+    SharedArena arena(options_);
+    SharedLatencyMetric latency(arena);
+    SharedLatencyMetric worker_latency(arena);
+    constexpr int kSamples = 200000;
+    std::thread worker([&] {
+        for (int i = 0; i < kSamples; ++i) {
+            worker_latency.Observe(std::chrono::nanoseconds(i % 1000));
+        }
+    });
+    std::uint64_t logged = 0;
+    for (int scrape = 0; scrape < 100; ++scrape) {
+        latency.Evaluate();
+        logged += std::get<Snapshot::Percentiles>(latency.GetSnapshot()).count;
+        latency.Reset();
+    }
+    worker.join();
+    latency.Evaluate();
+    logged += std::get<Snapshot::Percentiles>(latency.GetSnapshot()).count;
+    EXPECT_EQ(logged, static_cast<std::uint64_t>(kSamples));
+}
+
+TEST_F(SharedArenaTest, ForkedWorkersShareLatencyHistogram) {
+    SharedArena arena(options_);
+    SharedLatencyMetric latency(arena);
+    EXPECT_EQ(latency.GetValueAsString(), "P90: 0ns, P95: 0ns, P99: 0ns, P999: 0ns");
+
+    RunInChildren(4, [&](int worker) {
+        for (int i = 1; i <= 25; ++i) {
+            latency.Observe(std::chrono::nanoseconds(worker * 25 + i));
+        }
+    });
+
+    latency.Evaluate();
+    EXPECT_EQ(latency.GetValueAsString(), "P90: 90ns, P95: 95ns, P99: 99ns, P999: 100ns");
+    latency.Reset();
+    EXPECT_EQ(latency.GetValueAsString(), "P90: 0ns, P95: 0ns, P99: 0ns, P999: 0ns");
+}
+
+TEST_F(SharedArenaTest, OneProcessLogsTheAggregate) {
+    SharedArena arena(options_);
+    SharedIncrementMetric worker_view(arena, "\"Requests\"");
+
+    RunInChildren(4, [&](int) {
+        for (int i = 0; i < 250; ++i) {
+            ++worker_view;
+        }
+    });
+
+    std::string log_name = "test_shared_arena_aggregate.log";
+    {
+        MetricsManager manager(log_name);
+        manager.CreateMetric<SharedIncrementMetric>(arena, "\"Requests\"");
+        manager.Log();
+    }
+
+    std::ifstream file(log_name);
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_NE(content.find("\"Requests\": 1000"), std::string::npos);
+    EXPECT_EQ(worker_view.GetValueAsString(), "0");
+    std::filesystem::remove(log_name);
+}
@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+#include "MetricsManager/SharedMemoryTable.h"
+#include "MetricsManager/MetricsManager.h"
+#include "IMetrics/IncrementMetric.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace MetricsServer;
+
+class SharedMemoryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        options_.name = "/metrics_shm_test_" + std::to_string(getpid()) + "_" + std::to_string(test_counter_++);
+        options_.capacity = 16;
+    }
+
+    SharedMemoryOptions options_;
+    static inline int test_counter_ = 0;
+};
+
+TEST_F(SharedMemoryTest, ReaderSeesPublishedValues) {
+    SharedMemoryWriter writer(options_);
+    ASSERT_TRUE(writer.Open());
+
+    EXPECT_TRUE(writer.Publish(0, "Requests", "42"));
+    EXPECT_TRUE(writer.Publish(3, "\"CPU Usage\"", "12.50%"));
+    writer.Commit();
+
+    SharedMemoryReader reader;
+    ASSERT_TRUE(reader.Open(options_.name));
+    EXPECT_EQ(reader.Generation(), 1);
+    EXPECT_GT(reader.UpdateTimeNs(), 0);
+
+    std::vector<SharedMemoryReader::Entry> entries;
+    reader.Read(entries);
+    ASSERT_EQ(entries.size(), 2);
+    EXPECT_EQ(entries[0].index, 0);
+    EXPECT_EQ(entries[0].name, "Requests");
+    EXPECT_EQ(entries[0].value, "42");
+    EXPECT_EQ(entries[1].index, 3);
+    EXPECT_EQ(entries[1].name, "\"CPU Usage\"");
+    EXPECT_EQ(entries[1].value, "12.50%");
+
+    writer.Publish(0, "Requests", "43");
+    writer.Commit();
+    reader.Read(entries);
+    EXPECT_EQ(entries[0].value, "43");
+    EXPECT_EQ(reader.Generation(), 2);
+}
+
+TEST_F(SharedMemoryTest, OutOfRangeAndTruncation) {
+    SharedMemoryWriter writer(options_);
+    ASSERT_TRUE(writer.Open());
+
+    EXPECT_FALSE(writer.Publish(options_.capacity, "Too far", "1"));
+
+    std::string long_name(SharedMemoryLayout::kNameCapacity + 10, 'n');
+    std::string long_value(SharedMemoryLayout::kValueCapacity + 10, 'v');
+    EXPECT_TRUE(writer.Publish(0, long_name, long_value));
+    EXPECT_TRUE(writer.Publish(1, "Empty", ""));
+
+    SharedMemoryReader reader;
+    ASSERT_TRUE(reader.Open(options_.name));
+    std::vector<SharedMemoryReader::Entry> entries;
+    reader.Read(entries);
+    ASSERT_EQ(entries.size(), 2);
+    EXPECT_EQ(entries[0].name, long_name.substr(0, SharedMemoryLayout::kNameCapacity));
+    EXPECT_EQ(entries[0].value, long_value.substr(0, SharedMemoryLayout::kValueCapacity));
+    EXPECT_EQ(entries[1].value, "");
+}
+
+TEST_F(SharedMemoryTest, ClearAndReuseSlot) {
+    SharedMemoryWriter writer(options_);
+    ASSERT_TRUE(writer.Open());
+    writer.Publish(0, "First", "1");
+    writer.Publish(1, "Second", "2");
+
+    SharedMemoryReader reader;
+    ASSERT_TRUE(reader.Open(options_.name));
+    std::vector<SharedMemoryReader::Entry> entries;
+
+    writer.Clear(0);
+    reader.Read(entries);
+    ASSERT_EQ(entries.size(), 1);
+    EXPECT_EQ(entries[0].name, "Second");
+
+    writer.Publish(0, "Replacement", "3");
+    reader.Read(entries);
+    ASSERT_EQ(entries.size(), 2);
+    EXPECT_EQ(entries[0].name, "Replacement");
+    EXPECT_EQ(entries[0].value, "3");
+}
+
+TEST_F(SharedMemoryTest, OpenFailures) {
+    SharedMemoryReader reader;
+    EXPECT_FALSE(reader.Open(options_.name));
+    EXPECT_FALSE(reader.IsOpen());
+
+    std::vector<SharedMemoryReader::Entry> entries(3);
+    reader.Read(entries);
+    EXPECT_TRUE(entries.empty());
+
+    {
+        SharedMemoryWriter writer(options_);
+        ASSERT_TRUE(writer.Open());
+        EXPECT_TRUE(reader.Open(options_.name));
+    }
+    // The writer unlinks on close; the mapping stays readable.
+    SharedMemoryReader late_reader;
+    EXPECT_FALSE(late_reader.Open(options_.name));
+    reader.Read(entries);
+    EXPECT_TRUE(entries.empty());
+}
+
+TEST_F(SharedMemoryTest, ExistingSegmentIsNotTakenOver) {
+    SharedMemoryWriter writer(options_);
+    ASSERT_TRUE(writer.Open());
+    writer.Publish(0, "Owner", "1");
+    writer.Commit();
+
+    SharedMemoryWriter second(options_);
+    EXPECT_FALSE(second.Open());
+
+    SharedMemoryReader reader;
+    ASSERT_TRUE(reader.Open(options_.name));
+    std::vector<SharedMemoryReader::Entry> entries;
+    reader.Read(entries);
+    ASSERT_EQ(entries.size(), 1);
+    EXPECT_EQ(entries[0].name, "Owner");
+
+    // A stale segment is replaced once it is unlinked explicitly.
+    EXPECT_TRUE(SharedMemoryWriter::Unlink(options_.name));
+    EXPECT_TRUE(second.Open());
+}
+
+TEST_F(SharedMemoryTest, SegmentIsPrivateByDefault) {
+    SharedMemoryWriter writer(options_);
+    ASSERT_TRUE(writer.Open());
+    struct stat info{};
+    ASSERT_EQ(stat(("/dev/shm" + options_.name).c_str(), &info), 0);
+    EXPECT_EQ(info.st_mode & 0777, 0600);
+}
+
+TEST_F(SharedMemoryTest, ConcurrentReadsAreConsistent) {
+    SharedMemoryWriter writer(options_);
+    ASSERT_TRUE(writer.Open());
+    writer.Publish(0, "Digit", std::string(200, '0'));
+
+    std::atomic<bool> stop{false};
+    std::thread writer_thread([&]() {
+        for (int i = 0; !stop; ++i) {
+            char digit = static_cast<char>('0' + i % 10);
+            writer.Publish(0, "Digit", std::string(100 + i % 100, digit));
+            writer.Commit();
+        }
+    });
+
+    SharedMemoryReader reader;
+    ASSERT_TRUE(reader.Open(options_.name));
+    std::vector<SharedMemoryReader::Entry> entries;
+    int torn = 0;
+    for (int i = 0; i < 20000; ++i) {
+        reader.Read(entries);
+        if (entries.size() != 1 || entries[0].value.empty()
+            || entries[0].value.find_first_not_of(entries[0].value[0]) != std::string::npos) {
+            ++torn;
+        }
+    }
+    stop = true;
+    writer_thread.join();
+
+    EXPECT_EQ(torn, 0);
+}
+
+TEST_F(SharedMemoryTest, ManagerExportsLoggedValues) {
+    std::string log_name = "test_shared_memory_manager.log";
+    {
+        MetricsManager manager(log_name);
+        auto* requests = manager.CreateMetric<Metrics::IncrementMetric>("Requests", 7);
+        auto* errors = manager.CreateMetric<Metrics::IncrementMetric>("Errors", 1);
+        ASSERT_TRUE(manager.ExportToSharedMemory(options_));
+
+        SharedMemoryReader reader;
+        ASSERT_TRUE(reader.Open(options_.name));
+        std::vector<SharedMemoryReader::Entry> entries;
+
+        // Export starts with the current values, without resetting them.
+        reader.Read(entries);
+        ASSERT_EQ(entries.size(), 2);
+        EXPECT_EQ(entries[0].value, "7");
+        EXPECT_EQ(entries[1].value, "1");
+        EXPECT_EQ(requests->GetValueAsString(), "7");
+
+        ++(*requests);
+        manager.Log();
+        reader.Read(entries);
+        EXPECT_EQ(entries[0].name, "Requests");
+        EXPECT_EQ(entries[0].value, "8");
+        EXPECT_EQ(reader.Generation(), 2);
+
+        manager.Remove(errors);
+        reader.Read(entries);
+        ASSERT_EQ(entries.size(), 1);
+        EXPECT_EQ(entries[0].name, "Requests");
+
+        ++(*requests);
+        manager.PublishToSharedMemory();
+        reader.Read(entries);
+        EXPECT_EQ(entries[0].value, "1");
+        EXPECT_EQ(requests->GetValueAsString(), "1");
+
+        manager.StopSharedMemoryExport();
+        SharedMemoryReader late_reader;
+        EXPECT_FALSE(late_reader.Open(options_.name));
+    }
+    std::filesystem::remove(log_name);
+}
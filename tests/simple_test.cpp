@@ -3,14 +3,27 @@
 #include "IMetrics/IncrementMetric.h"
 #include "IMetrics/HTTPIncomeMetric.h"
 #include "IMetrics/CPUUsageMetric.h"
+#include "TestFileName.h"
 #include <thread>
 #include <chrono>
 #include <filesystem>
 
+namespace {
+
+std::chrono::steady_clock::time_point manual_now{};
+
+struct ManualClock {
+    static std::chrono::steady_clock::time_point now() noexcept {
+        return manual_now;
+    }
+};
+
+}
+
 class SimpleMetricsTest : public ::testing::Test {
 protected:
     void SetUp() override {
-        test_file_ = "simple_test_" + std::to_string(counter_++) + ".log";
+        test_file_ = TestFileName("simple_test_", ".log");
         manager_ = std::make_unique<MetricsManager<>>(test_file_);
         std::this_thread::sleep_for(std::chrono::milliseconds(50));
     }
@@ -25,7 +38,6 @@ protected:
 
     std::unique_ptr<MetricsManager<>> manager_;
     std::string test_file_;
-    static inline std::atomic<int> counter_{0};
 };
 
 TEST_F(SimpleMetricsTest, CreateIncrementMetric) {
@@ -46,18 +58,19 @@ TEST_F(SimpleMetricsTest, IncrementAndReset) {
 }
 
 TEST_F(SimpleMetricsTest, HTTPMetricBasics) {
-    auto* metric = manager_->CreateMetric<Metrics::HTTPIncomeMetric>(0);
+    auto* metric = manager_->CreateMetric<Metrics::BasicHTTPIncomeMetric<ManualClock>>();
     ASSERT_NE(metric, nullptr);
     
     ++(*metric);
     ++(*metric);
     ++(*metric);
     
+    manual_now += std::chrono::seconds(1);
     metric->Evaluate();
     EXPECT_EQ(metric->GetValueAsString(), "3.00");
     
     manager_->Log(0);
-    EXPECT_EQ(metric->GetValueAsString(), "0.00");
+    EXPECT_EQ(metric->GetValueAsString(), "3.00");
 }
 
 TEST_F(SimpleMetricsTest, CPUMetricCreation) {
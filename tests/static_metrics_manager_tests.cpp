@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include "MetricsManager/StaticMetricsManager.h"
+#include "IMetrics/CodeTimeMetric.h"
+#include "IMetrics/CPUUsageMetric.h"
+#include "IMetrics/HTTPIncomeMetric.h"
+#include "IMetrics/IncrementMetric.h"
+#include "IMetrics/LatencyMetric.h"
+#include "TestFileName.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <regex>
+#include <thread>
+
+using CoreMetrics = StaticMetricsManager<
+    Metrics::IncrementMetric,
+    Metrics::HTTPIncomeMetric,
+    Metrics::LatencyMetric,
+    Metrics::CodeTimeMetric,
+    Metrics::CPUUsageMetric
+>;
+
+class StaticMetricsManagerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_file_name_ = TestFileName("test_static_metrics_", ".log");
+        manager_ = std::make_unique<CoreMetrics>(
+            test_file_name_,
+            std::tuple("StaticCounter", 5ull),
+            std::tuple(),
+            std::tuple(),
+            std::tuple("StaticTimer"),
+            std::tuple());
+    }
+
+    void TearDown() override {
+        manager_.reset();
+        if (std::filesystem::exists(test_file_name_)) {
+            std::filesystem::remove(test_file_name_);
+        }
+    }
+
+    std::string ReadLogFile() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        std::ifstream file(test_file_name_);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    int CountLinesInLog() {
+        std::string content = ReadLogFile();
+        return std::count(content.begin(), content.end(), '\n');
+    }
+
+    std::unique_ptr<CoreMetrics> manager_;
+    std::string test_file_name_;
+};
+
+TEST_F(StaticMetricsManagerTest, ConstructorArgumentsAreForwarded) {
+    EXPECT_EQ(manager_->Get<0>().GetName(), "StaticCounter");
+    EXPECT_EQ(manager_->Get<0>().GetValueAsString(), "5");
+    EXPECT_EQ(manager_->Get<Metrics::CodeTimeMetric>().GetName(), "StaticTimer");
+}
+
+TEST_F(StaticMetricsManagerTest, GetByTypeAndIndexAgree) {
+    EXPECT_EQ(&manager_->Get<1>(), &manager_->Get<Metrics::HTTPIncomeMetric>());
+    EXPECT_EQ(&manager_->Get<2>(), &manager_->Get<Metrics::LatencyMetric>());
+}
+
+TEST_F(StaticMetricsManagerTest, DefaultConstructedManager) {
+    const std::string file_name = "test_static_metrics_default.log";
+    {
+        StaticMetricsManager<Metrics::IncrementMetric, Metrics::HTTPIncomeMetric> manager(file_name);
+        ++manager.Get<Metrics::IncrementMetric>();
+        EXPECT_EQ(manager.Get<0>().GetValueAsString(), "1");
+        manager.Log();
+        EXPECT_EQ(manager.Get<0>().GetValueAsString(), "0");
+    }
+    std::filesystem::remove(file_name);
+}
+
+TEST_F(StaticMetricsManagerTest, LogAllMetrics) {
+    ++manager_->Get<Metrics::IncrementMetric>();
+    manager_->Get<Metrics::LatencyMetric>().Observe(std::chrono::milliseconds(5));
+
+    manager_->Log();
+
+    std::string content = ReadLogFile();
+    EXPECT_EQ(std::count(content.begin(), content.end(), '\n'), 5);
+    EXPECT_NE(content.find("StaticCounter: 6"), std::string::npos);
+    EXPECT_NE(content.find("\"Percentile Latency\""), std::string::npos);
+    EXPECT_NE(content.find("StaticTimer"), std::string::npos);
+    EXPECT_EQ(manager_->Get<Metrics::IncrementMetric>().GetValueAsString(), "0");
+}
+
+TEST_F(StaticMetricsManagerTest, LogByTagIsFiltered) {
+    manager_->Log<MetricTags::ComputerMetricTag>();
+
+    std::string content = ReadLogFile();
+    EXPECT_EQ(std::count(content.begin(), content.end(), '\n'), 2);
+    EXPECT_NE(content.find("\"Percentile Latency\""), std::string::npos);
+    EXPECT_NE(content.find("\"CPU Usage\""), std::string::npos);
+    EXPECT_EQ(content.find("StaticCounter"), std::string::npos);
+}
+
+TEST_F(StaticMetricsManagerTest, LogByTagFilter) {
+    constexpr auto filter = MetricTags::AnyOf<MetricTags::ServerMetricTag, MetricTags::AlgoMetricTag>();
+    manager_->Log<filter>();
+    manager_->Log<MetricTags::NoneOf<MetricTags::ComputerMetricTag, MetricTags::ServerMetricTag>()>();
+
+    std::string content = ReadLogFile();
+    EXPECT_EQ(std::count(content.begin(), content.end(), '\n'), 4);
+    EXPECT_NE(content.find("\"HTTPS requests RPS\""), std::string::npos);
+    EXPECT_NE(content.find("StaticTimer"), content.rfind("StaticTimer"));
+    EXPECT_NE(content.find("StaticCounter"), std::string::npos);
+    EXPECT_EQ(content.find("\"CPU Usage\""), std::string::npos);
+}
+
+TEST_F(StaticMetricsManagerTest, LogByMetricType) {
+    manager_->Log<Metrics::HTTPIncomeMetric>();
+
+    std::string content = ReadLogFile();
+    EXPECT_EQ(std::count(content.begin(), content.end(), '\n'), 1);
+    EXPECT_NE(content.find("\"HTTPS requests RPS\""), std::string::npos);
+}
+
+TEST_F(StaticMetricsManagerTest, LogByIndex) {
+    manager_->Log<0>();
+
+    std::string content = ReadLogFile();
+    std::regex line_regex(R"(\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2}\.\d{3} StaticCounter: 5)");
+    EXPECT_TRUE(std::regex_search(content, line_regex));
+}
+
+TEST_F(StaticMetricsManagerTest, ConcurrentUpdatesAndLogs) {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([this]() {
+            for (int j = 0; j < 1000; ++j) {
+                ++manager_->Get<Metrics::HTTPIncomeMetric>();
+                manager_->Get<Metrics::LatencyMetric>().Observe(std::chrono::microseconds(j));
+            }
+        });
+    }
+    threads.emplace_back([this]() {
+        for (int j = 0; j < 20; ++j) {
+            manager_->Log<MetricTags::ServerMetricTag>();
+        }
+    });
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(CountLinesInLog(), 20);
+}
@@ -0,0 +1,168 @@
+#include "IMetrics/CodeTimeMetric.h"
+#include "IMetrics/LatencyMetric.h"
+#include "IMetrics/CPUUsageMetric.h"
+#include "IMetrics/CardinalityMetricValue.h"
+#include "MetricsManager/MetricsManager.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+using namespace Metrics;
+using namespace std::chrono_literals;
+
+template <typename Policy>
+class ThreadingPolicyTest : public ::testing::Test {};
+
+using Policies = ::testing::Types<SingleThreadPolicy, MutexPolicy, SpinLockPolicy>;
+TYPED_TEST_SUITE(ThreadingPolicyTest, Policies);
+
+TYPED_TEST(ThreadingPolicyTest, LatencyObserve) {
+    BasicLatencyMetric<TypeParam> metric;
+    for (int i = 1; i <= 100; ++i) {
+        metric.Observe(std::chrono::nanoseconds(i * 1000));
+    }
+    auto percentiles = std::get<Snapshot::Percentiles>(metric.GetSnapshot());
+    EXPECT_EQ(percentiles.count, 100);
+    EXPECT_NE(metric.GetValueAsString().find("P90:"), std::string::npos);
+    metric.Reset();
+    EXPECT_EQ(std::get<Snapshot::Percentiles>(metric.GetSnapshot()).count, 0);
+}
+
+TYPED_TEST(ThreadingPolicyTest, CodeTimeStartStop) {
+    BasicCodeTimeMetric<TypeParam> metric("\"Task\"");
+    metric.Start();
+    std::this_thread::sleep_for(1ms);
+    metric.Stop();
+    EXPECT_EQ(metric.GetName(), "\"Task\"");
+    EXPECT_GE(std::get<Snapshot::Duration>(metric.GetSnapshot()).value, 1ms);
+}
+
+TYPED_TEST(ThreadingPolicyTest, CPUUsageEvaluate) {
+    BasicCPUUsageMetric<TypeParam> metric;
+    metric.Evaluate();
+    double usage = std::get<Snapshot::Gauge>(metric.GetSnapshot()).value;
+    EXPECT_GE(usage, 0.0);
+    EXPECT_LE(usage, 100.0);
+}
+
+TYPED_TEST(ThreadingPolicyTest, CardinalityValueObserve) {
+    BasicCardinalityMetricValue<TypeParam, int, std::string> metric(2);
+    metric.Observe(1, 3);
+    metric.Observe(std::string("a"));
+    auto top = std::get<Snapshot::TopN>(metric.GetSnapshot());
+    EXPECT_EQ(top.unique, 2);
+    ASSERT_EQ(top.items.size(), 2);
+    EXPECT_EQ(top.items[0].count, 3);
+}
+
+TEST(ThreadingPolicyTest, OldNamesAreMutexPolicy) {
+    static_assert(std::is_same_v<LatencyMetric, BasicLatencyMetric<MutexPolicy>>);
+    static_assert(std::is_same_v<CodeTimeMetric, BasicCodeTimeMetric<MutexPolicy>>);
+    static_assert(std::is_same_v<CPUUsageMetric, BasicCPUUsageMetric<MutexPolicy>>);
+    static_assert(std::is_same_v<CardinalityMetricValue<int>, BasicCardinalityMetricValue<MutexPolicy, int>>);
+    EXPECT_EQ(kTypeName<LatencyMetric>, "Metrics::LatencyMetric");
+    EXPECT_EQ(kTypeName<CodeTimeMetric>, "Metrics::CodeTimeMetric");
+    EXPECT_EQ(kTypeName<CPUUsageMetric>, "Metrics::CPUUsageMetric");
+}
+
+TEST(ThreadingPolicyTest, DefaultNamesUniqueAcrossPolicies) {
+    BasicCodeTimeMetric<SingleThreadPolicy> single;
+    CodeTimeMetric shared;
+    EXPECT_NE(single.GetName(), shared.GetName());
+}
+
+TEST(ThreadingPolicyTest, SpinLockConcurrentObserve) {
+    BasicLatencyMetric<SpinLockPolicy> metric;
+    const int kThreads = 4;
+    const int kObservations = 10'000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&metric, t] {
+            for (int i = 0; i < kObservations; ++i) {
+                metric.Observe(std::chrono::nanoseconds(1000 + t * 100 + i % 100));
+            }
+        });
+    }
+    for (int i = 0; i < 100; ++i) {
+        metric.GetValueAsString();
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(std::get<Snapshot::Percentiles>(metric.GetSnapshot()).count, kThreads * kObservations);
+}
+
+TEST(ThreadingPolicyTest, SpinLockConcurrentCardinality) {
+    BasicCardinalityMetricValue<SpinLockPolicy, int> metric(1);
+    const int kThreads = 4;
+    const int kObservations = 10'000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&metric] {
+            for (int i = 0; i < kObservations; ++i) {
+                metric.Observe(i % 10);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto top = std::get<Snapshot::TopN>(metric.GetSnapshot());
+    EXPECT_EQ(top.unique, 10);
+    ASSERT_EQ(top.items.size(), 1);
+    EXPECT_EQ(top.items[0].count, kThreads * kObservations / 10);
+}
+
+TEST(ThreadingPolicyTest, ManagerLogsPolicyVariants) {
+    std::string log_name = "test_threading_policy.log";
+    {
+        MetricsManager manager(log_name);
+        manager.CreateMetric<BasicLatencyMetric<SingleThreadPolicy>>()->Observe(100ns);
+        manager.CreateMetric<BasicCodeTimeMetric<SpinLockPolicy>>("\"Spin\"");
+        manager.Log();
+    }
+    std::ifstream log(log_name);
+    std::string content((std::istreambuf_iterator<char>(log)), std::istreambuf_iterator<char>());
+    EXPECT_NE(content.find("\"Percentile Latency\""), std::string::npos);
+    EXPECT_NE(content.find("\"Spin\""), std::string::npos);
+    log.close();
+    std::filesystem::remove(log_name);
+}
+
+static_assert(ThreadConfinedMetric<BasicLatencyMetric<SingleThreadPolicy>>);
+static_assert(ThreadConfinedMetric<BasicCardinalityMetricValue<SingleThreadPolicy, int>>);
+static_assert(!ThreadConfinedMetric<BasicCodeTimeMetric<SpinLockPolicy>>);
+static_assert(!ThreadConfinedMetric<LatencyMetric>);
+
+TEST(ThreadingPolicyTest, SingleThreadMetricsExcludeManagerThreads) {
+    std::string log_name = "test_threading_policy_confined.log";
+    {
+        MetricsManager manager(log_name);
+        auto* local = manager.CreateMetric<BasicLatencyMetric<SingleThreadPolicy>>();
+        EXPECT_THROW(manager.Serve(), std::runtime_error);
+        MetricsExecution::WorkStealingPool pool(1);
+        EXPECT_THROW(manager.SetExecutor(&pool), std::runtime_error);
+        EXPECT_NO_THROW(manager.SetExecutor(nullptr));
+
+        EXPECT_TRUE(manager.Remove(local));
+        ASSERT_TRUE(manager.Serve());
+        EXPECT_THROW(manager.CreateMetric<BasicCPUUsageMetric<SingleThreadPolicy>>(), std::runtime_error);
+        EXPECT_NO_THROW(manager.CreateMetric<BasicCPUUsageMetric<SpinLockPolicy>>());
+        manager.StopServing();
+
+        manager.SetExecutor(&pool);
+        EXPECT_THROW(manager.CreateMetric<BasicCodeTimeMetric<SingleThreadPolicy>>(), std::runtime_error);
+        manager.SetExecutor(nullptr);
+        EXPECT_NO_THROW(manager.CreateMetric<BasicCodeTimeMetric<SingleThreadPolicy>>());
+    }
+    std::filesystem::remove(log_name);
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "MetricsManager/WorkStealingPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace MetricsExecution;
+
+TEST(WorkStealingPoolTest, RunsEveryIndexOnce) {
+    WorkStealingPool pool(4);
+    EXPECT_EQ(pool.Size(), 4);
+
+    for (size_t count : {0, 1, 3, 1000}) {
+        std::vector<std::atomic<int>> calls(count);
+        pool.ParallelFor(count, [&](size_t i) {
+            calls[i].fetch_add(1);
+        });
+        for (size_t i = 0; i < count; ++i) {
+            EXPECT_EQ(calls[i].load(), 1) << "count " << count << ", index " << i;
+        }
+    }
+}
+
+TEST(WorkStealingPoolTest, WithoutWorkersRunsOnCaller) {
+    WorkStealingPool pool(0);
+    EXPECT_EQ(pool.Size(), 0);
+
+    auto caller = std::this_thread::get_id();
+    int calls = 0;
+    pool.ParallelFor(10, [&](size_t) {
+        EXPECT_EQ(std::this_thread::get_id(), caller);
+        ++calls;
+    });
+    EXPECT_EQ(calls, 10);
+}
+
+TEST(WorkStealingPoolTest, SlowTaskDoesNotSerializeTheRest) {
+    WorkStealingPool pool(2);
+    std::atomic<int> done{0};
+
+    // The first queue starts with the slow task; its other tasks get stolen meanwhile.
+    auto start = std::chrono::steady_clock::now();
+    pool.ParallelFor(64, [&](size_t i) {
+        if (i == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        done.fetch_add(1);
+    });
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(done.load(), 64);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(200 + 63 * 2));
+}
+
+TEST(WorkStealingPoolTest, RethrowsFirstException) {
+    WorkStealingPool pool(3);
+    std::atomic<int> calls{0};
+
+    EXPECT_THROW(pool.ParallelFor(100, [&](size_t i) {
+        calls.fetch_add(1);
+        if (i % 10 == 0) {
+            throw std::runtime_error("failed");
+        }
+    }), std::runtime_error);
+    EXPECT_EQ(calls.load(), 100);
+
+    // The pool stays usable.
+    calls = 0;
+    pool.ParallelFor(10, [&](size_t) { calls.fetch_add(1); });
+    EXPECT_EQ(calls.load(), 10);
+}
+
+TEST(WorkStealingPoolTest, NestedAndConcurrentJobs) {
+    WorkStealingPool pool(2);
+    std::atomic<int> total{0};
+
+    std::vector<std::thread> callers;
+    for (int t = 0; t < 4; ++t) {
+        callers.emplace_back([&]() {
+            for (int round = 0; round < 20; ++round) {
+                pool.ParallelFor(8, [&](size_t) {
+                    pool.ParallelFor(8, [&](size_t) {
+                        total.fetch_add(1);
+                    });
+                });
+            }
+        });
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+
+    EXPECT_EQ(total.load(), 4 * 20 * 8 * 8);
+}
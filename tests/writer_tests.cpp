@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include "../src/MultiThreadWriter/Writer.h"
 #include "../src/MultiThreadWriter/WriterUtils.h"
+#include "TestFileName.h"
+#include <atomic>
 #include <fstream>
 #include <thread>
 #include <chrono>
@@ -13,7 +15,7 @@ using namespace std::chrono_literals;
 class AsyncWriterTest : public ::testing::Test {
 protected:
     void SetUp() override {
-        test_filename_ = "test_output_" + std::to_string(test_counter_++) + ".txt";
+        test_filename_ = TestFileName("test_output_", ".txt");
         std::filesystem::remove(test_filename_);
     }
 
@@ -45,11 +47,8 @@ protected:
     }
 
     std::string test_filename_;
-    static int test_counter_;
 };
 
-int AsyncWriterTest::test_counter_ = 0;
-
 TEST_F(AsyncWriterTest, BasicConstruction) {
     AsyncWriter writer(test_filename_);
     EXPECT_FALSE(writer.IsRunning());
@@ -335,7 +334,7 @@ TEST_F(AsyncWriterTest, PerformanceTest) {
 
 TEST_F(AsyncWriterTest, ResourceCleanup) {
     for (int i = 0; i < 100; ++i) {
-        std::string filename = "cleanup_test_" + std::to_string(i) + ".txt";
+        std::string filename = TestFileName("cleanup_test_", ".txt", i);
         
         {
             AsyncWriter writer(filename);
@@ -408,7 +407,7 @@ TEST_F(AsyncWriterTest, StressTestConcurrentStartStop) {
 class WriterUtilsTest : public ::testing::Test {
 protected:
     void SetUp() override {
-        test_filename_ = "utils_test_" + std::to_string(test_counter_++) + ".txt";
+        test_filename_ = TestFileName("utils_test_", ".txt");
         std::filesystem::remove(test_filename_);
     }
 
@@ -435,11 +434,8 @@ protected:
     }
 
     std::string test_filename_;
-    static int test_counter_;
 };
 
-int WriterUtilsTest::test_counter_ = 0;
-
 TEST_F(WriterUtilsTest, WriteMetricDifferentTypes) {
     AsyncWriter writer(test_filename_);
     writer.Start();
@@ -707,4 +703,282 @@ TEST_F(WriterUtilsTest, PerformanceUtilsTest) {
     
     EXPECT_LT(duration.count(), 3000);
     std::cout << "WriterUtils Performance: " << operations_count << " operations in " << duration.count() << "ms" << std::endl;
-}
\ No newline at end of file
+}
+TEST_F(AsyncWriterTest, MoveWrite) {
+    AsyncWriter writer(test_filename_);
+    writer.Start();
+    
+    std::string text = "Moved line";
+    EXPECT_TRUE(writer.Write(std::move(text)));
+    writer.Stop();
+    
+    auto lines = ReadFileLines();
+    ASSERT_EQ(lines.size(), 1);
+    EXPECT_EQ(lines[0], "Moved line");
+}
+
+TEST_F(AsyncWriterTest, AcquireBufferReusesWrittenStorage) {
+    AsyncWriter writer(test_filename_);
+    writer.Start();
+    
+    std::string buffer = writer.AcquireBuffer();
+    EXPECT_TRUE(buffer.empty());
+    buffer.assign(1024, 'x');
+    size_t capacity = buffer.capacity();
+    writer.Write(std::move(buffer));
+    
+    std::string recycled;
+    for (int i = 0; i < 100 && recycled.capacity() < capacity; ++i) {
+        std::this_thread::sleep_for(10ms);
+        recycled = writer.AcquireBuffer();
+    }
+    EXPECT_TRUE(recycled.empty());
+    EXPECT_GE(recycled.capacity(), capacity);
+    writer.Stop();
+}
+
+TEST_F(WriterUtilsTest, ScrapeBatchWritesOneEntryWithSharedTimestamp) {
+    AsyncWriter writer(test_filename_);
+    writer.Start();
+    
+    {
+        ScrapeBatch batch(writer);
+        EXPECT_TRUE(batch.Empty());
+        batch.Add("First", "1");
+        batch.Add("Second", "2.50");
+        batch.Add("Third", "P90: 10ns");
+        EXPECT_FALSE(batch.Empty());
+        EXPECT_TRUE(batch.Commit());
+    }
+    writer.Stop();
+    
+    auto lines = ReadFileLines();
+    ASSERT_EQ(lines.size(), 3);
+    std::string timestamp = lines[0].substr(0, 23);
+    EXPECT_TRUE(ContainsTimestamp(timestamp));
+    EXPECT_EQ(lines[0], timestamp + " First: 1");
+    EXPECT_EQ(lines[1], timestamp + " Second: 2.50");
+    EXPECT_EQ(lines[2], timestamp + " Third: P90: 10ns");
+}
+
+TEST_F(WriterUtilsTest, EmptyScrapeBatchWritesNothing) {
+    AsyncWriter writer(test_filename_);
+    writer.Start();
+    
+    ScrapeBatch batch(writer);
+    EXPECT_TRUE(batch.Commit());
+    writer.Stop();
+    
+    EXPECT_TRUE(ReadFileLines().empty());
+}
+
+TEST_F(WriterUtilsTest, DictionaryScrapeBatchLayout) {
+    AsyncWriter writer(test_filename_);
+    writer.Start();
+    
+    auto now = std::chrono::system_clock::now();
+    {
+        ScrapeBatch batch(writer, now, LogEncoding::Dictionary);
+        ScrapeBatch part(writer, now, LogEncoding::Dictionary);
+        ScrapeBatch empty_part(writer, now, LogEncoding::Dictionary);
+        EXPECT_EQ(batch.Encoding(), LogEncoding::Dictionary);
+        
+        batch.AddMetadata(0, "Metrics::IncrementMetric", "", "", "\"Requests\"");
+        batch.AddSample(0, "42");
+        part.AddMetadata(17, "Metrics::LatencyMetric", "ns", "computer", "\"Percentile Latency\"");
+        part.AddSample(17, "P90: 10ns");
+        batch.Merge(empty_part);
+        batch.Merge(part);
+        EXPECT_TRUE(part.Empty());
+        EXPECT_TRUE(batch.Commit());
+    }
+    writer.Stop();
+    
+    char timestamp[WriterUtils::kTimestampBufferSize];
+    size_t length = WriterUtils::FormatTimestamp(now, timestamp);
+    std::vector<std::string> expected = {
+        "T\t" + std::string(timestamp, length),
+        "M\t0\tMetrics::IncrementMetric\t\t\t\"Requests\"",
+        "0\t42",
+        "M\t17\tMetrics::LatencyMetric\tns\tcomputer\t\"Percentile Latency\"",
+        "17\tP90: 10ns",
+    };
+    EXPECT_EQ(ReadFileLines(), expected);
+}
+
+class WriterServiceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        for (int i = 0; i < 3; ++i) {
+            filenames_.push_back(TestFileName("service_test_", ".txt", i));
+            std::filesystem::remove(filenames_.back());
+        }
+    }
+
+    void TearDown() override {
+        for (const auto& filename : filenames_) {
+            std::filesystem::remove(filename);
+        }
+    }
+
+    std::vector<std::string> ReadFileLines(const std::string& filename) {
+        std::ifstream file(filename);
+        std::vector<std::string> lines;
+        std::string line;
+        
+        while (std::getline(file, line)) {
+            lines.push_back(line);
+        }
+        
+        return lines;
+    }
+
+    std::vector<std::string> filenames_;
+};
+
+TEST_F(WriterServiceTest, WritersRouteToTheirOwnFiles) {
+    WriterService service;
+    AsyncWriter first(service, filenames_[0]);
+    AsyncWriter second(service, filenames_[1]);
+    
+    EXPECT_TRUE(first.Start());
+    EXPECT_TRUE(second.Start());
+    EXPECT_TRUE(first.IsRunning());
+    
+    EXPECT_TRUE(first.Write("first 1"));
+    EXPECT_TRUE(second.Write("second 1"));
+    EXPECT_TRUE(first.Write(std::string("first 2")));
+    
+    first.Stop();
+    second.Stop();
+    EXPECT_FALSE(first.IsRunning());
+    
+    EXPECT_EQ(ReadFileLines(filenames_[0]), (std::vector<std::string>{"first 1", "first 2"}));
+    EXPECT_EQ(ReadFileLines(filenames_[1]), (std::vector<std::string>{"second 1"}));
+}
+
+TEST_F(WriterServiceTest, StopFlushesPendingEntriesOfThatWriterOnly) {
+    WriterService service;
+    AsyncWriter first(service, filenames_[0]);
+    AsyncWriter second(service, filenames_[1]);
+    first.Start();
+    second.Start();
+    
+    for (int i = 0; i < 1000; ++i) {
+        first.Write("entry " + std::to_string(i));
+    }
+    first.Stop();
+    EXPECT_EQ(ReadFileLines(filenames_[0]).size(), 1000);
+    
+    EXPECT_FALSE(first.Write("after stop"));
+    EXPECT_TRUE(second.Write("still running"));
+    second.Stop();
+    EXPECT_EQ(ReadFileLines(filenames_[1]).size(), 1);
+}
+
+TEST_F(WriterServiceTest, ConcurrentWritersShareOneService) {
+    WriterService service;
+    std::vector<std::unique_ptr<AsyncWriter>> writers;
+    for (const auto& filename : filenames_) {
+        writers.push_back(std::make_unique<AsyncWriter>(service, filename));
+        writers.back()->Start();
+    }
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 6; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < 200; ++i) {
+                writers[t % writers.size()]->Write("thread " + std::to_string(t) + " entry " + std::to_string(i));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    for (auto& writer : writers) {
+        writer->Stop();
+    }
+    for (const auto& filename : filenames_) {
+        EXPECT_EQ(ReadFileLines(filename).size(), 400);
+    }
+}
+
+TEST_F(WriterServiceTest, ServiceStopClosesAttachedWriters) {
+    auto service = std::make_unique<WriterService>();
+    AsyncWriter writer(*service, filenames_[0]);
+    writer.Start();
+    writer.Write("before service stop");
+    
+    service->Stop();
+    EXPECT_FALSE(writer.Write("after service stop"));
+    writer.Stop();
+    
+    EXPECT_EQ(ReadFileLines(filenames_[0]), (std::vector<std::string>{"before service stop"}));
+}
+
+TEST_F(WriterServiceTest, ServiceRestartReopensAttachedWriters) {
+    WriterService service;
+    AsyncWriter writer(service, filenames_[0]);
+    writer.Start();
+    writer.Write("before restart");
+    
+    service.Stop();
+    EXPECT_FALSE(writer.Write("while stopped"));
+    ASSERT_TRUE(service.Start());
+    EXPECT_TRUE(writer.Write("after restart"));
+    writer.Stop();
+    
+    EXPECT_EQ(ReadFileLines(filenames_[0]), (std::vector<std::string>{"before restart", "after restart"}));
+}
+
+TEST_F(WriterServiceTest, WritesRacingStopAreWrittenOrRefused) {
+    for (int round = 0; round < 20; ++round) {
+        std::filesystem::remove(filenames_[0]);
+        WriterService service;
+        AsyncWriter writer(service, filenames_[0]);
+        writer.Start();
+        
+        std::atomic<int> accepted{0};
+        std::thread producer([&]() {
+            for (int i = 0; i < 500; ++i) {
+                if (writer.Write("entry " + std::to_string(i))) {
+                    ++accepted;
+                }
+            }
+        });
+        service.Stop();
+        producer.join();
+        writer.Stop();
+        
+        EXPECT_EQ(ReadFileLines(filenames_[0]).size(), static_cast<std::size_t>(accepted.load()));
+    }
+}
+
+TEST_F(WriterServiceTest, InvalidFileFailsToStart) {
+    WriterService service;
+    AsyncWriter writer(service, "/invalid/path/that/does/not/exist/test.txt");
+    EXPECT_FALSE(writer.Start());
+    EXPECT_FALSE(writer.Write("nothing"));
+}
+
+TEST_F(WriterServiceTest, WriterUtilsWorkThroughService) {
+    WriterService service;
+    AsyncWriter writer(service, filenames_[0]);
+    writer.Start();
+    
+    {
+        ScrapeBatch batch(writer);
+        batch.Add("ServiceMetric", "1");
+        batch.Add("OtherMetric", "2");
+        batch.Commit();
+    }
+    WriterUtils::WriteMetric(writer, "Plain", 3);
+    writer.Stop();
+    
+    auto lines = ReadFileLines(filenames_[0]);
+    ASSERT_EQ(lines.size(), 3);
+    EXPECT_NE(lines[0].find("ServiceMetric: 1"), std::string::npos);
+    EXPECT_NE(lines[1].find("OtherMetric: 2"), std::string::npos);
+    EXPECT_EQ(lines[2], "Plain: 3");
+}